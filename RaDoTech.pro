@@ -1,7 +1,7 @@
 TEMPLATE = app
 TARGET = RaDoTech
 
-QT += core gui widgets sql
+QT += core gui widgets sql concurrent
 
 CONFIG += c++17
 CONFIG -= app_bundle
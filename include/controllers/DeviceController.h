@@ -7,13 +7,67 @@
 #define DEVICECONTROLLER_H
 
 #include <QObject>
-#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "ConductanceWaveform.h"
+#include "DeviceTrace.h"
+#include "SampleRing.h"
+#include "SimulationClock.h"
+
+/**
+ * @brief One streamed sample: the conductance read at a point, stamped with
+ * the device's time since the stream started.
+ */
+struct DeviceSample {
+    qint64 timestamp;  // nanoseconds since the stream started
+    float value;
+    int point;
+};
+
+/**
+ * @brief How a sample stream is produced.
+ */
+struct StreamConfig {
+    int sampleRate = 1000;     // samples per second, 1 to 10 kHz
+    int ringCapacity = 65536;  // samples buffered for the consumer
+    quint32 seed = 0;          // 0 picks a random seed
+    WaveformShape shape;       // a plateau of 0 picks a random reading
+};
+
+/**
+ * @brief Counters of the current or last stream. The consumer keeps up as
+ * long as nothing is dropped and the high water mark stays well below the
+ * capacity.
+ */
+struct StreamStats {
+    qint64 produced = 0;  // samples generated
+    qint64 dropped = 0;   // samples lost because the ring was full
+    qint64 consumed = 0;  // samples read by the consumer
+    int highWater = 0;    // most samples waiting in the ring at once
+    int capacity = 0;
+};
+
+/**
+ * @brief How fast a recorded trace is fed back: at the pace it was
+ * recorded, or as fast as the consumer reads it.
+ */
+enum class ReplaySpeed { RealTime, Maximum };
 
 class DeviceController : public QObject {
     Q_OBJECT
 
    public:
-    explicit DeviceController(QObject *parent = nullptr);
+    /**
+     * @brief Creates the simulated device.
+     * @param parent The parent object.
+     * @param clock The clock the battery, connection and streams run on;
+     * null for a real-time clock of the controller's own.
+     */
+    explicit DeviceController(QObject *parent = nullptr,
+                              SimulationClock *clock = nullptr);
+    ~DeviceController();
 
     /**
      * @brief Checks if the device is currently on.
@@ -39,6 +93,12 @@ class DeviceController : public QObject {
      */
     bool isConnected() const { return connected; }
 
+    /**
+     * @brief Gets the clock the device runs on.
+     * @return The injected clock, or the controller's own.
+     */
+    SimulationClock *getClock() const { return clock; }
+
     /**
      * @brief Starts connecting the device (simulated connection time).
      *
@@ -59,6 +119,84 @@ class DeviceController : public QObject {
      */
     void setPowerConsumptionRate(int rate) { powerConsumptionRate = rate; }
 
+    /**
+     * @brief Starts streaming a point's waveform from a producer thread into
+     * a ring buffer. A running stream is stopped first.
+     * @param point The page/point index the samples belong to.
+     * @param config The sample rate, buffer size and waveform.
+     * @return False if the device is off.
+     */
+    bool startStream(int point, const StreamConfig &config = StreamConfig());
+
+    /**
+     * @brief Stops the stream and joins the producer thread. Samples still
+     * in the ring can be read until the next stream starts.
+     */
+    void stopStream();
+
+    /**
+     * @brief Checks if a stream is running.
+     * @return True if the producer thread is running.
+     */
+    bool isStreaming() const { return streaming.load(); }
+
+    /**
+     * @brief Takes the oldest streamed samples out of the ring. Call it from
+     * one thread only, the one that starts and stops streams.
+     * @param samples Where to copy the samples.
+     * @param max Room in samples.
+     * @return The number of samples copied.
+     */
+    int readSamples(DeviceSample *samples, int max);
+
+    /**
+     * @brief Gets the current or last stream's counters.
+     * @return The counters.
+     */
+    StreamStats getStreamStats() const;
+
+    /**
+     * @brief Starts recording device events and streamed samples to a trace
+     * file, replacing any trace already there.
+     * @param path The trace file.
+     * @return False if the file could not be created.
+     */
+    bool startRecording(const QString &path) { return recorder.open(path); }
+
+    /**
+     * @brief Stops recording and writes out the rest of the trace.
+     */
+    void stopRecording() { recorder.close(); }
+
+    /**
+     * @brief Checks if events are being recorded.
+     * @return True if a trace is open.
+     */
+    bool isRecording() const { return recorder.isOpen(); }
+
+    /**
+     * @brief Feeds a recorded trace back in place of the simulation: samples
+     * go through the ring as if streamed, and power, connection, charging,
+     * battery and data events update the state and emit the usual signals.
+     * The battery and connection timers are ignored until it ends. At
+     * maximum speed nothing is dropped; the replay waits for the consumer.
+     * @param path The trace file.
+     * @param speed Real time or maximum speed.
+     * @return False if the trace cannot be read.
+     */
+    bool startReplay(const QString &path,
+                     ReplaySpeed speed = ReplaySpeed::RealTime);
+
+    /**
+     * @brief Checks if a trace is being replayed.
+     * @return True until the replay reaches the end or is stopped.
+     */
+    bool isReplaying() const { return replaying.load(); }
+
+    // Sample rates a stream accepts, in samples per second
+    static const int MIN_SAMPLE_RATE = 1000;
+    static const int MAX_SAMPLE_RATE = 10000;
+
    public slots:
     /**
      * @brief Sets the device's on/off state.
@@ -105,6 +243,19 @@ class DeviceController : public QObject {
 
     void dataReceived(int data);
 
+    /**
+     * @brief Signal emitted from the producer thread when samples arrive in
+     * an empty ring. It is not emitted again until readSamples() is called,
+     * so a consumer gets one queued signal per read, not one per sample.
+     */
+    void samplesAvailable();
+
+    /**
+     * @brief Signal emitted from the replay thread when a replay reaches
+     * the end of its trace.
+     */
+    void replayFinished();
+
    private slots:
     void updateBatteryLevel();
     void onConnectionTimerTimeout();
@@ -115,11 +266,32 @@ class DeviceController : public QObject {
     bool charging;
     bool connected;
 
-    QTimer *batteryTimer;
-    QTimer *connectionTimer;
+    SimulationClock *clock;
+    ClockTimer *batteryTimer;
+    ClockTimer *connectionTimer;
 
     int powerChargeRate;
     int powerConsumptionRate;
+
+    std::unique_ptr<SampleRing<DeviceSample>> ring;
+    std::thread producer;
+    std::atomic<bool> streaming;
+    std::atomic<bool> notifyPending;
+    std::atomic<qint64> produced;
+    std::atomic<qint64> dropped;
+    std::atomic<qint64> consumed;
+    std::atomic<int> highWater;
+
+    TraceWriter recorder;
+    std::unique_ptr<TraceReader> replayReader;
+    std::atomic<bool> replaying;
+
+    void resetRing(int capacity);
+    void pushSamples(const DeviceSample *samples, int count, bool wait);
+    void produce(int point, StreamConfig config,
+                 std::shared_ptr<const VirtualTime> time);
+    void replay(ReplaySpeed speed);
+    void applyEvent(const TraceEvent &event);
 };
 
 #endif  // DEVICECONTROLLER_H
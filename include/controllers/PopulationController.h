@@ -0,0 +1,77 @@
+/**
+ * @file PopulationController.h
+ * @brief Declaration of the PopulationController class.
+ */
+
+#ifndef POPULATION_CONTROLLER_H
+#define POPULATION_CONTROLLER_H
+
+#include <QMutex>
+#include <QVector>
+
+#include "DatabaseManager.h"
+#include "HealthMetricCalculator.h"
+#include "QuantileSketch.h"
+#include "ScanBatch.h"
+#include "ScanModel.h"
+
+/**
+ * @brief Sketch ids: one per meridian point in MeridianPoint order, then one
+ * per indicator in IndicatorColumn order.
+ */
+namespace PopulationSketch {
+enum : int {
+    FirstPoint = 0,
+    FirstIndicator = MeridianPoint::Count,
+    Count = FirstIndicator + HealthMetricCalculator::INDICATOR_COUNT
+};
+}
+
+/**
+ * @brief Where one scan falls in the population, as percentiles from 0 to
+ * 100: each meridian reading and each indicator against the same reading or
+ * indicator over every scan stored.
+ */
+struct PopulationPercentiles {
+    int population = 0;
+    float points[MeridianPoint::Count] = {};
+    float indicators[HealthMetricCalculator::INDICATOR_COUNT] = {};
+};
+
+/**
+ * @brief Keeps a quantile sketch of every meridian reading and indicator
+ * over all scans (the population_sketch table), so a scan is placed in the
+ * population without sorting anything. The sketches record the newest scan
+ * id they include and catch up by reading only the scans inserted since,
+ * which ScanController does in every insert's transaction. Deleted scans
+ * stay in the sketches until rebuildSketches() is called.
+ */
+class PopulationController {
+
+    public:
+        PopulationController(DatabaseManager&);
+
+        bool getPercentiles(ScanModel&, PopulationPercentiles&);
+        bool getSketch(int, QuantileSketch&);
+        bool rebuildSketches();
+
+        // Throwing step of ScanController's insert transactions
+        void catchUp();
+
+        // Scans read from the database per step when catching up
+        static const int CATCH_UP_CHUNK = 10000;
+
+    private:
+        DatabaseManager& db;
+        HealthMetricCalculator calculator;
+        QVector<QuantileSketch> sketches;
+        int lastScanId;
+        QMutex mutex;
+
+        void update();
+        void load();
+        void save();
+        void addBatch(const ScanBatch&);
+};
+
+#endif
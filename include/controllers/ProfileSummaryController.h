@@ -0,0 +1,98 @@
+/**
+ * @file ProfileSummaryController.h
+ * @brief Declaration of the ProfileSummaryController class.
+ */
+
+#ifndef PROFILE_SUMMARY_CONTROLLER_H
+#define PROFILE_SUMMARY_CONTROLLER_H
+
+#include <QDate>
+#include <QList>
+#include <QVariant>
+
+#include "DatabaseManager.h"
+#include "HealthMetricCalculator.h"
+#include "ScanModel.h"
+
+/**
+ * @brief Column list of profile_summary after profile_id, in SummaryColumn
+ * order.
+ */
+#define SUMMARY_COLUMNS                                                        \
+    "scan_count, first_scan_on, last_scan_on, last_scan_id, "                  \
+    "energy, immune, metabolism, psycho, skeletal, "                           \
+    "lung_sum, heart_constrictor_sum, heart_sum, small_intestine_sum, "        \
+    "triple_heater_sum, large_intestine_sum, spleen_sum, liver_sum, "          \
+    "kidney_sum, urinary_bladder_sum, gall_bladder_sum, stomach_sum"
+
+namespace SummaryColumn {
+enum : int {
+    ScanCount,
+    FirstScanOn,
+    LastScanOn,
+    LastScanId,
+    Latest,
+    OrganSums = Latest + HealthMetricCalculator::INDICATOR_COUNT,
+    Count = OrganSums + HealthMetricCalculator::ORGAN_COUNT
+};
+}
+
+/**
+ * @brief Aggregates over all of a profile's scans. latest holds the newest
+ * scan's indicators in IndicatorColumn order and organSums each organ's
+ * value summed over every scan, in ScanModel::getOrganNames() order.
+ */
+struct ProfileSummary {
+    int scanCount = 0;
+    QDate firstScanOn;
+    QDate lastScanOn;
+    int lastScanId = -1;
+    float latest[HealthMetricCalculator::INDICATOR_COUNT] = {};
+    double organSums[HealthMetricCalculator::ORGAN_COUNT] = {};
+
+    bool isEmpty() const { return scanCount == 0; }
+
+    /**
+     * @brief Gets an organ's mean value over every scan, or 0 if there are
+     * none.
+     */
+    float organAverage(int organ) const {
+        return scanCount > 0 ? static_cast<float>(organSums[organ] / scanCount)
+                             : 0.0f;
+    }
+};
+
+/**
+ * @brief Keeps one row of aggregates per profile (the profile_summary
+ * table) so dashboards read a single row however many scans a profile has.
+ * ScanController updates the row in the same transaction as every insert
+ * and delete. If the row is missing, or did not end at the profile's newest
+ * scan when it was about to be updated, it is rebuilt from the scans.
+ */
+class ProfileSummaryController {
+
+    public:
+        ProfileSummaryController(DatabaseManager&);
+
+        bool getSummary(int, ProfileSummary&);
+        bool rebuildSummary(int);
+
+        // Throwing steps of ScanController's insert and delete transactions
+        void addScan(ScanModel&, int);
+        void removeScan(const ScanModel&, int);
+        void rebuild(int);
+
+    private:
+        DatabaseManager& db;
+        HealthMetricCalculator calculator;
+
+        bool summaryAt(int, ProfileSummary&);
+        void saveSummary(int, const ProfileSummary&);
+        void refreshOldest(int, ProfileSummary&);
+        void refreshNewest(int, ProfileSummary&);
+        void setLatest(ProfileSummary&, ScanModel&);
+        static void addOrgans(ProfileSummary&, const Measurements&, int);
+        static QList<QVariant> summaryParams(int, const ProfileSummary&);
+};
+
+#endif
@@ -8,10 +8,17 @@
 #include <QString>
 #include <QDate>
 #include <QVector>
+#include <QList>
+#include <QVariant>
+#include <atomic>
 
 #include "DatabaseManager.h"
 #include "ScanModel.h"
+#include "PopulationController.h"
 #include "ProfileModel.h"
+#include "ProfileSummaryController.h"
+#include "ScanResultController.h"
+#include "TrendController.h"
 
 #define SCAN_POINTS         (24)
 class ScanController {
@@ -20,8 +27,21 @@ class ScanController {
         void createScan(const QVector<int>&, ProfileModel&);
         int generateMeasurement(int, int);
         bool storeScan(ScanModel&);
+        bool storeScans(const QVector<ScanModel>&);
+        bool deleteScan(int);
+        double getLastBatchRowsPerSecond() const;
+        ScanResultController& getResultController();
+        PopulationController& getPopulationController();
 
     private:
         DatabaseManager& db;
+        TrendController trends;
+        ScanResultController results;
+        ProfileSummaryController summaries;
+        PopulationController population;
+        std::atomic<double> lastBatchRowsPerSecond;
+
+        static const QString INSERT_SCAN_QUERY;
+        static QList<QVariant> scanParams(const ScanModel&);
 };
 #endif // SCANCONTROLLER_H
@@ -0,0 +1,60 @@
+/**
+ * @file ScanResultController.h
+ * @brief Declaration of the ScanResultController class.
+ */
+
+#ifndef SCAN_RESULT_CONTROLLER_H
+#define SCAN_RESULT_CONTROLLER_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QMutex>
+#include <QPair>
+
+#include "DatabaseManager.h"
+#include "HealthMetricCalculator.h"
+#include "ScanModel.h"
+
+/**
+ * @brief Serves a scan's organ and indicator results without recomputing
+ * them. Results are stored in the scan_result table when a scan is ingested
+ * and kept in a small LRU cache once read, both keyed by scan id and
+ * calculator version. Changing the calculator's ranges changes its version,
+ * so older results are simply never matched again and are recomputed on
+ * demand.
+ */
+class ScanResultController {
+
+    public:
+        ScanResultController(DatabaseManager&);
+
+        bool getResult(ScanModel&, ScanResult&);
+        HealthMetricCalculator& getCalculator();
+        void clearCache();
+        int getCacheHits() const;
+        int getCacheMisses() const;
+
+        // Throwing steps of ScanController's insert and delete transactions
+        bool storeResult(ScanModel&, ScanResult&);
+        void removeResult(int);
+        void cacheStoredResult(int, const ScanResult&);
+
+        static const int CACHE_SIZE = 64;
+
+    private:
+        typedef QPair<int, quint64> Key;
+
+        DatabaseManager& db;
+        HealthMetricCalculator calculator;
+        QCache<Key, ScanResult> cache;
+        mutable QMutex mutex;
+        int cacheHits;
+        int cacheMisses;
+
+        void cacheResult(const Key&, const ScanResult&);
+        void saveResult(int, quint64, const ScanResult&);
+        static QByteArray encode(const ScanResult&);
+        static bool decode(const QByteArray&, ScanResult&);
+};
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file ScanSession.h
+ * @brief Declaration of the ScanSession class.
+ */
+
+#ifndef SCANSESSION_H
+#define SCANSESSION_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "ScanModel.h"
+#include "SignalPipeline.h"
+
+class ClockTimer;
+class DeviceController;
+class ScanController;
+class SimulationClock;
+
+/**
+ * @brief What the user reports after the scan points, stored with the scan.
+ */
+struct ScanInputs {
+    double bodyTemp = 36.5;  // degrees Celsius
+    int bloodPressure = 120;
+    int heartRate = 70;
+    double sleepingTime = 7.0;  // hours
+    double currentWeight = 70.0;  // kg
+    int emotionalState = 3;  // 1-5
+    int overallFeeling = 3;  // 1-5
+};
+
+/**
+ * @brief The measurement workflow of one scan, without any widgets: the
+ * session walks from the intro page through the 24 scan points and the
+ * post-scan inputs to the results, measures each point from the device's
+ * stream, and stores the finished scan. It reports its progress through
+ * signals, which a view mirrors.
+ *
+ * Pages are numbered like the view's: the intro is 0, the scan points 1 to
+ * 24 (left side then right), then the inputs and the results. Without a
+ * device the caller drives the session, feeding each point's samples with
+ * addSamples(), as tests and benchmarks do.
+ */
+class ScanSession : public QObject {
+    Q_OBJECT
+
+   public:
+    /**
+     * @brief Creates a session on the intro page.
+     * @param parent The parent object.
+     * @param scanController Where the finished scan is stored.
+     * @param deviceController The device measured, or null.
+     * @param clock The clock the timeouts run on; null for the device's, or
+     * a real-time clock of the session's own without a device.
+     */
+    explicit ScanSession(QObject *parent = nullptr,
+                         ScanController *scanController = nullptr,
+                         DeviceController *deviceController = nullptr,
+                         SimulationClock *clock = nullptr);
+
+    /**
+     * @brief Gets the page the session is on.
+     * @return The page index.
+     */
+    int getPage() const { return page; }
+
+    /**
+     * @brief Checks if a point is being measured.
+     * @return True from startMeasurement() until a reading or an error.
+     */
+    bool isScanInProgress() const { return scanInProgress; }
+
+    /**
+     * @brief Checks if the current point has its reading.
+     * @return True until the device is released and the session moves on.
+     */
+    bool isMeasurementDone() const { return measurementDone; }
+
+    /**
+     * @brief Checks if every scan point has a reading.
+     * @return True once all 24 are in.
+     */
+    bool areAllMeasurementsComplete() const;
+
+    /**
+     * @brief Gets the clock the session's timeouts run on.
+     * @return The clock.
+     */
+    SimulationClock *getClock() const { return clock; }
+
+    /**
+     * @brief Sets the profile the scan is stored for.
+     * @param profileId The profile, or -1 for none.
+     */
+    void setProfileId(int profileId) { this->profileId = profileId; }
+
+    /**
+     * @brief Feeds samples of the current point into its signal pipeline,
+     * and completes the measurement once there is a reading.
+     * @param values The samples.
+     * @param count The number of samples.
+     */
+    void addSamples(const float *values, int count);
+
+    static const int SCAN_PAGES = 24;
+    static const int MEASUREMENTS_PER_SIDE = 12;
+    static const int INTRO_PAGE = 0;
+    static const int INPUT_PAGE = SCAN_PAGES + 1;
+    static const int RESULTS_PAGE = SCAN_PAGES + 2;
+
+    // Samples per second streamed from each point, and how long the signal
+    // may take to give a stable reading
+    static const int STREAM_SAMPLE_RATE = 1000;
+    static const int MEASUREMENT_TIMEOUT_SECONDS = 5;
+
+    /**
+     * @brief Checks if a page is one of the scan points.
+     * @param page The page index.
+     * @return True for pages 1 to 24.
+     */
+    static bool isScanPage(int page) {
+        return page > INTRO_PAGE && page <= SCAN_PAGES;
+    }
+
+   public slots:
+    /**
+     * @brief Leaves the intro page for the first scan point.
+     * @return False if the device is off or not connected.
+     */
+    bool begin();
+
+    /**
+     * @brief Starts measuring the current scan point.
+     * @return False if not on a scan point, the device is not ready, or a
+     * measurement is already running.
+     */
+    bool startMeasurement();
+
+    /**
+     * @brief Handles the device leaving the point: moves on if the point has
+     * its reading, or interrupts the measurement if it is still running.
+     */
+    void release();
+
+    /**
+     * @brief Takes the post-scan inputs and moves on to the results, which
+     * stores the scan.
+     * @param inputs What the user reported.
+     */
+    void submitInputs(const ScanInputs &inputs);
+
+    /**
+     * @brief Abandons the scan and goes back to the intro page.
+     */
+    void cancel();
+
+    /**
+     * @brief Completes the current measurement: takes the pipeline's
+     * reading, or reports an error if the signal never settled.
+     */
+    void measurementComplete();
+
+    /**
+     * @brief Records a reading for the current scan point.
+     * @param data The reading.
+     */
+    void receiveData(int data);
+
+    /**
+     * @brief Feeds the samples the device streamed so far to the pipeline.
+     */
+    void readStream();
+
+   signals:
+    /**
+     * @brief Signal emitted when the session moves to another page.
+     * @param page The new page index.
+     */
+    void pageChanged(int page);
+
+    /**
+     * @brief Signal emitted when a scan point starts measuring.
+     * @param page The scan point's page.
+     */
+    void measurementStarted(int page);
+
+    /**
+     * @brief Signal emitted when a scan point has its reading.
+     * @param page The scan point's page.
+     * @param value The reading.
+     */
+    void measurementTaken(int page, int value);
+
+    /**
+     * @brief Signal emitted when a scan point is waiting for the device
+     * again, after a reset or an interrupted measurement.
+     * @param page The scan point's page.
+     */
+    void measurementReset(int page);
+
+    /**
+     * @brief Signal emitted when something needs the user's attention.
+     * @param message The message to show.
+     */
+    void alert(const QString &message);
+
+    /**
+     * @brief Signal emitted when the finished scan has been stored.
+     * @param scan The scan, with its new id.
+     */
+    void scanStored(const ScanModel &scan);
+
+   private slots:
+    void updateCountdown();
+    void checkConnection();
+
+   private:
+    struct ScanPoint {
+        int position;
+        int rawValue;
+    };
+
+    // Samples taken from the device per read
+    static const int STREAM_READ_SIZE = 1024;
+
+    ScanController *scanController;
+    DeviceController *deviceController;
+    SimulationClock *clock;
+    ClockTimer *countdownTimer;
+    ClockTimer *connectionTimer;
+
+    int page;
+    int profileId;
+    int remainingTime;
+    bool measurementDone;
+    bool scanInProgress;
+    QVector<ScanPoint> rawMeasurements;
+    ScanInputs inputs;
+    SignalPipeline pipeline;
+
+    bool isDeviceReady() const;
+    void nextPage();
+    void processMeasurements();
+    void resetMeasurement();
+    void resetState();
+    void interrupt(const QString &message);
+};
+
+#endif  // SCANSESSION_H
@@ -0,0 +1,69 @@
+/**
+ * @file TrendController.h
+ * @brief Declaration of the TrendController class.
+ */
+
+#ifndef TREND_CONTROLLER_H
+#define TREND_CONTROLLER_H
+
+#include <QList>
+#include <QVariant>
+#include <QVector>
+
+#include "DatabaseManager.h"
+#include "HealthMetricCalculator.h"
+#include "HealthMetricModel.h"
+#include "ScanModel.h"
+#include "TrendEngine.h"
+
+/**
+ * @brief Column list of scan_trend after profile_id, in TrendColumn order.
+ */
+#define TREND_COLUMNS                                                          \
+    "seq, scan_id, energy, immune, metabolism, psycho, skeletal, "             \
+    "energy_sum, immune_sum, metabolism_sum, psycho_sum, skeletal_sum, "       \
+    "energy_xsum, immune_xsum, metabolism_xsum, psycho_xsum, skeletal_xsum"
+
+namespace TrendColumn {
+enum : int {
+    Seq,
+    ScanId,
+    Latest,
+    SumY = Latest + TrendPrefix::INDICATORS,
+    SumXY = SumY + TrendPrefix::INDICATORS,
+    Count = SumXY + TrendPrefix::INDICATORS
+};
+}
+
+/**
+ * @brief Keeps each profile's running trend sums (the scan_trend table) and
+ * answers trend queries from them. A new scan costs one appended row, and a
+ * trend over the whole history or its last 7, 30 or 90 scans costs at most
+ * two row lookups. If the sums fall behind the scan table, because scans
+ * were inserted some other way, they are rebuilt from the scans once.
+ */
+class TrendController {
+
+    public:
+        TrendController(DatabaseManager&);
+
+        bool getTrend(int, int, TrendFit&);
+        bool getTrendHealth(int, int, QVector<HealthMetricModel>&);
+        bool rebuildTrends(int);
+
+        // Throwing steps of ScanController's insert and delete transactions
+        int newestScanId(int);
+        void appendScan(ScanModel&, int);
+        void invalidate(int);
+
+    private:
+        DatabaseManager& db;
+        HealthMetricCalculator calculator;
+
+        bool prefixAt(int, int, TrendPrefix&, int&);
+        void ensureCurrent(int);
+        void rebuild(int);
+        static QList<QVariant> prefixParams(int, int, const TrendPrefix&);
+};
+
+#endif
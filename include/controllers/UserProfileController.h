@@ -8,6 +8,7 @@
 
 #include "DatabaseManager.h"
 #include "ProfileModel.h"
+#include "ScanBatch.h"
 #include "ScanModel.h"
 #include <QVector>
 #include <QDate>
@@ -15,6 +16,99 @@
 #include <QMap>
 #include <QVariant>
 #include <QList>
+#include <QFuture>
+
+/**
+ * @brief The 24 meridian reading columns in MeridianPoint order.
+ */
+#define SCAN_READING_COLUMNS                                                   \
+    "h1_lung, h1_lung_r, h2_heart_constrictor, h2_heart_constrictor_r, "       \
+    "h3_heart, h3_heart_r, h4_small_intestine, h4_small_intestine_r, "         \
+    "h5_triple_heater, h5_triple_heater_r, h6_large_intestine, "               \
+    "h6_large_intestine_r, "                                                   \
+    "f1_spleen, f1_spleen_r, f2_liver, f2_liver_r, f3_kidney, f3_kidney_r, "   \
+    "f4_urinary_bladder, f4_urinary_bladder_r, f5_gall_bladder, "              \
+    "f5_gall_bladder_r, f6_stomach, f6_stomach_r"
+
+/**
+ * @brief Column list used when loading scans. The order matches ScanColumn so
+ * rows can be read by index instead of by name.
+ */
+#define SCAN_SELECT_COLUMNS                                                    \
+    "scan_id, profile_id, " SCAN_READING_COLUMNS ", "                          \
+    "created_on, body_temp, blood_pressure, heart_rate, sleeping_time, "       \
+    "current_weight, emotional_state, overall_feeling, name, notes"
+
+/**
+ * @brief Column list used when loading a ScanBatch: the id and date followed
+ * by the readings, so reading p is at column 2 + p.
+ */
+#define SCAN_BATCH_COLUMNS "scan_id, created_on, " SCAN_READING_COLUMNS
+
+namespace ScanColumn {
+enum : int {
+    ScanId,
+    ProfileId,
+    H1Lung,
+    H1LungR,
+    H2HeartConstrictor,
+    H2HeartConstrictorR,
+    H3Heart,
+    H3HeartR,
+    H4SmallIntestine,
+    H4SmallIntestineR,
+    H5TripleHeater,
+    H5TripleHeaterR,
+    H6LargeIntestine,
+    H6LargeIntestineR,
+    F1Spleen,
+    F1SpleenR,
+    F2Liver,
+    F2LiverR,
+    F3Kidney,
+    F3KidneyR,
+    F4UrinaryBladder,
+    F4UrinaryBladderR,
+    F5GallBladder,
+    F5GallBladderR,
+    F6Stomach,
+    F6StomachR,
+    CreatedOn,
+    BodyTemp,
+    BloodPressure,
+    HeartRate,
+    SleepingTime,
+    CurrentWeight,
+    EmotionalState,
+    OverallFeeling,
+    Name,
+    Notes,
+    Count
+};
+}
+
+/**
+ * @brief A position in a profile's scan history. History is ordered by
+ * (created_on, scan_id), which the scan index serves directly, so a page
+ * can start from any position without an OFFSET.
+ */
+struct ScanCursor {
+    QDate createdOn;
+    int scanId = -1;
+
+    ScanCursor() = default;
+    ScanCursor(const QDate& createdOn, int scanId)
+        : createdOn(createdOn), scanId(scanId) {}
+    explicit ScanCursor(const ScanModel& scan)
+        : createdOn(scan.getCreatedOn()), scanId(scan.getId()) {}
+
+    bool isValid() const { return scanId >= 0; }
+};
+
+/**
+ * @brief Which way to page from a cursor: towards older or newer scans.
+ */
+enum class PageDirection { Older, Newer };
 
 class UserProfileController {
 
@@ -30,6 +124,23 @@ public:
     bool deleteProfile(int);
     bool deleteProfile(ProfileModel*);
     bool getProfileScans(int, QVector<ScanModel*>&) const;
+    bool getProfileScans(int, QVector<ScanModel>&) const;
+    bool getProfiles(int, QVector<ProfileModel>&) const;
+    bool getScan(int, ScanModel&) const;
+    bool getProfileScanBatch(int, ScanBatch&) const;
+
+    bool getProfileScansPage(int, const ScanCursor&, int, PageDirection,
+                             QVector<ScanModel>&, const QDate& = QDate(),
+                             const QDate& = QDate()) const;
+
+    QFuture<QVector<ScanModel>> getProfileScansAsync(int) const;
+    QFuture<QVector<ScanModel>> getProfileScansPageAsync(
+        int, const ScanCursor&, int, PageDirection, const QDate& = QDate(),
+        const QDate& = QDate()) const;
+    QFuture<QVector<ProfileModel>> getProfilesAsync(int) const;
+
+    static ScanModel scanFromRow(const QSqlQuery&);
+    static ProfileModel profileFromRow(const QSqlQuery&);
 
 private:
     DatabaseManager& db;
@@ -6,32 +6,77 @@
 #ifndef HEALTH_METRIC_MODEL_H
 #define HEALTH_METRIC_MODEL_H
 
+#include <QLatin1String>
 #include <QString>
+#include <cstdint>
+
+/**
+ * @brief Identifies every metric the calculator produces. Organs come first,
+ * in ScanModel::getOrganNames() order, then the indicators and the trends,
+ * both in the order HealthMetricCalculator reports them.
+ */
+namespace HealthMetric {
+enum Id : uint8_t {
+    Lung,
+    HeartConstrictor,
+    Heart,
+    SmallIntestine,
+    TripleHeater,
+    LargeIntestine,
+    Spleen,
+    Liver,
+    Kidney,
+    UrinaryBladder,
+    GallBladder,
+    Stomach,
+
+    EnergyLevel,
+    ImmuneSystem,
+    Metabolism,
+    PsychoState,
+    Musculoskeletal,
+
+    EnergyTrend,
+    ImmuneTrend,
+    MetabolismTrend,
+    PsychoTrend,
+    MusculoskeletalTrend,
+
+    Count
+};
+
+constexpr int FirstOrgan = Lung;
+constexpr int FirstIndicator = EnergyLevel;
+constexpr int FirstTrend = EnergyTrend;
+}  // namespace HealthMetric
+
+/**
+ * @brief One calculated metric, held by value: which metric it is, its value
+ * and its level. Names and descriptions come from static tables, so a result
+ * owns no strings and needs no heap allocation.
+ */
 class HealthMetricModel {
    public:
     HealthMetricModel();
-    HealthMetricModel(QString, float, QString, int);
-    ~HealthMetricModel();
+    HealthMetricModel(HealthMetric::Id, float, int);
 
-    QString getName() const;
-    void setName(QString);
+    HealthMetric::Id getId() const;
+    QLatin1String getName() const;
 
     float getValue() const;
     void setValue(float);
 
-    QString getDesc() const;
-    void setDesc(QString);
+    QLatin1String getDesc() const;
 
     int getLevel() const;
     void setLevel(int);
 
-    QString toString();
+    QString toString() const;
 
    private:
-    QString name;
     float value;
-    QString desc;
-    int level;  // -1 below normal, 0 if normal, +1 if above normal
+    HealthMetric::Id id;
+    int8_t level;  // -1 below normal, 0 if normal, +1 if above normal
 };
 
 #endif
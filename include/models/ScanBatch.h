@@ -0,0 +1,55 @@
+/**
+ * @file ScanBatch.h
+ * @brief A column-wise collection of scans for bulk analytics.
+ */
+
+#ifndef SCAN_BATCH_H
+#define SCAN_BATCH_H
+
+#include <QDate>
+#include <QVector>
+#include <array>
+#include <cstdint>
+
+#include "ScanModel.h"
+
+/**
+ * @brief Holds many scans' readings as one contiguous column per meridian
+ * point, alongside columns of scan ids and dates. Row i of every column
+ * belongs to the same scan. Computations that combine a few points across
+ * a long history read straight down the columns they need instead of
+ * chasing a pointer per scan.
+ */
+class ScanBatch {
+   public:
+    ScanBatch();
+
+    int size() const;
+    bool isEmpty() const;
+    void reserve(int);
+    void clear();
+
+    void append(int id, const QDate& createdOn, const Measurements& readings);
+    void append(const ScanModel&);
+
+    /**
+     * @brief Returns the readings of one meridian point for every scan.
+     * @param point a MeridianPoint index
+     */
+    const int16_t* column(int point) const;
+
+    const QVector<int>& getIds() const;
+    const QVector<QDate>& getCreatedOn() const;
+
+    /**
+     * @brief Gathers one scan's readings back into row form.
+     */
+    Measurements readingsAt(int row) const;
+
+   private:
+    QVector<int> ids;
+    QVector<QDate> createdOn;
+    std::array<QVector<int16_t>, MeridianPoint::Count> columns;
+};
+
+#endif
@@ -9,6 +9,93 @@
 #include <QDate>
 #include <QString>
 #include <QVector>
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Positions of the 24 meridian readings within a scan. Each organ has
+ * a left reading followed by its right reading; the six hand (H) points come
+ * before the six foot (F) points, matching the scan table's column order.
+ */
+namespace MeridianPoint {
+enum : int {
+    H1Lung,
+    H1LungR,
+    H2HeartConstrictor,
+    H2HeartConstrictorR,
+    H3Heart,
+    H3HeartR,
+    H4SmallIntestine,
+    H4SmallIntestineR,
+    H5TripleHeater,
+    H5TripleHeaterR,
+    H6LargeIntestine,
+    H6LargeIntestineR,
+    F1Spleen,
+    F1SpleenR,
+    F2Liver,
+    F2LiverR,
+    F3Kidney,
+    F3KidneyR,
+    F4UrinaryBladder,
+    F4UrinaryBladderR,
+    F5GallBladder,
+    F5GallBladderR,
+    F6Stomach,
+    F6StomachR,
+    Count
+};
+}
+
+using Measurements = std::array<int16_t, MeridianPoint::Count>;
+
+/**
+ * @brief Read-only view of some of a scan's readings, picked out by a table
+ * of MeridianPoint indices. It owns nothing and is only valid while the scan
+ * it came from is alive.
+ */
+class MeasurementView {
+   public:
+    class const_iterator {
+       public:
+        constexpr const_iterator(const int16_t* readings, const uint8_t* index)
+            : readings(readings), index(index) {}
+        constexpr const int16_t& operator*() const { return readings[*index]; }
+        constexpr const_iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        constexpr bool operator!=(const const_iterator& other) const {
+            return index != other.index;
+        }
+
+       private:
+        const int16_t* readings;
+        const uint8_t* index;
+    };
+
+    constexpr MeasurementView(const int16_t* readings, const uint8_t* indices,
+                              int count)
+        : readings(readings), indices(indices), count(count) {}
+
+    constexpr int size() const { return count; }
+    constexpr bool isEmpty() const { return count == 0; }
+    constexpr const int16_t& operator[](int i) const {
+        return readings[indices[i]];
+    }
+    constexpr const_iterator begin() const {
+        return const_iterator(readings, indices);
+    }
+    constexpr const_iterator end() const {
+        return const_iterator(readings, indices + count);
+    }
+
+   private:
+    const int16_t* readings;
+    const uint8_t* indices;
+    int count;
+};
+
 class ScanModel {
    public:
     ScanModel();
@@ -142,45 +229,62 @@ class ScanModel {
 
     QString toString() const;
 
-    const QVector<int>& getMeasurements() const;
-    void setMeasurements(const QVector<int>&);
+    /**
+     * @brief Returns all 24 readings, indexed by MeridianPoint.
+     */
+    const Measurements& getMeasurements() const;
+    void setMeasurements(const Measurements&);
 
-    const QVector<int>& getUpperMeasurements() const;
-    const QVector<int>& getLowerMeasurements() const;
+    // Hand and foot readings, each left side first then right
+    MeasurementView getUpperMeasurements() const;
+    MeasurementView getLowerMeasurements() const;
 
-    const QVector<int>& getRightMeasurements() const;
-    const QVector<int>& getLeftMeasurements() const;
+    // Readings of one side, hand points first then foot points
+    MeasurementView getRightMeasurements() const;
+    MeasurementView getLeftMeasurements() const;
 
     static const QVector<QString>& getOrganNames();
 
+    static constexpr int SIDE_POINTS = MeridianPoint::Count / 2;
+
+    /**
+     * @brief MeridianPoint indices behind each grouped view.
+     */
+    static constexpr uint8_t UPPER_LAYOUT[SIDE_POINTS] = {
+        MeridianPoint::H1Lung,            MeridianPoint::H2HeartConstrictor,
+        MeridianPoint::H3Heart,           MeridianPoint::H4SmallIntestine,
+        MeridianPoint::H5TripleHeater,    MeridianPoint::H6LargeIntestine,
+        MeridianPoint::H1LungR,           MeridianPoint::H2HeartConstrictorR,
+        MeridianPoint::H3HeartR,          MeridianPoint::H4SmallIntestineR,
+        MeridianPoint::H5TripleHeaterR,   MeridianPoint::H6LargeIntestineR};
+    static constexpr uint8_t LOWER_LAYOUT[SIDE_POINTS] = {
+        MeridianPoint::F1Spleen,          MeridianPoint::F2Liver,
+        MeridianPoint::F3Kidney,          MeridianPoint::F4UrinaryBladder,
+        MeridianPoint::F5GallBladder,     MeridianPoint::F6Stomach,
+        MeridianPoint::F1SpleenR,         MeridianPoint::F2LiverR,
+        MeridianPoint::F3KidneyR,         MeridianPoint::F4UrinaryBladderR,
+        MeridianPoint::F5GallBladderR,    MeridianPoint::F6StomachR};
+    static constexpr uint8_t LEFT_LAYOUT[SIDE_POINTS] = {
+        MeridianPoint::H1Lung,            MeridianPoint::H2HeartConstrictor,
+        MeridianPoint::H3Heart,           MeridianPoint::H4SmallIntestine,
+        MeridianPoint::H5TripleHeater,    MeridianPoint::H6LargeIntestine,
+        MeridianPoint::F1Spleen,          MeridianPoint::F2Liver,
+        MeridianPoint::F3Kidney,          MeridianPoint::F4UrinaryBladder,
+        MeridianPoint::F5GallBladder,     MeridianPoint::F6Stomach};
+    static constexpr uint8_t RIGHT_LAYOUT[SIDE_POINTS] = {
+        MeridianPoint::H1LungR,           MeridianPoint::H2HeartConstrictorR,
+        MeridianPoint::H3HeartR,          MeridianPoint::H4SmallIntestineR,
+        MeridianPoint::H5TripleHeaterR,   MeridianPoint::H6LargeIntestineR,
+        MeridianPoint::F1SpleenR,         MeridianPoint::F2LiverR,
+        MeridianPoint::F3KidneyR,         MeridianPoint::F4UrinaryBladderR,
+        MeridianPoint::F5GallBladderR,    MeridianPoint::F6StomachR};
+
    private:
     int id;
     int profileId;
 
-    int h1Lung;
-    int h1LungR;
-    int h2HeartConstrictor;
-    int h2HeartConstrictorR;
-    int h3Heart;
-    int h3HeartR;
-    int h4SmallIntestine;
-    int h4SmallIntestineR;
-    int h5TripleHeater;
-    int h5TripleHeaterR;
-    int h6LargeIntestine;
-    int h6LargeIntestineR;
-    int f1Spleen;
-    int f1SpleenR;
-    int f2Liver;
-    int f2LiverR;
-    int f3Kidney;
-    int f3KidneyR;
-    int f4UrinaryBladder;
-    int f4UrinaryBladderR;
-    int f5GallBladder;
-    int f5GallBladderR;
-    int f6Stomach;
-    int f6StomachR;
+    // Held inline so copying or storing a scan allocates nothing for them
+    Measurements measurements;
     QDate createdOn;
 
     int bodyTemp;
@@ -193,11 +297,6 @@ class ScanModel {
     QString name;
     QString notes;
 
-    QVector<int> measurements;
-    QVector<int> upperMeasurements;
-    QVector<int> lowerMeasurements;
-    QVector<int> rightMeasurements;
-    QVector<int> leftMeasurements;
     static const QVector<QString> organNames;
 };
 
@@ -20,6 +20,12 @@ public:
 private:
     DatabaseManager& db;
     bool testCRUD() const;
+    bool testStatementCache() const;
+    bool testSchemaVersion() const;
+    bool testThreadConnections() const;
+    bool testQueryStats() const;
+    bool testQueryPlanCheck() const;
+    bool testNestedQueryEach() const;
 };
 
 #endif
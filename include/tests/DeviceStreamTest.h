@@ -0,0 +1,27 @@
+/**
+ * @file DeviceStreamTest.h
+ * @brief Declaration of the DeviceStreamTest class.
+ */
+
+#ifndef DEVICE_STREAM_TEST_H
+#define DEVICE_STREAM_TEST_H
+
+#include "Test.h"
+#include "DeviceController.h"
+#include "SampleRing.h"
+#include <QDebug>
+
+class DeviceStreamTest : public Test {
+
+public:
+    DeviceStreamTest();
+    ~DeviceStreamTest();
+    virtual bool test() const override;
+private:
+    bool testRingBounds() const;
+    bool testRingThreads() const;
+    bool testStream(int) const;
+    bool testDeviceOff() const;
+};
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file DeviceTraceTest.h
+ * @brief Declaration of the DeviceTraceTest class.
+ */
+
+#ifndef DEVICE_TRACE_TEST_H
+#define DEVICE_TRACE_TEST_H
+
+#include "Test.h"
+#include "DeviceTrace.h"
+#include <QDebug>
+#include <QString>
+
+class DeviceTraceTest : public Test {
+
+public:
+    DeviceTraceTest();
+    ~DeviceTraceTest();
+    virtual bool test() const override;
+private:
+    QString path;
+
+    bool testRoundTrip() const;
+    bool testDamage() const;
+    bool testRecordReplay() const;
+    bool testRealTime() const;
+};
+
+#endif
@@ -9,6 +9,7 @@
 #include "Test.h"
 #include "HealthMetricModel.h"
 #include "HealthMetricCalculator.h"
+#include "ScanBatch.h"
 #include "ScanModel.h"
 #include <QVector>
 #include <QDate>
@@ -19,6 +20,10 @@ public:
     HealthMetricCalculatorTest();
     ~HealthMetricCalculatorTest();
     virtual bool test() const override;
+private:
+    bool testBatch(HealthMetricCalculator*, const QVector<ScanModel*>&) const;
+    bool testDeterminism(HealthMetricCalculator*, const QVector<ScanModel*>&) const;
+    bool testScoreBatch(HealthMetricCalculator*) const;
 };
 
 #endif
@@ -0,0 +1,27 @@
+/**
+ * @file IndicatorKernelTest.h
+ * @brief Declaration of the IndicatorKernelTest class.
+ */
+
+#ifndef INDICATOR_KERNEL_TEST_H
+#define INDICATOR_KERNEL_TEST_H
+
+#include "Test.h"
+#include "IndicatorKernel.h"
+#include "ScanModel.h"
+#include <QDebug>
+#include <QVector>
+
+class IndicatorKernelTest : public Test {
+
+public:
+    IndicatorKernelTest();
+    ~IndicatorKernelTest();
+    virtual bool test() const override;
+private:
+    bool testSum(IndicatorKernel::Isa, const QVector<Measurements>&) const;
+    bool testColumns(IndicatorKernel::Isa, const QVector<Measurements>&) const;
+    void benchmark(const QVector<Measurements>&) const;
+};
+
+#endif
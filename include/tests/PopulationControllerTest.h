@@ -0,0 +1,30 @@
+/**
+ * @file PopulationControllerTest.h
+ * @brief Declaration of the PopulationControllerTest class.
+ */
+
+#ifndef POPULATION_CONTROLLER_TEST_H
+#define POPULATION_CONTROLLER_TEST_H
+
+#include "Test.h"
+#include "DatabaseManager.h"
+#include "PopulationController.h"
+#include "ScanController.h"
+#include "TestFixtures.h"
+#include "UserProfileController.h"
+#include <QDebug>
+
+class PopulationControllerTest : public Test {
+public:
+    PopulationControllerTest();
+    ~PopulationControllerTest();
+    virtual bool test() const override;
+private:
+    bool testIngest(int) const;
+    bool testPercentiles() const;
+    bool testRebuild(int) const;
+    TestFixtures::ScratchDatabase scratch;
+    DatabaseManager& db;
+};
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file ProfileSummaryControllerTest.h
+ * @brief Declaration of the ProfileSummaryControllerTest class.
+ */
+
+#ifndef PROFILE_SUMMARY_CONTROLLER_TEST_H
+#define PROFILE_SUMMARY_CONTROLLER_TEST_H
+
+#include "Test.h"
+#include "DatabaseManager.h"
+#include "ProfileSummaryController.h"
+#include "ScanController.h"
+#include "TestFixtures.h"
+#include "UserProfileController.h"
+#include <QDebug>
+
+class ProfileSummaryControllerTest : public Test {
+public:
+    ProfileSummaryControllerTest();
+    ~ProfileSummaryControllerTest();
+    virtual bool test() const override;
+private:
+    bool matchesScans(int, const char*) const;
+    bool testDeletes(int) const;
+    TestFixtures::ScratchDatabase scratch;
+    DatabaseManager& db;
+};
+
+#endif
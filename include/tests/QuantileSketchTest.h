@@ -0,0 +1,27 @@
+/**
+ * @file QuantileSketchTest.h
+ * @brief Declaration of the QuantileSketchTest class.
+ */
+
+#ifndef QUANTILE_SKETCH_TEST_H
+#define QUANTILE_SKETCH_TEST_H
+
+#include "Test.h"
+#include "QuantileSketch.h"
+#include <QDebug>
+#include <QVector>
+
+class QuantileSketchTest : public Test {
+
+public:
+    QuantileSketchTest();
+    ~QuantileSketchTest();
+    virtual bool test() const override;
+private:
+    bool testAccuracy(const char*, const QVector<double>&, double) const;
+    bool testMerge(const QVector<double>&) const;
+    bool testBytes(const QVector<double>&) const;
+    void benchmark(const QVector<double>&) const;
+};
+
+#endif
@@ -18,6 +18,8 @@ public:
     ScanModelTest();
     ~ScanModelTest();
     virtual bool test () const override;
+private:
+    bool testLayout() const;
 };
 
 #endif
@@ -0,0 +1,29 @@
+/**
+ * @file ScanResultControllerTest.h
+ * @brief Declaration of the ScanResultControllerTest class.
+ */
+
+#ifndef SCAN_RESULT_CONTROLLER_TEST_H
+#define SCAN_RESULT_CONTROLLER_TEST_H
+
+#include "Test.h"
+#include "DatabaseManager.h"
+#include "ScanController.h"
+#include "TestFixtures.h"
+#include "ScanResultController.h"
+#include "UserProfileController.h"
+#include <QDebug>
+
+class ScanResultControllerTest : public Test {
+public:
+    ScanResultControllerTest();
+    ~ScanResultControllerTest();
+    virtual bool test() const override;
+private:
+    bool testCache(ScanModel&) const;
+    bool testVersion(ScanModel&) const;
+    TestFixtures::ScratchDatabase scratch;
+    DatabaseManager& db;
+};
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * @file ScanSessionTest.h
+ * @brief Declaration of the ScanSessionTest class.
+ */
+
+#ifndef SCAN_SESSION_TEST_H
+#define SCAN_SESSION_TEST_H
+
+#include "Test.h"
+#include "DatabaseManager.h"
+#include "ScanController.h"
+#include "ScanSession.h"
+#include "TestFixtures.h"
+#include "UserProfileController.h"
+#include <QDebug>
+
+class ScanSessionTest : public Test {
+
+public:
+    ScanSessionTest();
+    ~ScanSessionTest();
+    virtual bool test() const override;
+private:
+    bool testConcurrent(int) const;
+    bool testTimeout() const;
+    bool testCancel() const;
+    TestFixtures::ScratchDatabase scratch;
+    DatabaseManager& db;
+};
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file SignalPipelineTest.h
+ * @brief Declaration of the SignalPipelineTest class.
+ */
+
+#ifndef SIGNAL_PIPELINE_TEST_H
+#define SIGNAL_PIPELINE_TEST_H
+
+#include "Test.h"
+#include "SignalPipeline.h"
+#include <QDebug>
+#include <QVector>
+
+class SignalPipelineTest : public Test {
+
+public:
+    SignalPipelineTest();
+    ~SignalPipelineTest();
+    virtual bool test() const override;
+private:
+    bool testMedian(int) const;
+    bool testBlocks() const;
+    bool testReadings(int) const;
+    bool testContactLoss() const;
+    bool testLive() const;
+    void benchmark() const;
+};
+
+#endif
@@ -0,0 +1,26 @@
+/**
+ * @file SimulationClockTest.h
+ * @brief Declaration of the SimulationClockTest class.
+ */
+
+#ifndef SIMULATION_CLOCK_TEST_H
+#define SIMULATION_CLOCK_TEST_H
+
+#include "Test.h"
+#include "SimulationClock.h"
+#include <QDebug>
+
+class SimulationClockTest : public Test {
+
+public:
+    SimulationClockTest();
+    ~SimulationClockTest();
+    virtual bool test() const override;
+private:
+    bool testStepped() const;
+    bool testBatteryDrain() const;
+    bool testSteppedStream() const;
+    bool testAccelerated() const;
+};
+
+#endif
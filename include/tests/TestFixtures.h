@@ -0,0 +1,51 @@
+/**
+ * @file TestFixtures.h
+ * @brief Scan and profile fixtures shared by the controller tests.
+ */
+
+#ifndef TEST_FIXTURES_H
+#define TEST_FIXTURES_H
+
+#include "DatabaseManager.h"
+#include "ScanModel.h"
+#include <QString>
+#include <QTemporaryDir>
+#include <functional>
+
+namespace TestFixtures {
+
+/**
+ * @brief A database of its own in a temporary directory, migrated and seeded
+ * like the development database and removed with the fixture. For tests
+ * whose writes reach shared state, such as the population sketches, that
+ * must not leak into the app's database.
+ */
+class ScratchDatabase {
+public:
+    ScratchDatabase();
+    DatabaseManager& get() { return db; }
+private:
+    // Declared first so the database is closed before its directory goes
+    QTemporaryDir dir;
+    DatabaseManager db;
+};
+
+/**
+ * @brief Builds an unsaved scan for a test profile.
+ * @param profileId the profile the scan belongs to
+ * @param name the scan's name, telling which test made it
+ * @param reading gives the reading of each MeridianPoint
+ */
+ScanModel makeScan(int profileId, const QString& name,
+                   const std::function<int(int)>& reading);
+
+/**
+ * @brief Deletes a test profile with its scans and everything derived from
+ * them: cached results, trend sums and the profile summary.
+ * @return false, after logging why, if a delete failed
+ */
+bool deleteProfile(DatabaseManager& db, int profileId);
+
+}  // namespace TestFixtures
+
+#endif
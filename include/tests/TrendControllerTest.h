@@ -0,0 +1,29 @@
+/**
+ * @file TrendControllerTest.h
+ * @brief Declaration of the TrendControllerTest class.
+ */
+
+#ifndef TREND_CONTROLLER_TEST_H
+#define TREND_CONTROLLER_TEST_H
+
+#include "Test.h"
+#include "DatabaseManager.h"
+#include "ScanController.h"
+#include "TestFixtures.h"
+#include "TrendController.h"
+#include "UserProfileController.h"
+#include <QDebug>
+
+class TrendControllerTest : public Test {
+public:
+    TrendControllerTest();
+    ~TrendControllerTest();
+    virtual bool test() const override;
+private:
+    bool testWindows(int, int) const;
+    bool testResync(int) const;
+    TestFixtures::ScratchDatabase scratch;
+    DatabaseManager& db;
+};
+
+#endif
@@ -20,8 +20,10 @@ public:
     virtual bool test () const override;
 private:
     bool testCRUD() const;
+    bool testQueryPlans() const;
     void cleanup(QVector<ProfileModel*>&) const;
     UserController* uc;
+    DatabaseManager& db;
 };
 #endif
 
@@ -18,8 +18,13 @@ public:
     virtual bool test () const override;
 private:
     bool testCRUD() const;
+    bool testQueryPlans() const;
+    bool testAsync() const;
+    bool testPaging() const;
+    bool testScanBatch() const;
     void cleanup(QVector<ProfileModel*>&) const;
     UserProfileController* upc;
+    DatabaseManager& db;
 };
 #endif
 
@@ -6,17 +6,16 @@
 #ifndef HISTORYWIDGET_H
 #define HISTORYWIDGET_H
 
-#include <QList>
 #include <QWidget>
 
 #include "ResultsWidget.h"
 #include "ScanModel.h"
+#include "UserProfileController.h"
 
-class QGridLayout;
+class QListView;
+class QModelIndex;
 class QVBoxLayout;
-class QPushButton;
-class QScrollArea;
-class UserProfileController;
+class ScanListModel;
 
 class HistoryWidget : public QWidget {
     Q_OBJECT
@@ -25,40 +24,33 @@ class HistoryWidget : public QWidget {
     explicit HistoryWidget(
         QWidget* parent = nullptr,
         UserProfileController* userProfileController = nullptr);
-
-   protected:
-    /**
-     * @brief Event filter to handle custom events.
-     * @param obj The object receiving the event.
-     * @param event The event being received.
-     * @return True if the event was handled; otherwise false.
-     */
-    bool eventFilter(QObject* obj, QEvent* event) override;
+    void setResultController(ScanResultController* controller);
 
    public slots:
     void setCurrentProfile(int profileId);
     void onNewScanStored(const ScanModel& scan);
 
    private slots:
-    void onScanSelected(ScanModel* scan);
+    void onScanSelected(const QModelIndex& index);
     void onBackToHistoryClicked();
+    void onScansLoaded();
 
    private:
     void setupUI();
-    void loadScansForProfile();
-    void displayScans();
-    void showResultsView(ScanModel* scan);
+    void setupEmptyView();
+    void updateEmptyState();
+    void showResultsView(const ScanModel& scan);
     void showHistoryView();
 
     UserProfileController* userProfileController;
     int currentProfileId;
-    QVector<ScanModel*> profileScans;
+    ScanListModel* scanListModel;
 
     QWidget* historyView;
     ResultsWidget* resultsView;
     QVBoxLayout* mainLayout;
-    QVBoxLayout* scansGrid;
-    QScrollArea* scrollArea;
+    QListView* scanList;
+    QWidget* emptyView;
 };
 
 #endif  // HISTORYWIDGET_H
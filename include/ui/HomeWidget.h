@@ -2,6 +2,7 @@
 #ifndef HOMEWIDGET_H
 #define HOMEWIDGET_H
 
+#include <QFutureWatcher>
 #include <QWidget>
 
 #include "UserProfileController.h"
@@ -24,8 +25,10 @@ class HomeWidget : public QWidget {
    private:
     void setupUI();
     void populateProfileList();
+    void onProfilesLoaded();
 
     UserProfileController* profileController;
+    QFutureWatcher<QVector<ProfileModel>>* profilesWatcher;
     QComboBox* profileSelector;
     QLabel* dateTimeLabel;
     QLabel* welcomeLabel;
@@ -9,12 +9,13 @@
 #include <QMap>
 #include <QWidget>
 
+#include "ScanSession.h"
+
 class QStackedWidget;
 class QLabel;
 class QPushButton;
 class QDateEdit;
 class QTimeEdit;
-class QTimer;
 class QComboBox;
 class QVBoxLayout;
 class QFormLayout;
@@ -25,7 +26,6 @@ class UserProfileController;
 class ProfileModel;
 class QSpinBox;
 class QDoubleSpinBox;
-class ScanModel;
 class QComboBox;
 
 class MeasureNowWidget : public QWidget {
@@ -49,8 +49,6 @@ class MeasureNowWidget : public QWidget {
 
    public slots:
     void startCountdown();
-    void measurementComplete();
-    void receiveData(int data);
     void onImageReleased();
     void onStartStopButtonClicked();
 
@@ -58,17 +56,8 @@ class MeasureNowWidget : public QWidget {
     UserProfileController* profileController;
     ScanController* scanController;
     QComboBox* profileComboBox;
-    int selectedProfileId;
     int currentUserId;
 
-    static const int TOTAL_SCAN_PAGES = 24;
-    static const int MEASUREMENTS_PER_SIDE = 12;
-
-    struct ScanPoint {
-        int position;
-        int rawValue;
-    };
-
     const QStringList measurementLabels = {"Lungs",
                                            "Pericardium",
                                            "Heart",
@@ -82,8 +71,6 @@ class MeasureNowWidget : public QWidget {
                                            "Gallbladder",
                                            "Stomach"};
     QStringList imagePaths;
-    QVector<ScanPoint> rawMeasurements;
-    QMap<QString, int> calculatedResults;
     ResultsWidget* resultsWidget;
     QMap<int, QPixmap> originalPixmaps;
 
@@ -95,12 +82,7 @@ class MeasureNowWidget : public QWidget {
     QTimeEdit* timeEdit{nullptr};
 
     DeviceController* deviceController{nullptr};
-    QTimer* countdownTimer{nullptr};
-    QTimer* connectionTimer{nullptr};
-    int remainingTime{0};
-    int currentScanPage{1};
-    bool measurementDone{false};
-    bool scanInProgress{false};
+    ScanSession* session{nullptr};
 
     QDoubleSpinBox* bodyTempEdit;
     QSpinBox* bloodPressureEdit;
@@ -110,15 +92,7 @@ class MeasureNowWidget : public QWidget {
     QComboBox* emotionalStateEdit;
     QComboBox* overallFeelingEdit;
 
-    double bodyTemp;
-    int bloodPressure;
-    int heartRate;
-    double sleepingTime;
-    double currentWeight;
-    int emotionalState;
-    int overallFeeling;
-
-    void collectUserInputs();
+    ScanInputs collectUserInputs() const;
     void adjustImageSize(int pageIndex);
 
     void initializeUIComponents(QVBoxLayout* mainLayout);
@@ -129,21 +103,17 @@ class MeasureNowWidget : public QWidget {
     void createScanPage(int pageNum);
     void createPostScanInputPage();
     void createResultsPage();
-    void nextPage();
+    void connectSession();
 
-    void processMeasurements();
-    bool areAllMeasurementsComplete() const;
-    void showMeasurementResult(int value);
+    void showPage(int page);
+    void setStatusText(int page, const QString& text);
+    void showScanResults(const ScanModel& scan);
     void displayResults();
 
-    void resetMeasurement();
-    void resetState();
     void updateButtonState();
-    void updateCountdown();
 
     void populateProfileList(QComboBox* profileComboBox);
     void setErrorState(QLabel* label);
-    void handleScanError();
     void showAlert(const QString& message, bool autoHide = true);
 };
 
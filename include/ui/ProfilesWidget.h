@@ -7,6 +7,7 @@
 #define PROFILESWIDGET_H
 
 #include <QDate>
+#include <QFutureWatcher>
 #include <QWidget>
 
 #include "ProfileEditWidget.h"
@@ -50,6 +51,7 @@ class ProfilesWidget : public QWidget {
     void handleProfileSave(QString name, QString sex, int weight, int height,
                            QDate dob);
     void handleProfileDelete(int profileId);
+    void onProfilesLoaded();
 
    private:
     void createListView();
@@ -68,6 +70,8 @@ class ProfilesWidget : public QWidget {
     QVBoxLayout *profilesLayout;
     UserProfileController *profileController;
     QVector<ProfileModel *> profiles;
+    QFutureWatcher<QVector<ProfileModel>> *profilesWatcher;
+    bool notifyProfilesChanged;
 };
 
 #endif  // PROFILESWIDGET_H
@@ -11,6 +11,7 @@
 
 #include "HealthMetricCalculator.h"
 #include "ScanModel.h"
+#include "ScanResultController.h"
 
 class ResultsWidget : public QWidget {
     Q_OBJECT
@@ -18,6 +19,7 @@ class ResultsWidget : public QWidget {
    public:
     explicit ResultsWidget(QWidget* parent = nullptr);
     void setScanModel(const ScanModel& scanModel);
+    void setResultController(ScanResultController* controller);
     void setShowBackButton(bool show) { showBackButton = show; }
 
    signals:
@@ -34,9 +36,8 @@ class ResultsWidget : public QWidget {
 
     ScanModel currentScan;
     HealthMetricCalculator calculator;
+    ScanResultController* resultController = nullptr;
     QStringList measurementLabels;
-
-    QVector<HealthMetricModel*> healthMetrics;
 };
 
 #endif  // RESULTSWIDGET_H
@@ -0,0 +1,39 @@
+/**
+ * @file ScanItemDelegate.h
+ * @brief Declaration of the ScanItemDelegate class.
+ */
+
+#ifndef SCANITEMDELEGATE_H
+#define SCANITEMDELEGATE_H
+
+#include <QFont>
+#include <QStyledItemDelegate>
+
+/**
+ * @brief Paints a scan history row as a card showing the scan date and
+ * vitals. Rows are drawn directly instead of being built from widgets, so a
+ * row only costs anything while it is visible.
+ */
+class ScanItemDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+   public:
+    explicit ScanItemDelegate(QObject* parent = nullptr);
+    void paint(QPainter* painter, const QStyleOptionViewItem& option,
+               const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option,
+                   const QModelIndex& index) const override;
+
+   private:
+    static const int CARD_HEIGHT = 80;
+    static const int CARD_SPACING = 10;
+    static const int CARD_PADDING = 20;
+    static const int DATE_WIDTH = 100;
+
+    QFont dayFont;
+    QFont monthFont;
+    QFont tempFont;
+    QFont vitalsFont;
+};
+
+#endif  // SCANITEMDELEGATE_H
@@ -0,0 +1,82 @@
+/**
+ * @file ScanListModel.h
+ * @brief Declaration of the ScanListModel class.
+ */
+
+#ifndef SCANLISTMODEL_H
+#define SCANLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QVector>
+
+#include "ScanModel.h"
+#include "UserProfileController.h"
+
+/**
+ * @brief List model over one profile's scan history, newest first.
+ *
+ * Scans are fetched a page at a time as the view scrolls towards the end of
+ * the list, so opening a long history only loads what is on screen.
+ */
+class ScanListModel : public QAbstractListModel {
+    Q_OBJECT
+
+   public:
+    enum Role {
+        CreatedOnRole = Qt::UserRole + 1,
+        BodyTempRole,
+        HeartRateRole,
+        BloodPressureRole
+    };
+
+    explicit ScanListModel(UserProfileController* controller,
+                           QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index,
+                  int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    /**
+     * @brief Shows the history of another profile, starting from its newest
+     * scan.
+     * @param profileId The profile to list; non-positive ids clear the model.
+     */
+    void setProfile(int profileId);
+
+    /**
+     * @brief Drops the loaded scans and fetches the newest page again.
+     */
+    void reload();
+
+    /**
+     * @brief Returns the scan shown in the given row.
+     */
+    const ScanModel& scanAt(int row) const;
+
+    /**
+     * @brief Returns true until the first page of the profile has arrived.
+     */
+    bool isLoading() const;
+
+   signals:
+    void pageLoaded();
+
+   private slots:
+    void onPageLoaded();
+
+   private:
+    static const int FETCH_SIZE = 200;
+
+    UserProfileController* userProfileController;
+    int profileId;
+    QVector<ScanModel> scans;
+    QFutureWatcher<QVector<ScanModel>>* pageWatcher;
+    bool hasMore;
+    bool fetching;
+    bool firstPageLoaded;
+};
+
+#endif  // SCANLISTMODEL_H
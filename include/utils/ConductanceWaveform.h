@@ -0,0 +1,50 @@
+/**
+ * @file ConductanceWaveform.h
+ * @brief Generates a simulated conductance waveform for one point.
+ */
+
+#ifndef CONDUCTANCE_WAVEFORM_H
+#define CONDUCTANCE_WAVEFORM_H
+
+#include <QtGlobal>
+#include <random>
+
+/**
+ * @brief What one point's waveform looks like: open circuit until the probe
+ * touches the skin, an exponential rise to the point's reading, and noise
+ * with occasional spikes from probe movement on top.
+ */
+struct WaveformShape {
+    float plateau = 100.0f;    // reading the signal settles at
+    float noise = 2.0f;        // standard deviation of the noise
+    float contactMs = 50.0f;   // time before the probe touches
+    float riseMs = 120.0f;     // time constant of the rise after contact
+    float spikeRate = 0.002f;  // fraction of samples that are spikes
+    float spikeSize = 40.0f;   // largest spike, either way
+};
+
+/**
+ * @brief Produces a WaveformShape's samples one after another at a fixed
+ * sample rate. The same shape, rate and seed give the same samples.
+ */
+class ConductanceWaveform {
+
+    public:
+        ConductanceWaveform(const WaveformShape&, int sampleRate,
+                            quint32 seed);
+
+        float next();
+        void generate(float*, int);
+
+        qint64 position() const { return index; }
+
+    private:
+        WaveformShape shape;
+        double msPerSample;
+        qint64 index;
+        std::mt19937 generator;
+        std::normal_distribution<float> noise;
+        std::uniform_real_distribution<float> uniform;
+};
+
+#endif
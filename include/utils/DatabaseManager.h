@@ -11,28 +11,100 @@
 #include <QList>
 #include <QVariant>
 #include <QMap>
+#include <QCache>
 #include <QFile>
 #include <QTextStream>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QMutex>
+#include <QSet>
+#include <QThreadStorage>
+#include <atomic>
+#include <functional>
 
+#include "QueryStats.h"
+
+/**
+ * @brief Callback invoked once per result row. The query is positioned on
+ * the current row; read columns by index with QSqlQuery::value(int).
+ */
+using RowVisitor = std::function<void(const QSqlQuery&)>;
+
+/**
+ * @brief Owns the application's SQLite connections. Every thread that issues
+ * a statement gets its own named connection (in WAL mode) and its own
+ * prepared-statement cache, so the controllers can be called from worker
+ * threads as well as from the UI thread.
+ */
 class DatabaseManager {
 
     public: 
-        DatabaseManager();
+        explicit DatabaseManager(bool devMode = false, const QString& path = QString());
         ~DatabaseManager();
 
         void init();
-        void execute(const QString&, const QList<QVariant>&);
+        int schemaVersion();
+        QVariant execute(const QString&, const QList<QVariant>&);
         void query(const QString&, const QList<QVariant>&, QList<QMap<QString, QVariant>>&);
+        int queryEach(const QString&, const QList<QVariant>&, const RowVisitor&);
+        int executeBatch(const QString&, const QList<QList<QVariant>>&);
+        void transaction(const std::function<void()>&);
         bool isConnectionOpen();
         void testCRUD();
 
+        int getStatementCacheHits() const;
+        int getStatementCacheMisses() const;
+        void clearStatementCache();
+
+        void setQueryPlanCheck(bool);
+        void allowFullScan(const QString&);
+        QStringList getFullScanStatements();
+
+        void setSlowQueryThreshold(int);
+        int getSlowQueryThreshold() const;
+        StatementStats getQueryStats(const QString&);
+        QString getQueryStatsReport();
+        void dumpQueryStats();
+        void resetQueryStats();
+
+        static const int STATEMENT_CACHE_SIZE = 32;
+        static const int DEFAULT_SLOW_QUERY_MS = 100;
+
     private:
-        QSqlDatabase dbConnection;
+        struct ThreadConnection {
+            QSqlDatabase db;
+            QCache<QString, QSqlQuery> statementCache;
+            int transactionDepth;
+
+            ThreadConnection(const QString&, const QString&);
+            ~ThreadConnection();
+        };
+
+        QString databasePath;
+        QString connectionPrefix;
+        bool devMode;
+        QThreadStorage<ThreadConnection*> connections;
+        std::atomic<int> statementCacheHits;
+        std::atomic<int> statementCacheMisses;
+        std::atomic<bool> queryPlanCheck;
+        QMutex fullScanMutex;
+        QStringList fullScanStatements;
+        QSet<QString> fullScanAllowed;
+        QueryStats queryStats;
+        std::atomic<int> slowQueryThreshold;
+
+        QSqlDatabase& connection();
+        QCache<QString, QSqlQuery>& statementCache();
+        QSqlQuery* prepare(const QString&);
+        void checkQueryPlan(const QString&);
+        QStringList explainQueryPlan(const QString&);
+        void recordQuery(const QString&, const QList<QVariant>&, qint64, qint64);
         void handleError(const QSqlError&);
-        void executeSqlScript(const QString&, QSqlDatabase&);
+        bool executeSqlScript(const QString&, QSqlDatabase&);
+        bool migrate();
+
+        static const QStringList migrations;
 };
 
 #endif 
@@ -0,0 +1,112 @@
+/**
+ * @file DeviceTrace.h
+ * @brief A compact append-only binary trace of device events.
+ */
+
+#ifndef DEVICE_TRACE_H
+#define DEVICE_TRACE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief Kinds of trace record. The values are stored in trace files, so
+ * new kinds are only ever appended.
+ */
+enum class TraceRecord : quint8 {
+    Power = 1,
+    Connection = 2,
+    Charging = 3,
+    Battery = 4,
+    Data = 5,
+    StreamStart = 6,
+    Samples = 7,
+    StreamStop = 8
+};
+
+/**
+ * @brief One recorded device event. Which fields mean something depends on
+ * the type: value is the new state for Power, Connection and Charging, the
+ * level for Battery, the reading for Data and the point for StreamStart and
+ * Samples.
+ */
+struct TraceEvent {
+    TraceRecord type = TraceRecord::Power;
+    qint64 time = 0;       // microseconds since recording started
+    int value = 0;
+    int sampleRate = 0;    // StreamStart only
+    qint64 timestamp = 0;  // Samples: device time of the first, in ns
+    QVector<float> samples;
+};
+
+/**
+ * @brief Appends events to a trace file. A trace starts with an 8-byte
+ * header ("RDTRACE" and a version byte); every record is a type byte, the
+ * microseconds since the previous record as a varint, and the type's
+ * payload: a state byte, varint integers, and for Samples the point, first
+ * timestamp and count as varints followed by the values as little-endian
+ * floats. Writes are buffered and may come from any thread.
+ */
+class TraceWriter {
+
+    public:
+        TraceWriter();
+        ~TraceWriter();
+
+        bool open(const QString&);
+        void close();
+        bool isOpen() const { return opened.load(); }
+
+        void write(TraceRecord, int value = 0, int sampleRate = 0);
+        void writeSamples(int point, qint64 timestamp, const float*, int);
+        qint64 size() const;
+
+        static const QByteArray MAGIC;
+        static const quint8 VERSION = 1;
+
+        // Bytes buffered before they are written to the file
+        static const int FLUSH_SIZE = 1 << 16;
+
+    private:
+        QFile file;
+        QByteArray buffer;
+        QElapsedTimer clock;
+        qint64 lastTime;
+        qint64 written;
+        std::atomic<bool> opened;
+        mutable QMutex mutex;
+
+        void begin(TraceRecord);
+        void flush();
+};
+
+/**
+ * @brief Reads a trace written by TraceWriter, one event at a time. The
+ * whole file is loaded when opened. A record cut short at the end, as left
+ * by a recording that was interrupted, ends the trace.
+ */
+class TraceReader {
+
+    public:
+        TraceReader();
+
+        bool open(const QString&);
+        bool next(TraceEvent&);
+        bool isCorrupt() const { return corrupt; }
+
+    private:
+        QByteArray data;
+        int position;
+        qint64 time;
+        bool corrupt;
+
+        bool readRecord(TraceEvent&);
+        bool readVarint(quint64&);
+};
+
+#endif
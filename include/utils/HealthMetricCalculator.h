@@ -13,6 +13,8 @@
 #include <random>
 
 #include "HealthMetricModel.h"
+#include "IndicatorKernel.h"
+#include "ScanBatch.h"
 #include "ScanModel.h"
 
 struct Range {
@@ -22,14 +24,70 @@ struct Range {
     int withinRange(float val) const;
 };
 
+/**
+ * @brief The five indicator values of one scan.
+ */
+struct Indicators {
+    float energy;
+    float immune;
+    float metabolism;
+    float psycho;
+    float skeletal;
+};
+
+/**
+ * @brief Indicator values for every scan in a ScanBatch, one column per
+ * indicator, in batch row order.
+ */
+struct IndicatorSeries {
+    QVector<float> energy;
+    QVector<float> immune;
+    QVector<float> metabolism;
+    QVector<float> psycho;
+    QVector<float> skeletal;
+};
+
+/**
+ * @brief Scores for many scans in one flat, row-major array: row i's scores
+ * are values[i * columns] to values[(i + 1) * columns - 1], with the
+ * matching outlier flags (+1, 0, -1) at the same offsets in outliers. Reuse
+ * one table across calls to keep its storage.
+ */
+struct ScoreTable {
+    int columns = 0;
+    QVector<float> values;
+    QVector<qint8> outliers;
+
+    void resize(int rows, int columns);
+    int rows() const;
+    float value(int row, int column) const;
+    int outlier(int row, int column) const;
+};
+
+/**
+ * @brief Everything ResultsWidget shows for one scan: the organ metrics in
+ * ScanModel::getOrganNames() order and the indicator metrics in
+ * IndicatorColumn order.
+ */
+struct ScanResult {
+    QVector<HealthMetricModel> organs;
+    QVector<HealthMetricModel> indicators;
+};
+
 class HealthMetricCalculator {
 
     public:
         HealthMetricCalculator();
         ~HealthMetricCalculator();
-        bool calculateOrganHealth(ScanModel*, QVector<HealthMetricModel*>&);
-        bool calculateIndicatorHealth(ScanModel*, QVector<HealthMetricModel*>&);
-        bool calculateTrendHealth(const QVector<ScanModel*>&, QVector<HealthMetricModel*>&);
+        bool calculateOrganHealth(ScanModel*, QVector<HealthMetricModel>&);
+        bool calculateIndicatorHealth(ScanModel*, QVector<HealthMetricModel>&);
+        bool calculateTrendHealth(const QVector<ScanModel*>&, QVector<HealthMetricModel>&);
+        bool calculateTrendHealth(const ScanBatch&, QVector<HealthMetricModel>&);
+        bool calculateIndicatorSeries(const ScanBatch&, IndicatorSeries&);
+        Indicators calculateIndicators(ScanModel*);
+        bool calculateIndicatorHealthBatch(const ScanBatch&, ScoreTable&);
+        bool calculateOrganHealthBatch(const ScanBatch&, ScoreTable&);
+        bool calculateScanResult(ScanModel*, ScanResult&);
 
         float calculateEnergyHealth(ScanModel*);
         float calculateImmuneHealth(ScanModel*);
@@ -37,6 +95,30 @@ class HealthMetricCalculator {
         float calculateMetabolismHealth(ScanModel*);
         float calculatePsychoHealth(ScanModel*); 
 
+        void setDeterministic(bool);
+        bool isDeterministic() const;
+        void setSeed(quint64);
+        quint64 getSeed() const;
+
+        // Indicator batch columns, in calculateIndicatorHealth's order
+        enum IndicatorColumn { Energy, Immune, Metabolism, Psycho, Skeletal };
+
+        void setRange(IndicatorColumn, const Range&);
+        Range getRange(IndicatorColumn) const;
+        quint64 getVersion() const;
+
+        // Bump whenever a formula changes, so cached results are recomputed
+        static constexpr int ALGORITHM_VERSION = 1;
+
+        // Seed used in deterministic mode unless setSeed() says otherwise
+        static constexpr quint64 DEFAULT_SEED = 0x5261446f54656368ULL;
+
+        static constexpr int INDICATOR_COUNT = 5;
+        static constexpr int ORGAN_COUNT = ScanModel::SIDE_POINTS;
+
+        // Rows per unit of work handed to the thread pool
+        static constexpr int BATCH_CHUNK = 1024;
+
     private: 
         Range energyLevelRange{25.0f, 55.0f};
         Range psychoStateRange{0.8f, 1.2f};
@@ -44,6 +126,17 @@ class HealthMetricCalculator {
         Range immuneSysRange{47.0f, 57.0f};
         Range metabolismRange{1.1f, 1.2f};
 
-        float random(float, float);
+        bool deterministic = true;
+        quint64 seed = DEFAULT_SEED;
+        quint64 nonce = 0;
+
+        Range& rangeFor(IndicatorColumn);
+        quint64 scanKey(int);
+        QVector<quint64> scanKeys(const ScanBatch&);
+        static void indicatorsForRows(const ScanBatch&, const quint64*, int,
+                                      int, Indicators*);
+        static float metabolismWeight(quint64, int);
+        void metabolismWeights(int, float*);
+        static Indicators indicatorsFromSums(const ReadingSums&);
 };
 #endif
@@ -0,0 +1,53 @@
+/**
+ * @file IndicatorKernel.h
+ * @brief Fused summation kernels behind the health indicators.
+ */
+
+#ifndef INDICATOR_KERNEL_H
+#define INDICATOR_KERNEL_H
+
+#include <cstdint>
+
+/**
+ * @brief Every reading group the indicators are built from, for one scan.
+ * Readings are expected in MeridianPoint order: even points are the left
+ * side, odd points the right, and the first twelve are the hand (upper)
+ * points.
+ */
+struct ReadingSums {
+    int32_t total = 0;
+    int32_t upper = 0;
+    int32_t lower = 0;
+    int32_t left = 0;
+    int32_t right = 0;
+
+    // Sums of reading * (1 + weight) per side, for the metabolism indicator
+    float weightedLeft = 0.0f;
+    float weightedRight = 0.0f;
+};
+
+/**
+ * @brief Computes all reading sums in a single pass, vectorized where the
+ * CPU allows. The instruction set is picked once at startup (AVX2, then
+ * SSE2, then plain C++) and can be overridden to compare implementations.
+ */
+class IndicatorKernel {
+
+    public:
+        enum class Isa { Scalar, SSE2, AVX2 };
+
+        static ReadingSums sum(const int16_t*, const float* = nullptr);
+        static void sumColumns(const int16_t* const*, int, int32_t*, int32_t*,
+                               int32_t*, int32_t*);
+        static void sumWeightedColumns(const int16_t* const*, const float*,
+                                       int, float*, float*);
+
+        static Isa isa();
+        static Isa setIsa(Isa);
+        static Isa bestSupportedIsa();
+        static const char* isaName(Isa);
+
+        static const int READINGS = 24;
+};
+
+#endif
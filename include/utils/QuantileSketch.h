@@ -0,0 +1,62 @@
+/**
+ * @file QuantileSketch.h
+ * @brief A mergeable t-digest for estimating quantiles of a stream.
+ */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief Summarizes any number of values in a few hundred centroids (a
+ * merging t-digest). Centroids are kept small near the tails, so extreme
+ * percentiles stay accurate while the middle is coarser. Sketches built
+ * from different values can be merged, and serialize to a compact blob.
+ */
+class QuantileSketch {
+
+    public:
+        explicit QuantileSketch(double compression = DEFAULT_COMPRESSION);
+
+        void add(double value, double weight = 1.0);
+        void merge(const QuantileSketch&);
+        void clear();
+        void flush();
+
+        double quantile(double) const;
+        double cdf(double) const;
+        double count() const;
+        bool isEmpty() const;
+        double min() const;
+        double max() const;
+        int centroidCount() const;
+
+        QByteArray toBytes() const;
+        static bool fromBytes(const QByteArray&, QuantileSketch&);
+
+        // Larger keeps more centroids: more accurate, bigger and slower
+        static constexpr double DEFAULT_COMPRESSION = 200.0;
+
+        // Values buffered per unit of compression before they are merged
+        static constexpr int BUFFER_FACTOR = 5;
+
+    private:
+        struct Centroid {
+            double mean;
+            double weight;
+        };
+
+        double compression;
+        QVector<Centroid> centroids;
+        QVector<Centroid> buffer;
+        double total;
+        double smallest;
+        double largest;
+
+        QVector<Centroid> merged() const;
+        QVector<Centroid> compress(QVector<Centroid>) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file QueryStats.h
+ * @brief Declaration of the LatencyHistogram and QueryStats classes.
+ */
+
+#ifndef QUERY_STATS_H
+#define QUERY_STATS_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Log-scale histogram of latencies. Each power of two is split into
+ * SUB_BUCKETS buckets, so a percentile is accurate to within about 19%
+ * whatever the magnitude, in constant memory.
+ */
+class LatencyHistogram {
+
+    public:
+        LatencyHistogram();
+
+        void record(qint64);
+        qint64 percentile(double) const;
+        qint64 count() const;
+        qint64 total() const;
+        qint64 max() const;
+
+        static const int SUB_BUCKETS = 4;
+        static const int BUCKETS = 40 * SUB_BUCKETS;
+
+    private:
+        QVector<qint64> buckets;
+        qint64 samples;
+        qint64 sum;
+        qint64 largest;
+
+        static int bucketFor(qint64);
+        static qint64 upperBound(int);
+};
+
+/**
+ * @brief Execution statistics for one normalized statement.
+ */
+struct StatementStats {
+    LatencyHistogram latency;
+    qint64 rows = 0;
+};
+
+/**
+ * @brief Thread-safe collection of per-statement latency and row counts,
+ * keyed by normalized SQL text so statements that differ only in literal
+ * values are counted together.
+ */
+class QueryStats {
+
+    public:
+        void record(const QString&, qint64, qint64);
+        StatementStats statsFor(const QString&);
+        QMap<QString, StatementStats> snapshot();
+        QString report();
+        void reset();
+
+        static QString normalize(const QString&);
+
+    private:
+        QMutex mutex;
+        QMap<QString, StatementStats> statements;
+        QHash<QString, QString> normalized;
+};
+
+#endif
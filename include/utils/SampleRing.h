@@ -0,0 +1,108 @@
+/**
+ * @file SampleRing.h
+ * @brief A lock-free single-producer/single-consumer ring buffer.
+ */
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief A bounded queue between exactly one producer thread and one
+ * consumer thread, with no locks: each side owns one index and only reads
+ * the other's. Capacity is rounded up to a power of two so positions wrap
+ * with a mask. Items are copied in and out in bulk, so a producer at 10 kHz
+ * touches the shared indices once per block rather than once per sample.
+ */
+template <typename T>
+class SampleRing {
+
+    public:
+        explicit SampleRing(int capacity) : mask(roundUp(capacity) - 1) {
+            cells.reset(new T[mask + 1]);
+        }
+
+        SampleRing(const SampleRing&) = delete;
+        SampleRing& operator=(const SampleRing&) = delete;
+
+        /**
+         * @brief Copies items in, as many as there is room for. Producer
+         * thread only.
+         * @return the number copied; the rest did not fit
+         */
+        int push(const T* items, int count) {
+            const size_t head = writeIndex.load(std::memory_order_relaxed);
+            if (head - cachedRead + count > mask + 1)
+                cachedRead = readIndex.load(std::memory_order_acquire);
+
+            const size_t room = mask + 1 - (head - cachedRead);
+            const size_t n = std::min<size_t>(count, room);
+            for (size_t i = 0; i < n; ++i)
+                cells[(head + i) & mask] = items[i];
+            writeIndex.store(head + n, std::memory_order_release);
+            return static_cast<int>(n);
+        }
+
+        bool push(const T& item) { return push(&item, 1) == 1; }
+
+        /**
+         * @brief Copies out up to count of the oldest items. Consumer thread
+         * only.
+         * @return the number copied
+         */
+        int pop(T* items, int count) {
+            const size_t tail = readIndex.load(std::memory_order_relaxed);
+            if (cachedWrite - tail < static_cast<size_t>(count))
+                cachedWrite = writeIndex.load(std::memory_order_acquire);
+
+            const size_t n = std::min<size_t>(count, cachedWrite - tail);
+            for (size_t i = 0; i < n; ++i)
+                items[i] = cells[(tail + i) & mask];
+            readIndex.store(tail + n, std::memory_order_release);
+            return static_cast<int>(n);
+        }
+
+        bool pop(T& item) { return pop(&item, 1) == 1; }
+
+        /**
+         * @brief Items waiting; exact only on the consumer thread, and a
+         * lower bound there.
+         */
+        int size() const {
+            return static_cast<int>(
+                writeIndex.load(std::memory_order_acquire) -
+                readIndex.load(std::memory_order_acquire));
+        }
+
+        bool isEmpty() const { return size() == 0; }
+
+        int capacity() const { return static_cast<int>(mask + 1); }
+
+    private:
+        // Keeps each side's index on its own cache line
+        static const size_t CACHE_LINE = 64;
+
+        static size_t roundUp(int capacity) {
+            size_t size = 1;
+            while (size < static_cast<size_t>(std::max(capacity, 1)))
+                size <<= 1;
+            return size;
+        }
+
+        const size_t mask;
+        std::unique_ptr<T[]> cells;
+
+        // Producer side: its index, and the consumer's as last seen
+        alignas(CACHE_LINE) std::atomic<size_t> writeIndex{0};
+        size_t cachedRead = 0;
+
+        // Consumer side: its index, and the producer's as last seen
+        alignas(CACHE_LINE) std::atomic<size_t> readIndex{0};
+        size_t cachedWrite = 0;
+};
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file SignalPipeline.h
+ * @brief Reduces a point's streamed samples to one reading.
+ */
+
+#ifndef SIGNAL_PIPELINE_H
+#define SIGNAL_PIPELINE_H
+
+#include <QVector>
+#include <memory>
+#include <vector>
+
+#include "SignalStages.h"
+
+/**
+ * @brief Time spent in one stage of a SignalPipeline since its timings were
+ * last reset.
+ */
+struct StageTiming {
+    const char* name = "";
+    qint64 nanoseconds = 0;
+    qint64 samples = 0;  // samples the stage was given
+    qint64 calls = 0;
+};
+
+/**
+ * @brief Runs blocks of samples through a chain of SignalStages into a
+ * SignalEstimator, timing every stage. Stages are added in order and the
+ * pipeline is complete once the estimator has enough samples; samples
+ * pushed after that are ignored. standard() builds the chain the device
+ * readings use: median, moving average, contact, settling, trimmed mean.
+ */
+class SignalPipeline {
+
+    public:
+        SignalPipeline();
+
+        static SignalPipeline standard(int sampleRate);
+
+        void addStage(std::unique_ptr<SignalStage>);
+        void setEstimator(std::unique_ptr<SignalEstimator>);
+
+        void push(const float*, int);
+        void reset();
+
+        bool isComplete() const;
+        int reading() const;
+        qint64 samplesIn() const { return pushed; }
+
+        QVector<StageTiming> getTimings() const { return timings; }
+        void resetTimings();
+
+        // Samples run through the stages at a time
+        static const int BLOCK_SIZE = 1024;
+
+    private:
+        std::vector<std::unique_ptr<SignalStage>> stages;
+        std::unique_ptr<SignalEstimator> estimator;
+        QVector<StageTiming> timings;
+        QVector<float> block;
+        qint64 pushed;
+
+        void run(float*, int);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file SignalStages.h
+ * @brief The stages a SignalPipeline reduces streamed samples with.
+ */
+
+#ifndef SIGNAL_STAGES_H
+#define SIGNAL_STAGES_H
+
+#include <QVector>
+
+/**
+ * @brief One step of a SignalPipeline. A stage works on a block of samples
+ * in place and may pass on fewer than it was given, compacted to the front.
+ * It carries whatever history it needs across blocks, so splitting a stream
+ * into blocks differently gives the same output.
+ */
+class SignalStage {
+
+    public:
+        virtual ~SignalStage() = default;
+
+        virtual const char* name() const = 0;
+        virtual int process(float* samples, int count) = 0;
+        virtual void reset() = 0;
+
+        // Whether the last process() call started the signal over, after
+        // which the stages behind this one are reset
+        virtual bool restarted() const { return false; }
+};
+
+/**
+ * @brief The last step of a SignalPipeline: collects samples and reduces
+ * them to one value once it has enough.
+ */
+class SignalEstimator {
+
+    public:
+        virtual ~SignalEstimator() = default;
+
+        virtual const char* name() const = 0;
+        virtual void add(const float* samples, int count) = 0;
+        virtual bool isComplete() const = 0;
+        virtual float estimate() const = 0;
+        virtual void reset() = 0;
+};
+
+/**
+ * @brief Running median over a small odd window; removes spikes from probe
+ * movement. Windows of 3 and 5 use branchless min/max networks that the
+ * compiler vectorizes.
+ */
+class MedianFilter : public SignalStage {
+
+    public:
+        explicit MedianFilter(int window = 5);
+
+        const char* name() const override { return "median"; }
+        int process(float*, int) override;
+        void reset() override;
+
+    private:
+        int window;
+        QVector<float> buffer;
+        bool primed;
+};
+
+/**
+ * @brief Running mean over a window; smooths the noise left by the median.
+ */
+class MovingAverageFilter : public SignalStage {
+
+    public:
+        explicit MovingAverageFilter(int window);
+
+        const char* name() const override { return "moving average"; }
+        int process(float*, int) override;
+        void reset() override;
+
+    private:
+        int window;
+        QVector<float> history;
+        int next;
+        int filled;
+        double sum;
+};
+
+/**
+ * @brief Passes samples only while the probe touches the skin: contact
+ * starts once the signal stays above a threshold for a hold time, and ends
+ * once it stays below half of it for as long. Losing contact restarts the
+ * signal.
+ */
+class ContactDetector : public SignalStage {
+
+    public:
+        ContactDetector(float threshold, int holdSamples);
+
+        const char* name() const override { return "contact"; }
+        int process(float*, int) override;
+        void reset() override;
+        bool restarted() const override { return lost; }
+
+    private:
+        float threshold;
+        int holdSamples;
+        bool inContact;
+        int run;
+        bool lost;
+};
+
+/**
+ * @brief Drops the rise after contact: passes samples once the means of the
+ * two halves of a sliding window have stayed within a tolerance of each
+ * other, relative to the level with an absolute floor.
+ */
+class SettlingDetector : public SignalStage {
+
+    public:
+        SettlingDetector(int window, float tolerance, float minTolerance);
+
+        const char* name() const override { return "settling"; }
+        int process(float*, int) override;
+        void reset() override;
+
+        bool isSettled() const { return settled; }
+
+    private:
+        int window;
+        float tolerance;
+        float minTolerance;
+        QVector<float> history;
+        int next;
+        int filled;
+        double olderSum;
+        double newerSum;
+        int stable;
+        bool settled;
+};
+
+/**
+ * @brief Mean of a fixed number of samples after trimming a fraction from
+ * each end, so a stray spike cannot move the reading.
+ */
+class TrimmedMeanEstimator : public SignalEstimator {
+
+    public:
+        TrimmedMeanEstimator(int samples, float trim = 0.2f);
+
+        const char* name() const override { return "trimmed mean"; }
+        void add(const float*, int) override;
+        bool isComplete() const override;
+        float estimate() const override;
+        void reset() override;
+
+    private:
+        int target;
+        float trim;
+        QVector<float> collected;
+};
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file SimulationClock.h
+ * @brief A virtual clock the simulation's timers run on.
+ */
+
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <functional>
+#include <memory>
+
+class ClockTimer;
+
+/**
+ * @brief The time a SimulationClock keeps: milliseconds that pass at some
+ * speed of real time, or not at all until set. Threads that pace themselves
+ * by the clock, such as a device stream's producer, hold a shared pointer
+ * to it, so it stays valid however the clock's owner is torn down.
+ */
+class VirtualTime {
+
+    public:
+        VirtualTime();
+
+        qint64 now() const;
+        double getSpeed() const;
+
+        void run(double speed);
+        void stop();
+        void skip(qint64 ms);
+        void set(qint64 ms);
+
+    private:
+        QElapsedTimer real;
+        qint64 base;
+        double speed;
+        mutable QMutex mutex;
+
+        qint64 nowLocked() const;
+};
+
+/**
+ * @brief Virtual time for the simulated device and measurement workflow.
+ * It runs in real time, accelerated by a factor, or only when stepped, so
+ * a battery drain or a full scan that takes minutes can run in
+ * milliseconds. Timers are created from the clock and behave like QTimers
+ * on virtual time; due timers fire in order of their due times. Use the
+ * clock from the thread it lives in; other threads read getTime().
+ */
+class SimulationClock : public QObject {
+    Q_OBJECT
+
+    public:
+        enum class Mode { RealTime, Accelerated, Stepped };
+
+        explicit SimulationClock(QObject* parent = nullptr);
+        ~SimulationClock();
+
+        void setRealTime();
+        void setAccelerated(double factor);
+        void setStepped();
+
+        Mode getMode() const { return mode; }
+        double getSpeed() const { return time->getSpeed(); }
+        qint64 now() const { return time->now(); }
+        std::shared_ptr<const VirtualTime> getTime() const { return time; }
+
+        void advance(qint64 ms);
+        bool advanceToNext();
+
+        ClockTimer* createTimer(QObject* parent);
+        void singleShot(int ms, QObject* context, std::function<void()>);
+
+    private:
+        friend class ClockTimer;
+
+        Mode mode;
+        std::shared_ptr<VirtualTime> time;
+        QTimer driver;
+        QList<ClockTimer*> timers;
+        QList<ClockTimer*> active;
+        quint64 sequence;
+        bool firing;
+
+        void schedule(ClockTimer*);
+        void unschedule(ClockTimer*);
+        ClockTimer* nextDue() const;
+        void fireUntil(qint64);
+        void rearm();
+};
+
+/**
+ * @brief A timer on a SimulationClock, with the QTimer calls the simulation
+ * uses. Periodic timers keep their phase: each interval counts from when
+ * the previous one was due, not from when it fired, so an accelerated clock
+ * never loses ticks.
+ */
+class ClockTimer : public QObject {
+    Q_OBJECT
+
+    public:
+        ~ClockTimer();
+
+        void setInterval(int ms) { interval = ms; }
+        int getInterval() const { return interval; }
+        void setSingleShot(bool single) { singleShot = single; }
+        bool isSingleShot() const { return singleShot; }
+        bool isActive() const { return activeFlag; }
+        int remainingTime() const;
+
+    public slots:
+        void start();
+        void start(int ms);
+        void stop();
+
+    signals:
+        void timeout();
+
+    private:
+        friend class SimulationClock;
+        ClockTimer(SimulationClock*, QObject*);
+
+        SimulationClock* clock;
+        int interval;
+        bool singleShot;
+        bool activeFlag;
+        qint64 due;
+        quint64 order;
+};
+
+#endif
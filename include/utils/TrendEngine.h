@@ -0,0 +1,62 @@
+/**
+ * @file TrendEngine.h
+ * @brief Least-squares indicator trends from running sums.
+ */
+
+#ifndef TREND_ENGINE_H
+#define TREND_ENGINE_H
+
+#include <QVector>
+
+#include "HealthMetricCalculator.h"
+#include "HealthMetricModel.h"
+
+/**
+ * @brief Running regression sums of the five indicators through one scan of
+ * a profile's history. Scans are numbered x = 1, 2, ... oldest first; with
+ * consecutive x the sums of x and x squared follow from n, so only the sums
+ * of y and x * y are kept. Values are in IndicatorColumn order.
+ */
+struct TrendPrefix {
+    static constexpr int INDICATORS = HealthMetricCalculator::INDICATOR_COUNT;
+
+    int n = 0;
+    float latest[INDICATORS] = {};
+    double sumY[INDICATORS] = {};
+    double sumXY[INDICATORS] = {};
+};
+
+/**
+ * @brief The least-squares fit of each indicator over a run of scans.
+ */
+struct TrendFit {
+    static constexpr int INDICATORS = TrendPrefix::INDICATORS;
+
+    int scans = 0;
+    float latest[INDICATORS] = {};
+    float slope[INDICATORS] = {};
+};
+
+/**
+ * @brief Fits indicator trends in O(1) from TrendPrefix sums. Appending a
+ * scan extends the sums without revisiting history, and the fit over the
+ * last W scans is taken from the prefixes through scans n and n - W.
+ */
+class TrendEngine {
+
+    public:
+        // Windows of recent scans; ALL_SCANS fits the whole history
+        static constexpr int ALL_SCANS = 0;
+        static constexpr int SHORT_WINDOW = 7;
+        static constexpr int MEDIUM_WINDOW = 30;
+        static constexpr int LONG_WINDOW = 90;
+
+        static TrendPrefix append(const TrendPrefix&, const Indicators&);
+        static QVector<TrendPrefix> prefixes(const IndicatorSeries&);
+        static int windowStart(int, int);
+        static TrendFit fit(const TrendPrefix&, const TrendPrefix&);
+        static void toHealthMetrics(const TrendFit&,
+                                    QVector<HealthMetricModel>&);
+};
+
+#endif
@@ -0,0 +1,7 @@
+-- Scan history is always read per profile, ordered by date
+CREATE INDEX IF NOT EXISTS idx_scan_profile_created
+    ON scan (profile_id, created_on, scan_id);
+
+-- Profiles are listed per user and looked up by (user_id, name)
+CREATE INDEX IF NOT EXISTS idx_profile_user_name
+    ON profile (user_id, name);
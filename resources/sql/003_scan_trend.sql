@@ -0,0 +1,25 @@
+-- Running least-squares sums of each indicator over a profile's history,
+-- one row per scan, oldest first. Row seq holds the sums through the
+-- seq-th scan (x = seq), so the trend over any run of recent scans is the
+-- difference of two rows.
+CREATE TABLE IF NOT EXISTS scan_trend (
+    profile_id	INTEGER NOT NULL,
+    seq	INTEGER NOT NULL,
+    scan_id	INTEGER NOT NULL,
+    energy	REAL NOT NULL,
+    immune	REAL NOT NULL,
+    metabolism	REAL NOT NULL,
+    psycho	REAL NOT NULL,
+    skeletal	REAL NOT NULL,
+    energy_sum	REAL NOT NULL,
+    immune_sum	REAL NOT NULL,
+    metabolism_sum	REAL NOT NULL,
+    psycho_sum	REAL NOT NULL,
+    skeletal_sum	REAL NOT NULL,
+    energy_xsum	REAL NOT NULL,
+    immune_xsum	REAL NOT NULL,
+    metabolism_xsum	REAL NOT NULL,
+    psycho_xsum	REAL NOT NULL,
+    skeletal_xsum	REAL NOT NULL,
+    PRIMARY KEY(profile_id, seq)
+) WITHOUT ROWID;
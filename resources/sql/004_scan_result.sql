@@ -0,0 +1,9 @@
+-- Organ and indicator results per scan, keyed by the calculator version that
+-- produced them. metrics packs each result as a float32 value and an int8
+-- level, organs first, in HealthMetric id order.
+CREATE TABLE IF NOT EXISTS scan_result (
+    scan_id	INTEGER NOT NULL,
+    version	INTEGER NOT NULL,
+    metrics	BLOB NOT NULL,
+    PRIMARY KEY(scan_id, version)
+) WITHOUT ROWID;
@@ -0,0 +1,29 @@
+-- Aggregates of each profile's scans, kept up to date by ScanController as
+-- scans are inserted and deleted. The *_sum columns add up each organ's
+-- value (the mean of its left and right readings) over every scan, and the
+-- indicator columns are those of the newest scan.
+CREATE TABLE IF NOT EXISTS profile_summary (
+    profile_id	INTEGER NOT NULL,
+    scan_count	INTEGER NOT NULL,
+    first_scan_on	DATE,
+    last_scan_on	DATE,
+    last_scan_id	INTEGER NOT NULL,
+    energy	REAL NOT NULL,
+    immune	REAL NOT NULL,
+    metabolism	REAL NOT NULL,
+    psycho	REAL NOT NULL,
+    skeletal	REAL NOT NULL,
+    lung_sum	REAL NOT NULL,
+    heart_constrictor_sum	REAL NOT NULL,
+    heart_sum	REAL NOT NULL,
+    small_intestine_sum	REAL NOT NULL,
+    triple_heater_sum	REAL NOT NULL,
+    large_intestine_sum	REAL NOT NULL,
+    spleen_sum	REAL NOT NULL,
+    liver_sum	REAL NOT NULL,
+    kidney_sum	REAL NOT NULL,
+    urinary_bladder_sum	REAL NOT NULL,
+    gall_bladder_sum	REAL NOT NULL,
+    stomach_sum	REAL NOT NULL,
+    PRIMARY KEY(profile_id)
+) WITHOUT ROWID;
@@ -0,0 +1,9 @@
+-- Population quantile sketches (t-digests), one per meridian point and one
+-- per indicator. Every row covers the scans up to and including
+-- last_scan_id, and digest is QuantileSketch::toBytes().
+CREATE TABLE IF NOT EXISTS population_sketch (
+    sketch_id	INTEGER NOT NULL,
+    last_scan_id	INTEGER NOT NULL,
+    digest	BLOB NOT NULL,
+    PRIMARY KEY(sketch_id)
+) WITHOUT ROWID;
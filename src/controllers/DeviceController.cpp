@@ -7,31 +7,63 @@
 
 #include <QDebug>
 #include <QRandomGenerator>
+#include <algorithm>
+#include <chrono>
 
 #include "Logging.h"
 
-DeviceController::DeviceController(QObject *parent)
+namespace {
+
+// Samples the producer generates and pushes at a time
+const int PRODUCER_BLOCK = 256;
+
+// How long the producer sleeps between catching up with the sample clock
+const std::chrono::milliseconds PRODUCER_TICK(1);
+
+// Longest sleep of a real-time replay, so stopping it stays responsive
+const std::chrono::milliseconds REPLAY_TICK(10);
+
+// Samples buffered for the consumer of a replay
+const int REPLAY_RING_CAPACITY = 65536;
+
+}  // namespace
+
+DeviceController::DeviceController(QObject *parent, SimulationClock *clock)
     : QObject(parent),
       deviceOn(false),
       batteryLevel(100),
       charging(false),
       connected(false),
+      clock(clock ? clock : new SimulationClock(this)),
       powerChargeRate(1),
-      powerConsumptionRate(1) {
+      powerConsumptionRate(1),
+      streaming(false),
+      notifyPending(false),
+      produced(0),
+      dropped(0),
+      consumed(0),
+      highWater(0),
+      replaying(false) {
     // Initialize the battery timer
-    batteryTimer = new QTimer(this);
-    connect(batteryTimer, &QTimer::timeout, this,
+    batteryTimer = this->clock->createTimer(this);
+    connect(batteryTimer, &ClockTimer::timeout, this,
             &DeviceController::updateBatteryLevel);
     batteryTimer->start(1000);
 
     // Initialize the connection timer
-    connectionTimer = new QTimer(this);
+    connectionTimer = this->clock->createTimer(this);
     connectionTimer->setSingleShot(true);
-    connect(connectionTimer, &QTimer::timeout, this,
+    connect(connectionTimer, &ClockTimer::timeout, this,
             &DeviceController::onConnectionTimerTimeout);
 }
 
+DeviceController::~DeviceController() { stopStream(); }
+
 void DeviceController::setDeviceOn(bool isOn) {
+    if (replaying) {
+        DEBUG("Ignoring power change during a replay");
+        return;
+    }
     if (isOn && batteryLevel <= 0) {
         DEBUG("Cannot turn on device. Battery is depleted.");
         return;
@@ -40,13 +72,16 @@ void DeviceController::setDeviceOn(bool isOn) {
     // Otherwise continue with operation
     if (deviceOn != isOn) {
         deviceOn = isOn;
+        recorder.write(TraceRecord::Power, deviceOn);
         emit deviceStateChanged(deviceOn);
         if (deviceOn) {
             DEBUG("Starting connection");
             startConnection();
         } else {
             DEBUG("Stopping connection");
+            stopStream();
             connected = false;
+            recorder.write(TraceRecord::Connection, connected);
             emit connectionStatusChanged(connected);
         }
     }
@@ -56,6 +91,7 @@ void DeviceController::startCharging() {
     if (!charging) {
         INFO("Charging started");
         charging = true;
+        recorder.write(TraceRecord::Charging, charging);
         emit chargingStateChanged(charging);
     } else {
         ERROR("Charging already started");
@@ -66,6 +102,7 @@ void DeviceController::stopCharging() {
     if (charging) {
         INFO("Charging stopped");
         charging = false;
+        recorder.write(TraceRecord::Charging, charging);
         emit chargingStateChanged(charging);
     } else {
         ERROR("Charging already stopped");
@@ -73,12 +110,17 @@ void DeviceController::stopCharging() {
 }
 
 void DeviceController::onConnectionTimerTimeout() {
+    if (replaying) return;
     connected = true;
     DEBUG("Connected");
+    recorder.write(TraceRecord::Connection, connected);
     emit connectionStatusChanged(connected);
 }
 
 void DeviceController::updateBatteryLevel() {
+    // A replay sets the battery level from its trace
+    if (replaying) return;
+
     if (charging) {
         if (batteryLevel < 100) {
             batteryLevel += powerChargeRate;
@@ -105,10 +147,237 @@ void DeviceController::updateBatteryLevel() {
     } else {
         DEBUG("Device is off");
     }
+    recorder.write(TraceRecord::Battery, batteryLevel);
     emit batteryLevelChanged(batteryLevel);
 }
 
 // TODO: Verify data is in correct range
 void DeviceController::transmitData() {
-    emit dataReceived(QRandomGenerator::global()->bounded(75, 125));
+    const int data = QRandomGenerator::global()->bounded(75, 125);
+    recorder.write(TraceRecord::Data, data);
+    emit dataReceived(data);
+}
+
+bool DeviceController::startStream(int point, const StreamConfig &config) {
+    if (!deviceOn) {
+        ERROR("Cannot stream. Device is off.");
+        return false;
+    }
+    if (replaying) {
+        ERROR("Cannot stream during a replay.");
+        return false;
+    }
+    stopStream();
+
+    StreamConfig resolved = config;
+    resolved.sampleRate =
+        std::min(std::max(config.sampleRate, MIN_SAMPLE_RATE), MAX_SAMPLE_RATE);
+    if (resolved.seed == 0)
+        resolved.seed = QRandomGenerator::global()->generate();
+    if (resolved.shape.plateau <= 0)
+        resolved.shape.plateau = QRandomGenerator::global()->bounded(75, 125);
+
+    resetRing(resolved.ringCapacity);
+    DEBUG("Streaming point " << point << " at " << resolved.sampleRate
+                             << " Hz");
+    recorder.write(TraceRecord::StreamStart, point, resolved.sampleRate);
+    streaming = true;
+    producer = std::thread(&DeviceController::produce, this, point, resolved,
+                           clock->getTime());
+    return true;
+}
+
+bool DeviceController::startReplay(const QString &path, ReplaySpeed speed) {
+    stopStream();
+
+    std::unique_ptr<TraceReader> reader(new TraceReader());
+    if (!reader->open(path)) {
+        ERROR("Cannot replay " << path);
+        return false;
+    }
+    replayReader = std::move(reader);
+
+    resetRing(REPLAY_RING_CAPACITY);
+    DEBUG("Replaying " << path);
+    replaying = true;
+    streaming = true;
+    producer = std::thread(&DeviceController::replay, this, speed);
+    return true;
+}
+
+void DeviceController::stopStream() {
+    const bool live = producer.joinable() && !replayReader;
+    streaming = false;
+    if (producer.joinable()) {
+        producer.join();
+        DEBUG("Stream stopped: " << produced.load() << " samples, "
+                                 << dropped.load() << " dropped");
+    }
+    if (live) recorder.write(TraceRecord::StreamStop);
+    replaying = false;
+    replayReader.reset();
+}
+
+int DeviceController::readSamples(DeviceSample *samples, int max) {
+    if (!ring) return 0;
+
+    // Cleared before reading, so samples pushed after the read notify again
+    notifyPending = false;
+    const int count = ring->pop(samples, max);
+    consumed += count;
+    return count;
+}
+
+StreamStats DeviceController::getStreamStats() const {
+    StreamStats stats;
+    stats.produced = produced;
+    stats.dropped = dropped;
+    stats.consumed = consumed;
+    stats.highWater = highWater;
+    stats.capacity = ring ? ring->capacity() : 0;
+    return stats;
+}
+
+void DeviceController::resetRing(int capacity) {
+    ring.reset(new SampleRing<DeviceSample>(capacity));
+    produced = 0;
+    dropped = 0;
+    consumed = 0;
+    highWater = 0;
+    notifyPending = false;
+}
+
+/**
+ * @brief Pushes samples into the ring from the producer thread, counting
+ * them, and notifies the consumer if the ring was empty.
+ * @param wait Whether to wait for room instead of dropping what does not
+ * fit.
+ */
+void DeviceController::pushSamples(const DeviceSample *samples, int count,
+                                   bool wait) {
+    int pushed = ring->push(samples, count);
+    while (wait && pushed < count && streaming) {
+        if (!notifyPending.exchange(true)) emit samplesAvailable();
+        std::this_thread::yield();
+        pushed += ring->push(samples + pushed, count - pushed);
+    }
+    produced += count;
+    dropped += count - pushed;
+
+    const int waiting = ring->size();
+    if (waiting > highWater) highWater = waiting;
+    if (pushed > 0 && !notifyPending.exchange(true)) emit samplesAvailable();
+}
+
+/**
+ * @brief Producer thread: wakes every tick and pushes every sample that is
+ * due by the simulation clock, so the stream keeps its rate however the
+ * sleeps jitter, and speeds up or stands still with the clock. Timestamps
+ * are the sample clock's, not the wake-up times.
+ */
+void DeviceController::produce(int point, StreamConfig config,
+                               std::shared_ptr<const VirtualTime> time) {
+    ConductanceWaveform waveform(config.shape, config.sampleRate, config.seed);
+    const qint64 period = 1000000000LL / config.sampleRate;
+    const qint64 start = time->now();
+    float values[PRODUCER_BLOCK];
+    DeviceSample block[PRODUCER_BLOCK];
+
+    qint64 index = 0;
+    while (streaming) {
+        const qint64 elapsed = (time->now() - start) * 1000000;
+        const qint64 due = elapsed / period + 1;
+
+        while (index < due) {
+            const int count =
+                static_cast<int>(std::min<qint64>(PRODUCER_BLOCK, due - index));
+            waveform.generate(values, count);
+            for (int i = 0; i < count; ++i)
+                block[i] = {(index + i) * period, values[i], point};
+            recorder.writeSamples(point, block[0].timestamp, values, count);
+            index += count;
+            pushSamples(block, count, false);
+        }
+        std::this_thread::sleep_for(PRODUCER_TICK);
+    }
+}
+
+/**
+ * @brief Replay thread: reads the trace, pushes its samples into the ring
+ * and hands every other event to the controller's thread. In real time,
+ * each event waits until as long after the start as it was recorded.
+ */
+void DeviceController::replay(ReplaySpeed speed) {
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point start = Clock::now();
+    qint64 period = 1000000000LL / MIN_SAMPLE_RATE;
+    QVector<DeviceSample> block;
+    TraceEvent event;
+    while (streaming && replayReader->next(event)) {
+        if (speed == ReplaySpeed::RealTime) {
+            const Clock::time_point due =
+                start + std::chrono::microseconds(event.time);
+            while (streaming && Clock::now() < due)
+                std::this_thread::sleep_until(
+                    std::min(due, Clock::now() + REPLAY_TICK));
+        }
+
+        switch (event.type) {
+            case TraceRecord::StreamStart:
+                period = 1000000000LL / std::max(event.sampleRate, 1);
+                break;
+            case TraceRecord::Samples:
+                block.resize(event.samples.size());
+                for (int i = 0; i < block.size(); ++i)
+                    block[i] = {event.timestamp + i * period, event.samples[i],
+                                event.value};
+                pushSamples(block.constData(), block.size(),
+                            speed == ReplaySpeed::Maximum);
+                break;
+            case TraceRecord::StreamStop:
+                break;
+            default:
+                QMetaObject::invokeMethod(
+                    this, [this, event]() { applyEvent(event); },
+                    Qt::QueuedConnection);
+                break;
+        }
+    }
+
+    DEBUG("Replay finished: " << produced.load() << " samples, "
+                              << dropped.load() << " dropped");
+    const bool finished = streaming;
+    streaming = false;
+    replaying = false;
+    if (finished) emit replayFinished();
+}
+
+/**
+ * @brief Applies a replayed state event on the controller's thread.
+ */
+void DeviceController::applyEvent(const TraceEvent &event) {
+    switch (event.type) {
+        case TraceRecord::Power:
+            deviceOn = event.value != 0;
+            emit deviceStateChanged(deviceOn);
+            break;
+        case TraceRecord::Connection:
+            connected = event.value != 0;
+            emit connectionStatusChanged(connected);
+            break;
+        case TraceRecord::Charging:
+            charging = event.value != 0;
+            emit chargingStateChanged(charging);
+            break;
+        case TraceRecord::Battery:
+            batteryLevel = event.value;
+            emit batteryLevelChanged(batteryLevel);
+            break;
+        case TraceRecord::Data:
+            emit dataReceived(event.value);
+            break;
+        default:
+            break;
+    }
 }
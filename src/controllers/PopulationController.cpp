@@ -0,0 +1,212 @@
+/**
+ * @file PopulationController.cpp
+ * @brief Maintains population quantile sketches and places scans in them.
+ */
+
+#include "PopulationController.h"
+
+#include <QMutexLocker>
+
+#include "UserProfileController.h"
+
+namespace {
+
+const QString NEW_SCANS_QUERY = "SELECT " SCAN_BATCH_COLUMNS
+                                " FROM scan WHERE scan_id > ?"
+                                " ORDER BY scan_id LIMIT ?;";
+
+const QString SAVE_SKETCH_QUERY =
+    "INSERT OR REPLACE INTO population_sketch "
+    "(sketch_id, last_scan_id, digest) VALUES (?, ?, ?);";
+
+}  // namespace
+
+PopulationController::PopulationController(DatabaseManager& db)
+    : db(db), sketches(PopulationSketch::Count), lastScanId(-1) {}
+
+/**
+ * @brief Places a scan in the population, after catching the sketches up
+ * with any newly stored scans. Each percentile is a walk over one sketch's
+ * few hundred centroids.
+ * @param scan the scan, stored or not
+ * @param percentiles output parameter
+ * @return true if the operation was successful
+ */
+bool PopulationController::getPercentiles(ScanModel& scan,
+                                          PopulationPercentiles& percentiles) {
+    QMutexLocker locker(&mutex);
+    try {
+        db.transaction([this]() { update(); });
+    } catch (const std::exception& e) {
+        percentiles = PopulationPercentiles();
+        qCritical() << "Failed to get population percentiles: " << e.what();
+        return false;
+    }
+
+    using namespace PopulationSketch;
+    const Measurements& readings = scan.getMeasurements();
+    percentiles.population = static_cast<int>(sketches[FirstPoint].count());
+    for (int point = 0; point < MeridianPoint::Count; ++point)
+        percentiles.points[point] =
+            100 * sketches[FirstPoint + point].cdf(readings[point]);
+
+    const Indicators indicators = calculator.calculateIndicators(&scan);
+    const float values[HealthMetricCalculator::INDICATOR_COUNT] = {
+        indicators.energy, indicators.immune, indicators.metabolism,
+        indicators.psycho, indicators.skeletal};
+    for (int k = 0; k < HealthMetricCalculator::INDICATOR_COUNT; ++k)
+        percentiles.indicators[k] =
+            100 * sketches[FirstIndicator + k].cdf(values[k]);
+    return true;
+}
+
+/**
+ * @brief Gets a copy of one population sketch, caught up with every stored
+ * scan.
+ * @param sketchId a PopulationSketch id
+ * @param sketch output parameter
+ * @return true if the operation was successful
+ */
+bool PopulationController::getSketch(int sketchId, QuantileSketch& sketch) {
+    if (sketchId < 0 || sketchId >= PopulationSketch::Count) return false;
+
+    QMutexLocker locker(&mutex);
+    try {
+        db.transaction([this]() { update(); });
+        sketch = sketches[sketchId];
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to get population sketch: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Rebuilds every sketch from the scans currently stored, dropping
+ * deleted ones.
+ * @return true if the operation was successful
+ */
+bool PopulationController::rebuildSketches() {
+    QMutexLocker locker(&mutex);
+    try {
+        db.transaction([this]() {
+            db.execute("DELETE FROM population_sketch;", {});
+            load();
+            update();
+        });
+        return true;
+    } catch (const std::exception& e) {
+        lastScanId = -1;
+        qCritical() << "Failed to rebuild population sketches: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Adds every scan stored since the sketches were last saved, and
+ * saves them. Throws on database errors; run it in the inserting
+ * transaction.
+ */
+void PopulationController::catchUp() {
+    QMutexLocker locker(&mutex);
+    update();
+}
+
+/**
+ * @brief Implements catchUp() with the mutex held. If another controller
+ * saved the sketches since this one last did, or a transaction that saved
+ * them was rolled back, they are reloaded first.
+ */
+void PopulationController::update() {
+    int storedScanId = 0;
+    db.queryEach(
+        "SELECT last_scan_id FROM population_sketch WHERE sketch_id = 0;", {},
+        [&storedScanId](const QSqlQuery& row) {
+            storedScanId = row.value(0).toInt();
+        });
+    if (storedScanId != lastScanId) load();
+
+    bool added = false;
+    ScanBatch batch;
+    Measurements readings;
+    do {
+        batch.clear();
+        db.queryEach(NEW_SCANS_QUERY, {lastScanId, CATCH_UP_CHUNK},
+                     [&batch, &readings](const QSqlQuery& row) {
+                         for (int point = 0; point < MeridianPoint::Count;
+                              ++point)
+                             readings[point] = row.value(2 + point).toInt();
+                         batch.append(row.value(0).toInt(),
+                                      row.value(1).toDate(), readings);
+                     });
+        if (batch.isEmpty()) break;
+
+        addBatch(batch);
+        lastScanId = batch.getIds().last();
+        added = true;
+    } while (batch.size() == CATCH_UP_CHUNK);
+
+    if (added) save();
+}
+
+/**
+ * @brief Replaces the in-memory sketches with the stored ones, or with empty
+ * ones if none are stored. Throws on database errors.
+ */
+void PopulationController::load() {
+    QVector<QuantileSketch> loaded(PopulationSketch::Count);
+    int loadedScanId = 0;
+    db.queryEach(
+        "SELECT sketch_id, last_scan_id, digest FROM population_sketch "
+        "WHERE sketch_id >= 0 AND sketch_id < ?;",
+        {PopulationSketch::Count},
+        [&loaded, &loadedScanId](const QSqlQuery& row) {
+            const int sketchId = row.value(0).toInt();
+            if (!QuantileSketch::fromBytes(row.value(2).toByteArray(),
+                                           loaded[sketchId]))
+                throw std::runtime_error("Corrupt population sketch " +
+                                         std::to_string(sketchId));
+            if (sketchId == 0) loadedScanId = row.value(1).toInt();
+        });
+
+    sketches = loaded;
+    lastScanId = loadedScanId;
+}
+
+/**
+ * @brief Writes every sketch with the newest scan id it includes. Throws on
+ * database errors.
+ */
+void PopulationController::save() {
+    QList<QList<QVariant>> paramSets;
+    for (int sketchId = 0; sketchId < PopulationSketch::Count; ++sketchId)
+        paramSets.append(
+            {sketchId, lastScanId, sketches[sketchId].toBytes()});
+    db.executeBatch(SAVE_SKETCH_QUERY, paramSets);
+}
+
+/**
+ * @brief Adds a batch of scans' readings and indicators to the sketches.
+ */
+void PopulationController::addBatch(const ScanBatch& batch) {
+    using namespace PopulationSketch;
+    for (int point = 0; point < MeridianPoint::Count; ++point) {
+        const int16_t* column = batch.column(point);
+        QuantileSketch& sketch = sketches[FirstPoint + point];
+        for (int row = 0; row < batch.size(); ++row) sketch.add(column[row]);
+        sketch.flush();
+    }
+
+    IndicatorSeries series;
+    if (!calculator.calculateIndicatorSeries(batch, series))
+        throw std::runtime_error("Could not calculate indicators");
+
+    const QVector<float>* columns[HealthMetricCalculator::INDICATOR_COUNT] = {
+        &series.energy, &series.immune, &series.metabolism, &series.psycho,
+        &series.skeletal};
+    for (int k = 0; k < HealthMetricCalculator::INDICATOR_COUNT; ++k) {
+        QuantileSketch& sketch = sketches[FirstIndicator + k];
+        for (float value : *columns[k]) sketch.add(value);
+        sketch.flush();
+    }
+}
@@ -0,0 +1,267 @@
+/**
+ * @file ProfileSummaryController.cpp
+ * @brief Maintains per-profile scan aggregates and reads them back.
+ */
+
+#include "ProfileSummaryController.h"
+
+#include "UserProfileController.h"
+
+namespace {
+
+const QString SUMMARY_AT_QUERY = "SELECT " SUMMARY_COLUMNS
+                                 " FROM profile_summary WHERE profile_id = ?;";
+
+const QString SAVE_SUMMARY_QUERY =
+    "INSERT OR REPLACE INTO profile_summary (profile_id, " SUMMARY_COLUMNS
+    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+    "?);";
+
+const QString OLDEST_SCAN_QUERY =
+    "SELECT created_on FROM scan WHERE profile_id = ? "
+    "ORDER BY created_on, scan_id LIMIT 1;";
+
+const QString NEWEST_SCAN_QUERY =
+    "SELECT " SCAN_SELECT_COLUMNS
+    " FROM scan WHERE profile_id = ? "
+    "ORDER BY created_on DESC, scan_id DESC LIMIT 1;";
+
+QVariant dateParam(const QDate& date) {
+    return date.isValid() ? QVariant(date) : QVariant();
+}
+
+}  // namespace
+
+ProfileSummaryController::ProfileSummaryController(DatabaseManager& db)
+    : db(db) {}
+
+/**
+ * @brief Gets a profile's aggregates with a single row read. A profile
+ * without a summary yet, such as one from before profile_summary existed,
+ * has it built from its scans first.
+ * @param profileId the profile id
+ * @param summary output parameter
+ * @return true if the operation was successful
+ */
+bool ProfileSummaryController::getSummary(int profileId,
+                                          ProfileSummary& summary) {
+    try {
+        if (summaryAt(profileId, summary)) return true;
+
+        db.transaction([this, profileId, &summary]() {
+            rebuild(profileId);
+            summaryAt(profileId, summary);
+        });
+        return true;
+    } catch (const std::exception& e) {
+        summary = ProfileSummary();
+        qCritical() << "Failed to get profile summary: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Recomputes a profile's aggregates from its scans.
+ * @param profileId the profile id
+ * @return true if the operation was successful
+ */
+bool ProfileSummaryController::rebuildSummary(int profileId) {
+    try {
+        db.transaction([this, profileId]() { rebuild(profileId); });
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to rebuild profile summary: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Adds a newly inserted scan to its profile's aggregates in O(1).
+ * If the summary is missing or did not end at the scan that was newest
+ * before the insert, it is rebuilt instead. Throws on database errors; run
+ * it in the inserting transaction.
+ * @param scan the inserted scan, with its id set
+ * @param previousNewestId the profile's newest scan id from before the
+ * insert, or -1
+ */
+void ProfileSummaryController::addScan(ScanModel& scan, int previousNewestId) {
+    const int profileId = scan.getProfileId();
+
+    ProfileSummary summary;
+    if (!summaryAt(profileId, summary) ||
+        summary.lastScanId != previousNewestId) {
+        rebuild(profileId);
+        return;
+    }
+
+    // The insert leaves the date to the column default
+    QDate createdOn;
+    db.queryEach("SELECT created_on FROM scan WHERE scan_id = ?;",
+                 {scan.getId()}, [&createdOn](const QSqlQuery& row) {
+                     createdOn = row.value(0).toDate();
+                 });
+
+    ++summary.scanCount;
+    addOrgans(summary, scan.getMeasurements(), 1);
+    if (!summary.firstScanOn.isValid() || createdOn < summary.firstScanOn)
+        summary.firstScanOn = createdOn;
+
+    // Ties on the date go to the larger id, which the new scan has
+    if (!summary.lastScanOn.isValid() || createdOn >= summary.lastScanOn) {
+        summary.lastScanOn = createdOn;
+        setLatest(summary, scan);
+    }
+    saveSummary(profileId, summary);
+}
+
+/**
+ * @brief Takes a deleted scan out of its profile's aggregates. The oldest or
+ * newest scan is looked up again only if the deleted scan was one of them.
+ * Throws on database errors; run it in the deleting transaction, after the
+ * delete.
+ * @param scan the deleted scan, as it was stored
+ * @param previousNewestId the profile's newest scan id from before the
+ * delete
+ */
+void ProfileSummaryController::removeScan(const ScanModel& scan,
+                                          int previousNewestId) {
+    const int profileId = scan.getProfileId();
+
+    ProfileSummary summary;
+    if (!summaryAt(profileId, summary) ||
+        summary.lastScanId != previousNewestId || summary.scanCount <= 1) {
+        rebuild(profileId);
+        return;
+    }
+
+    --summary.scanCount;
+    addOrgans(summary, scan.getMeasurements(), -1);
+    if (scan.getCreatedOn() == summary.firstScanOn)
+        refreshOldest(profileId, summary);
+    if (scan.getId() == summary.lastScanId) refreshNewest(profileId, summary);
+    saveSummary(profileId, summary);
+}
+
+/**
+ * @brief Replaces a profile's aggregates with ones computed from all of its
+ * scans. Throws on database errors.
+ * @param profileId the profile id
+ */
+void ProfileSummaryController::rebuild(int profileId) {
+    qDebug() << "Rebuilding summary for profile" << profileId;
+
+    ScanBatch batch;
+    if (!UserProfileController(db).getProfileScanBatch(profileId, batch))
+        throw std::runtime_error("Could not load scans");
+
+    ProfileSummary summary;
+    summary.scanCount = batch.size();
+    for (int organ = 0; organ < HealthMetricCalculator::ORGAN_COUNT; ++organ) {
+        const int16_t* left = batch.column(2 * organ);
+        const int16_t* right = batch.column(2 * organ + 1);
+        double sum = 0;
+        for (int row = 0; row < batch.size(); ++row)
+            sum += (left[row] + right[row]) / 2.0f;
+        summary.organSums[organ] = sum;
+    }
+
+    if (!batch.isEmpty()) {
+        const int newest = batch.size() - 1;
+        summary.firstScanOn = batch.getCreatedOn().first();
+        summary.lastScanOn = batch.getCreatedOn()[newest];
+
+        ScanModel scan;
+        scan.setId(batch.getIds()[newest]);
+        scan.setMeasurements(batch.readingsAt(newest));
+        setLatest(summary, scan);
+    }
+    saveSummary(profileId, summary);
+}
+
+/**
+ * @brief Reads a profile's summary row. Throws on database errors.
+ * @param profileId the profile id
+ * @param summary output parameter, left empty if there is no row
+ * @return true if the row exists
+ */
+bool ProfileSummaryController::summaryAt(int profileId,
+                                         ProfileSummary& summary) {
+    summary = ProfileSummary();
+    const int rows = db.queryEach(
+        SUMMARY_AT_QUERY, {profileId}, [&summary](const QSqlQuery& row) {
+            using namespace SummaryColumn;
+            summary.scanCount = row.value(ScanCount).toInt();
+            summary.firstScanOn = row.value(FirstScanOn).toDate();
+            summary.lastScanOn = row.value(LastScanOn).toDate();
+            summary.lastScanId = row.value(LastScanId).toInt();
+            for (int k = 0; k < HealthMetricCalculator::INDICATOR_COUNT; ++k)
+                summary.latest[k] = row.value(Latest + k).toFloat();
+            for (int k = 0; k < HealthMetricCalculator::ORGAN_COUNT; ++k)
+                summary.organSums[k] = row.value(OrganSums + k).toDouble();
+        });
+    return rows > 0;
+}
+
+void ProfileSummaryController::saveSummary(int profileId,
+                                           const ProfileSummary& summary) {
+    db.execute(SAVE_SUMMARY_QUERY, summaryParams(profileId, summary));
+}
+
+void ProfileSummaryController::refreshOldest(int profileId,
+                                             ProfileSummary& summary) {
+    db.queryEach(OLDEST_SCAN_QUERY, {profileId},
+                 [&summary](const QSqlQuery& row) {
+                     summary.firstScanOn = row.value(0).toDate();
+                 });
+}
+
+void ProfileSummaryController::refreshNewest(int profileId,
+                                             ProfileSummary& summary) {
+    ScanModel scan;
+    db.queryEach(NEWEST_SCAN_QUERY, {profileId}, [&scan](const QSqlQuery& row) {
+        scan = UserProfileController::scanFromRow(row);
+    });
+    summary.lastScanOn = scan.getCreatedOn();
+    setLatest(summary, scan);
+}
+
+/**
+ * @brief Makes a scan the summary's newest: records its id and indicators.
+ */
+void ProfileSummaryController::setLatest(ProfileSummary& summary,
+                                         ScanModel& scan) {
+    const Indicators indicators = calculator.calculateIndicators(&scan);
+    summary.lastScanId = scan.getId();
+    summary.latest[HealthMetricCalculator::Energy] = indicators.energy;
+    summary.latest[HealthMetricCalculator::Immune] = indicators.immune;
+    summary.latest[HealthMetricCalculator::Metabolism] = indicators.metabolism;
+    summary.latest[HealthMetricCalculator::Psycho] = indicators.psycho;
+    summary.latest[HealthMetricCalculator::Skeletal] = indicators.skeletal;
+}
+
+/**
+ * @brief Adds (sign 1) or subtracts (sign -1) one scan's organ values.
+ */
+void ProfileSummaryController::addOrgans(ProfileSummary& summary,
+                                         const Measurements& readings,
+                                         int sign) {
+    for (int organ = 0; organ < HealthMetricCalculator::ORGAN_COUNT; ++organ) {
+        const float value =
+            (readings[2 * organ] + readings[2 * organ + 1]) / 2.0f;
+        summary.organSums[organ] += sign * value;
+    }
+}
+
+/**
+ * @brief Builds the positional parameters for SAVE_SUMMARY_QUERY.
+ */
+QList<QVariant> ProfileSummaryController::summaryParams(
+    int profileId, const ProfileSummary& summary) {
+    QList<QVariant> params = {profileId, summary.scanCount,
+                              dateParam(summary.firstScanOn),
+                              dateParam(summary.lastScanOn),
+                              summary.lastScanId};
+    for (float value : summary.latest) params.append(double(value));
+    for (double sum : summary.organSums) params.append(sum);
+    return params;
+}
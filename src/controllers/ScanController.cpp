@@ -5,9 +5,34 @@
 
 #include "ScanController.h"
 
+#include <QElapsedTimer>
 #include <QRandomGenerator>
+#include <QSet>
 
-ScanController::ScanController(DatabaseManager& db_) : db(db_) {}
+#include "UserProfileController.h"
+
+const QString ScanController::INSERT_SCAN_QUERY =
+    "INSERT INTO scan (profile_id, name, h1_lung, h1_lung_r, "
+    "h2_heart_constrictor, h2_heart_constrictor_r, "
+    "h3_heart, h3_heart_r, h4_small_intestine, h4_small_intestine_r, "
+    "h5_triple_heater, h5_triple_heater_r, "
+    "h6_large_intestine, h6_large_intestine_r, f1_spleen, f1_spleen_r, "
+    "f2_liver, f2_liver_r, f3_kidney, "
+    "f3_kidney_r, f4_urinary_bladder, f4_urinary_bladder_r, "
+    "f5_gall_bladder, f5_gall_bladder_r, f6_stomach, "
+    "f6_stomach_r, body_temp, blood_pressure, heart_rate, "
+    "sleeping_time, current_weight, emotional_state, "
+    "overall_feeling) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, "
+    "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+    "?, ?)";
+
+ScanController::ScanController(DatabaseManager& db_)
+    : db(db_),
+      trends(db_),
+      results(db_),
+      summaries(db_),
+      population(db_),
+      lastBatchRowsPerSecond(0) {}
 
 void ScanController::createScan(const QVector<int>& measurements,
                                 ProfileModel& profile) {
@@ -54,58 +79,164 @@ int ScanController::generateMeasurement(int range_start, int range_end) {
     return QRandomGenerator::global()->bounded(range_start, range_end);
 }
 
+/**
+ * @brief Stores a scan, extends its profile's trend sums and summary and the
+ * population sketches, and stores its results, in one transaction.
+ * @param scan the scan to insert; its id is set to the new scan id
+ * @return true if the scan was stored
+ */
 bool ScanController::storeScan(ScanModel& scan) {
     try {
-        db.execute(
-            "INSERT INTO scan (profile_id, name, h1_lung, h1_lung_r, "
-            "h2_heart_constrictor, h2_heart_constrictor_r, "
-            "h3_heart, h3_heart_r, h4_small_intestine, h4_small_intestine_r, "
-            "h5_triple_heater, h5_triple_heater_r, "
-            "h6_large_intestine, h6_large_intestine_r, f1_spleen, f1_spleen_r, "
-            "f2_liver, f2_liver_r, f3_kidney, "
-            "f3_kidney_r, f4_urinary_bladder, f4_urinary_bladder_r, "
-            "f5_gall_bladder, f5_gall_bladder_r, f6_stomach, "
-            "f6_stomach_r, body_temp, blood_pressure, heart_rate, "
-            "sleeping_time, current_weight, emotional_state, "
-            "overall_feeling) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, "
-            "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-            "?, ?)",
-            {scan.getProfileId(),
-             scan.getName(),
-             scan.getH1Lung(),
-             scan.getH1LungR(),
-             scan.getH2HeartConstrictor(),
-             scan.getH2HeartConstrictorR(),
-             scan.getH3Heart(),
-             scan.getH3HeartR(),
-             scan.getH4SmallIntestine(),
-             scan.getH4SmallIntestineR(),
-             scan.getH5TripleHeater(),
-             scan.getH5TripleHeaterR(),
-             scan.getH6LargeIntestine(),
-             scan.getH6LargeIntestineR(),
-             scan.getF1Spleen(),
-             scan.getF1SpleenR(),
-             scan.getF2Liver(),
-             scan.getF2LiverR(),
-             scan.getF3Kidney(),
-             scan.getF3KidneyR(),
-             scan.getF4UrinaryBladder(),
-             scan.getF4UrinaryBladderR(),
-             scan.getF5GallBladder(),
-             scan.getF5GallBladderR(),
-             scan.getF6Stomach(),
-             scan.getF6StomachR(),
-             scan.getBodyTemp(),
-             scan.getBloodPressure(),
-             scan.getHeartRate(),
-             scan.getSleepingTime(),
-             scan.getCurrentWeight(),
-             scan.getEmotionalState(),
-             scan.getOverallFeeling()});
+        ScanResult result;
+        bool resultStored = false;
+        db.transaction([this, &scan, &result, &resultStored]() {
+            const int previousNewestId =
+                trends.newestScanId(scan.getProfileId());
+            scan.setId(db.execute(INSERT_SCAN_QUERY, scanParams(scan)).toInt());
+            trends.appendScan(scan, previousNewestId);
+            resultStored = results.storeResult(scan, result);
+            summaries.addScan(scan, previousNewestId);
+            population.catchUp();
+        });
+
+        // Only a committed scan keeps its id, so only now may it be cached
+        if (resultStored) results.cacheStoredResult(scan.getId(), result);
         return true;
     } catch (const std::exception& e) {
         qCritical() << "Failed to upload scan: " << e.what();
         return false;
     }
 }
+
+/**
+ * @brief Stores many scans in a single transaction, reusing one prepared
+ * insert for every row. Trend sums are not extended here; TrendController
+ * rebuilds them the next time they are read. The summary of every profile
+ * touched is rebuilt, and the population sketches extended, in the same
+ * transaction.
+ * @param scans the scans to insert
+ * @return true if every scan was stored, false if the batch was rolled back
+ */
+bool ScanController::storeScans(const QVector<ScanModel>& scans) {
+    QList<QList<QVariant>> paramSets;
+    QSet<int> profileIds;
+    paramSets.reserve(scans.size());
+    for (const ScanModel& scan : scans) {
+        paramSets.append(scanParams(scan));
+        profileIds.insert(scan.getProfileId());
+    }
+
+    try {
+        int rows = 0;
+        qint64 elapsedNs = 1;
+        db.transaction([&]() {
+            QElapsedTimer timer;
+            timer.start();
+            rows = db.executeBatch(INSERT_SCAN_QUERY, paramSets);
+            elapsedNs = qMax<qint64>(timer.nsecsElapsed(), 1);
+
+            for (int profileId : profileIds) summaries.rebuild(profileId);
+            population.catchUp();
+        });
+
+        double rowsPerSecond = rows * 1e9 / elapsedNs;
+        lastBatchRowsPerSecond = rowsPerSecond;
+        qInfo() << "Stored" << rows << "scans in" << elapsedNs / 1e6 << "ms ("
+                << rowsPerSecond << "rows/s)";
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to upload scans: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Deletes a scan and its stored results, and takes it out of its
+ * profile's summary, in one transaction. The profile's trend sums are
+ * dropped and rebuilt the next time they are read.
+ * @param scanId the scan to delete
+ * @return true if the scan was deleted
+ */
+bool ScanController::deleteScan(int scanId) {
+    try {
+        db.transaction([this, scanId]() {
+            ScanModel scan;
+            if (!UserProfileController(db).getScan(scanId, scan))
+                throw std::runtime_error("No scan " + std::to_string(scanId));
+
+            const int profileId = scan.getProfileId();
+            const int previousNewestId = trends.newestScanId(profileId);
+            results.removeResult(scanId);
+            db.execute("DELETE FROM scan WHERE scan_id = ?;", {scanId});
+            trends.invalidate(profileId);
+            summaries.removeScan(scan, previousNewestId);
+        });
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to delete scan: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Gets the throughput of the most recent storeScans call
+ * @return rows inserted per second, or 0 if no batch has been stored
+ */
+double ScanController::getLastBatchRowsPerSecond() const {
+    return lastBatchRowsPerSecond;
+}
+
+/**
+ * @brief Gets the result store filled by storeScan, for showing results.
+ */
+ScanResultController& ScanController::getResultController() {
+    return results;
+}
+
+/**
+ * @brief Gets the population sketches extended by storeScan and storeScans.
+ */
+PopulationController& ScanController::getPopulationController() {
+    return population;
+}
+
+/**
+ * @brief Builds the positional parameters for INSERT_SCAN_QUERY
+ * @param scan the scan to insert
+ * @return the parameters in column order
+ */
+QList<QVariant> ScanController::scanParams(const ScanModel& scan) {
+    return {scan.getProfileId(),
+            scan.getName(),
+            scan.getH1Lung(),
+            scan.getH1LungR(),
+            scan.getH2HeartConstrictor(),
+            scan.getH2HeartConstrictorR(),
+            scan.getH3Heart(),
+            scan.getH3HeartR(),
+            scan.getH4SmallIntestine(),
+            scan.getH4SmallIntestineR(),
+            scan.getH5TripleHeater(),
+            scan.getH5TripleHeaterR(),
+            scan.getH6LargeIntestine(),
+            scan.getH6LargeIntestineR(),
+            scan.getF1Spleen(),
+            scan.getF1SpleenR(),
+            scan.getF2Liver(),
+            scan.getF2LiverR(),
+            scan.getF3Kidney(),
+            scan.getF3KidneyR(),
+            scan.getF4UrinaryBladder(),
+            scan.getF4UrinaryBladderR(),
+            scan.getF5GallBladder(),
+            scan.getF5GallBladderR(),
+            scan.getF6Stomach(),
+            scan.getF6StomachR(),
+            scan.getBodyTemp(),
+            scan.getBloodPressure(),
+            scan.getHeartRate(),
+            scan.getSleepingTime(),
+            scan.getCurrentWeight(),
+            scan.getEmotionalState(),
+            scan.getOverallFeeling()};
+}
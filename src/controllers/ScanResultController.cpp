@@ -0,0 +1,199 @@
+/**
+ * @file ScanResultController.cpp
+ * @brief Stores and caches computed scan results.
+ */
+
+#include "ScanResultController.h"
+
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+
+// Each metric is packed as a float32 value and an int8 level, host order
+const int METRIC_BYTES = sizeof(float) + 1;
+const int METRIC_COUNT = HealthMetricCalculator::ORGAN_COUNT +
+                         HealthMetricCalculator::INDICATOR_COUNT;
+
+}  // namespace
+
+ScanResultController::ScanResultController(DatabaseManager& db)
+    : db(db), cache(CACHE_SIZE), cacheHits(0), cacheMisses(0) {}
+
+/**
+ * @brief Gets a scan's organ and indicator results: from the cache, else
+ * from scan_result with one primary key lookup, else by calculating and
+ * storing them. Unsaved scans and non-deterministic calculators are always
+ * calculated.
+ * @param scan the scan
+ * @param result output parameter
+ * @return true if the results are available
+ */
+bool ScanResultController::getResult(ScanModel& scan, ScanResult& result) {
+    if (scan.getId() <= 0 || !calculator.isDeterministic())
+        return calculator.calculateScanResult(&scan, result);
+
+    const Key key(scan.getId(), calculator.getVersion());
+    {
+        QMutexLocker locker(&mutex);
+        if (const ScanResult* cached = cache.object(key)) {
+            ++cacheHits;
+            result = *cached;
+            return true;
+        }
+        ++cacheMisses;
+    }
+
+    try {
+        bool found = false;
+        db.queryEach(
+            "SELECT metrics FROM scan_result "
+            "WHERE scan_id = ? AND version = ?;",
+            {key.first, static_cast<qint64>(key.second)},
+            [&found, &result](const QSqlQuery& row) {
+                found = decode(row.value(0).toByteArray(), result);
+            });
+
+        if (!found) {
+            if (!calculator.calculateScanResult(&scan, result)) return false;
+            saveResult(key.first, key.second, result);
+        }
+        cacheResult(key, result);
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to get scan result: " << e.what();
+        return calculator.calculateScanResult(&scan, result);
+    }
+}
+
+/**
+ * @brief Gets the calculator results are computed with. Changing its ranges
+ * or seed changes its version, which invalidates every stored result.
+ */
+HealthMetricCalculator& ScanResultController::getCalculator() {
+    return calculator;
+}
+
+void ScanResultController::clearCache() {
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+int ScanResultController::getCacheHits() const {
+    QMutexLocker locker(&mutex);
+    return cacheHits;
+}
+
+int ScanResultController::getCacheMisses() const {
+    QMutexLocker locker(&mutex);
+    return cacheMisses;
+}
+
+/**
+ * @brief Calculates and stores the results of a newly inserted scan. Throws
+ * on database errors; run it in the inserting transaction. The results are
+ * not cached here: a rollback frees the scan id for the next insert, so
+ * cache them with cacheStoredResult() once the transaction has committed.
+ * @param scan the inserted scan, with its id set
+ * @param result output parameter, the stored results
+ * @return false if nothing was stored, for a non-deterministic calculator
+ */
+bool ScanResultController::storeResult(ScanModel& scan, ScanResult& result) {
+    if (!calculator.isDeterministic()) return false;
+
+    if (!calculator.calculateScanResult(&scan, result))
+        throw std::runtime_error("Could not calculate scan result");
+
+    saveResult(scan.getId(), calculator.getVersion(), result);
+    return true;
+}
+
+/**
+ * @brief Caches the results storeResult() stored, after the inserting
+ * transaction has committed.
+ * @param scanId the committed scan's id
+ * @param result the results stored for it
+ */
+void ScanResultController::cacheStoredResult(int scanId,
+                                             const ScanResult& result) {
+    cacheResult(Key(scanId, calculator.getVersion()), result);
+}
+
+/**
+ * @brief Forgets a deleted scan's results. Throws on database errors.
+ * @param scanId the scan id
+ */
+void ScanResultController::removeResult(int scanId) {
+    db.execute("DELETE FROM scan_result WHERE scan_id = ?;", {scanId});
+
+    QMutexLocker locker(&mutex);
+    cache.remove(Key(scanId, calculator.getVersion()));
+}
+
+void ScanResultController::cacheResult(const Key& key,
+                                       const ScanResult& result) {
+    QMutexLocker locker(&mutex);
+    cache.insert(key, new ScanResult(result));
+}
+
+/**
+ * @brief Writes a scan's results, replacing any from other versions.
+ * Throws on database errors.
+ */
+void ScanResultController::saveResult(int scanId, quint64 version,
+                                      const ScanResult& result) {
+    const qint64 storedVersion = static_cast<qint64>(version);
+    db.transaction([this, scanId, storedVersion, &result]() {
+        db.execute(
+            "DELETE FROM scan_result WHERE scan_id = ? AND version <> ?;",
+            {scanId, storedVersion});
+        db.execute(
+            "INSERT OR REPLACE INTO scan_result (scan_id, version, metrics) "
+            "VALUES (?, ?, ?);",
+            {scanId, storedVersion, encode(result)});
+    });
+}
+
+QByteArray ScanResultController::encode(const ScanResult& result) {
+    QByteArray bytes;
+    bytes.reserve(METRIC_COUNT * METRIC_BYTES);
+    auto append = [&bytes](const HealthMetricModel& metric) {
+        const float value = metric.getValue();
+        bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        bytes.append(static_cast<char>(metric.getLevel()));
+    };
+    for (const HealthMetricModel& metric : result.organs) append(metric);
+    for (const HealthMetricModel& metric : result.indicators) append(metric);
+    return bytes;
+}
+
+/**
+ * @brief Unpacks stored results.
+ * @return false if the blob does not hold exactly one result per metric
+ */
+bool ScanResultController::decode(const QByteArray& bytes,
+                                  ScanResult& result) {
+    if (bytes.size() != METRIC_COUNT * METRIC_BYTES) return false;
+
+    result.organs.clear();
+    result.indicators.clear();
+    const char* data = bytes.constData();
+    for (int i = 0; i < METRIC_COUNT; ++i, data += METRIC_BYTES) {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        const int level = static_cast<signed char>(data[sizeof(value)]);
+
+        if (i < HealthMetricCalculator::ORGAN_COUNT) {
+            result.organs.append(HealthMetricModel(
+                static_cast<HealthMetric::Id>(HealthMetric::FirstOrgan + i),
+                value, level));
+        } else {
+            const int k = i - HealthMetricCalculator::ORGAN_COUNT;
+            result.indicators.append(HealthMetricModel(
+                static_cast<HealthMetric::Id>(HealthMetric::FirstIndicator +
+                                              k),
+                value, level));
+        }
+    }
+    return true;
+}
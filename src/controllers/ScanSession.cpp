@@ -0,0 +1,370 @@
+/**
+ * @file ScanSession.cpp
+ * @brief Implementation of the ScanSession class.
+ */
+
+#include "ScanSession.h"
+
+#include <algorithm>
+
+#include "DeviceController.h"
+#include "Logging.h"
+#include "ScanController.h"
+#include "SimulationClock.h"
+
+namespace {
+
+/**
+ * @brief The MeridianPoint measured at a scan point: pages go through the
+ * twelve organs on the left side and then on the right, while a scan keeps
+ * each organ's left and right readings side by side.
+ * @param index The scan point, 0 to 23.
+ */
+int meridianPoint(int index) {
+    const int organ = index % ScanSession::MEASUREMENTS_PER_SIDE;
+    const bool right = index >= ScanSession::MEASUREMENTS_PER_SIDE;
+    return organ * 2 + (right ? 1 : 0);
+}
+
+}  // namespace
+
+ScanSession::ScanSession(QObject *parent, ScanController *scanController,
+                         DeviceController *deviceController,
+                         SimulationClock *clock)
+    : QObject(parent),
+      scanController(scanController),
+      deviceController(deviceController),
+      clock(clock),
+      page(INTRO_PAGE),
+      profileId(-1),
+      remainingTime(0),
+      measurementDone(false),
+      scanInProgress(false),
+      pipeline(SignalPipeline::standard(STREAM_SAMPLE_RATE)) {
+    if (!this->clock) {
+        this->clock = deviceController ? deviceController->getClock()
+                                       : new SimulationClock(this);
+    }
+
+    // Gives up on a point that never settles
+    countdownTimer = this->clock->createTimer(this);
+    countdownTimer->setInterval(1000);
+    connect(countdownTimer, &ClockTimer::timeout, this,
+            &ScanSession::updateCountdown);
+
+    // Cancels the scan if the device disconnects partway
+    connectionTimer = this->clock->createTimer(this);
+    connectionTimer->setInterval(1000);
+    connect(connectionTimer, &ClockTimer::timeout, this,
+            &ScanSession::checkConnection);
+
+    if (deviceController) {
+        connect(deviceController, &DeviceController::dataReceived, this,
+                &ScanSession::receiveData);
+        connect(deviceController, &DeviceController::samplesAvailable, this,
+                &ScanSession::readStream);
+    }
+}
+
+bool ScanSession::areAllMeasurementsComplete() const {
+    return rawMeasurements.size() == SCAN_PAGES;
+}
+
+bool ScanSession::begin() {
+    if (page != INTRO_PAGE) {
+        DEBUG("Scan already started");
+        return false;
+    }
+    if (!isDeviceReady()) {
+        emit alert("Device is off or not connected");
+        return false;
+    }
+
+    if (deviceController) connectionTimer->start();
+    nextPage();
+    return true;
+}
+
+bool ScanSession::startMeasurement() {
+    if (!isScanPage(page)) {
+        DEBUG("Cannot start measurement - not on a scan page");
+        return false;
+    }
+    if (!isDeviceReady()) {
+        DEBUG("Cannot start measurement - device not connected");
+        return false;
+    }
+    if (scanInProgress) {
+        DEBUG("Measurement already in progress");
+        return false;
+    }
+
+    DEBUG("Starting new measurement");
+    resetState();
+
+    // Stream the point and reduce it to a reading as samples arrive; the
+    // countdown only gives up if no stable reading comes
+    pipeline.reset();
+    if (deviceController) {
+        StreamConfig config;
+        config.sampleRate = STREAM_SAMPLE_RATE;
+        if (!deviceController->startStream(page, config)) {
+            DEBUG("Cannot start measurement - device did not stream");
+            return false;
+        }
+    }
+
+    measurementDone = false;
+    scanInProgress = true;
+    remainingTime = MEASUREMENT_TIMEOUT_SECONDS;
+    countdownTimer->start();
+    emit measurementStarted(page);
+    return true;
+}
+
+void ScanSession::release() {
+    if (!isDeviceReady()) {
+        return;
+    }
+
+    if (measurementDone) {
+        DEBUG("Measurement done, proceeding to next page");
+        nextPage();
+        measurementDone = false;
+    } else if (scanInProgress && isScanPage(page)) {
+        DEBUG("Measurement interrupted");
+        interrupt("Scan interrupted - Please hold device until scan is complete");
+    }
+    scanInProgress = false;
+}
+
+void ScanSession::submitInputs(const ScanInputs &inputs) {
+    if (page != INPUT_PAGE) {
+        DEBUG("Not on the post-scan input page");
+        return;
+    }
+
+    this->inputs = inputs;
+    DEBUG(QString("Collected user inputs: Body Temp=%1°C, Blood Pressure=%2 "
+                  "mmHg, Heart Rate=%3 bpm, Sleeping Time=%4 hours, Current "
+                  "Weight=%5 kg, Emotional State=%6, Overall Feeling=%7")
+              .arg(inputs.bodyTemp)
+              .arg(inputs.bloodPressure)
+              .arg(inputs.heartRate)
+              .arg(inputs.sleepingTime)
+              .arg(inputs.currentWeight)
+              .arg(inputs.emotionalState)
+              .arg(inputs.overallFeeling));
+    nextPage();
+}
+
+void ScanSession::cancel() { resetMeasurement(); }
+
+void ScanSession::measurementComplete() {
+    DEBUG("Measurement complete");
+
+    countdownTimer->stop();
+    if (deviceController && !deviceController->isStreaming()) {
+        deviceController->transmitData();
+    } else {
+        if (deviceController) deviceController->stopStream();
+        if (!pipeline.isComplete()) {
+            DEBUG("No stable reading before the timeout");
+            interrupt("No stable reading - hold the device still on the point");
+            scanInProgress = false;
+            return;
+        }
+        receiveData(pipeline.reading());
+    }
+
+    measurementDone = true;
+}
+
+void ScanSession::receiveData(int data) {
+    rawMeasurements.append(ScanPoint{page, data});
+    DEBUG("Received data: " << data << " on page " << page << ", "
+                            << rawMeasurements.size() << " collected");
+
+    emit measurementTaken(page, data);
+}
+
+void ScanSession::readStream() {
+    if (!deviceController || !scanInProgress || measurementDone) {
+        return;
+    }
+
+    DeviceSample samples[STREAM_READ_SIZE];
+    float values[STREAM_READ_SIZE];
+    int count;
+    while ((count = deviceController->readSamples(samples,
+                                                  STREAM_READ_SIZE)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            values[i] = samples[i].value;
+        }
+        pipeline.push(values, count);
+    }
+
+    if (pipeline.isComplete()) {
+        measurementComplete();
+    }
+}
+
+void ScanSession::addSamples(const float *values, int count) {
+    if (!scanInProgress || measurementDone) {
+        return;
+    }
+
+    pipeline.push(values, count);
+    if (pipeline.isComplete()) {
+        measurementComplete();
+    }
+}
+
+void ScanSession::updateCountdown() {
+    if (deviceController && !deviceController->isConnected()) {
+        DEBUG("Device disconnected during measurement");
+        emit alert("Device disconnected - measurement cancelled");
+        resetMeasurement();
+        return;
+    }
+
+    if (isScanPage(page)) {
+        if (remainingTime > 0) {
+            remainingTime--;
+        } else {
+            countdownTimer->stop();
+            measurementComplete();
+        }
+    }
+}
+
+void ScanSession::checkConnection() {
+    if (!deviceController->isConnected() && page != INTRO_PAGE &&
+        !areAllMeasurementsComplete()) {
+        DEBUG("Device disconnected - resetting measurement");
+        emit alert("Device disconnected - measurement cancelled");
+        resetMeasurement();
+    }
+}
+
+/**
+ * @brief Checks if the device can measure; always true without a device.
+ */
+bool ScanSession::isDeviceReady() const {
+    return !deviceController || (deviceController->isDeviceOn() &&
+                                 deviceController->isConnected());
+}
+
+/**
+ * @brief Advances to the next page, storing the scan on reaching the
+ * results.
+ */
+void ScanSession::nextPage() {
+    if (page >= RESULTS_PAGE) return;
+
+    page++;
+    emit pageChanged(page);
+
+    if (page == INPUT_PAGE) {
+        DEBUG("Reached post-scan input page");
+    } else if (page == RESULTS_PAGE) {
+        DEBUG("About to show results page, processing measurements");
+        processMeasurements();
+    }
+}
+
+/**
+ * @brief Maps the collected readings into a scan and stores it.
+ */
+void ScanSession::processMeasurements() {
+    if (profileId == -1) {
+        WARNING("No profile selected");
+        return;
+    }
+
+    DEBUG("Processing measurements");
+
+    if (rawMeasurements.size() != SCAN_PAGES) {
+        ERROR("Not all measurements have been collected");
+        return;
+    }
+
+    std::sort(rawMeasurements.begin(), rawMeasurements.end(),
+              [](const ScanPoint &a, const ScanPoint &b) {
+                  return a.position < b.position;
+              });
+
+    Measurements measurements{};
+    for (int i = 0; i < rawMeasurements.size(); ++i) {
+        measurements[meridianPoint(i)] = rawMeasurements[i].rawValue;
+    }
+
+    ScanModel scanModel;
+    scanModel.setProfileId(profileId);
+    scanModel.setName("Name");
+    scanModel.setMeasurements(measurements);
+
+    scanModel.setBodyTemp(inputs.bodyTemp);
+    scanModel.setBloodPressure(inputs.bloodPressure);
+    scanModel.setHeartRate(inputs.heartRate);
+    scanModel.setSleepingTime(inputs.sleepingTime);
+    scanModel.setCurrentWeight(inputs.currentWeight);
+    scanModel.setEmotionalState(inputs.emotionalState);
+    scanModel.setOverallFeeling(inputs.overallFeeling);
+
+    if (!scanController || !scanController->storeScan(scanModel)) {
+        ERROR("Failed to store the scan");
+        return;
+    }
+
+    emit scanStored(scanModel);
+}
+
+/**
+ * @brief Resets the measurement process to the intro page.
+ */
+void ScanSession::resetMeasurement() {
+    DEBUG("Resetting measurement");
+
+    connectionTimer->stop();
+    resetState();
+    measurementDone = false;
+    rawMeasurements.clear();
+    page = INTRO_PAGE;
+    emit pageChanged(page);
+}
+
+/**
+ * @brief Stops the current measurement, if any.
+ */
+void ScanSession::resetState() {
+    const bool wasScanning = scanInProgress;
+    countdownTimer->stop();
+    if (deviceController) {
+        deviceController->stopStream();
+    }
+    scanInProgress = false;
+
+    if (isScanPage(page)) emit measurementReset(page);
+
+    if (wasScanning) {
+        DEBUG("Reset state: Cancelled active scan");
+    } else {
+        DEBUG("Reset state: Cleared previous state");
+    }
+}
+
+/**
+ * @brief Abandons the current point's measurement and tells the user why.
+ */
+void ScanSession::interrupt(const QString &message) {
+    DEBUG("Handling scan error");
+
+    countdownTimer->stop();
+    if (deviceController) {
+        deviceController->stopStream();
+    }
+    if (isScanPage(page)) emit measurementReset(page);
+
+    emit alert(message);
+}
@@ -0,0 +1,228 @@
+/**
+ * @file TrendController.cpp
+ * @brief Persists running trend sums and answers trend queries from them.
+ */
+
+#include "TrendController.h"
+
+#include "UserProfileController.h"
+
+namespace {
+
+const QString LATEST_PREFIX_QUERY =
+    "SELECT " TREND_COLUMNS
+    " FROM scan_trend WHERE profile_id = ? ORDER BY seq DESC LIMIT 1;";
+
+const QString PREFIX_AT_QUERY = "SELECT " TREND_COLUMNS
+                                " FROM scan_trend"
+                                " WHERE profile_id = ? AND seq = ?;";
+
+const QString INSERT_PREFIX_QUERY =
+    "INSERT INTO scan_trend (profile_id, " TREND_COLUMNS
+    ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+}  // namespace
+
+TrendController::TrendController(DatabaseManager& db) : db(db) {}
+
+/**
+ * @brief Fits the trend of each indicator over a profile's recent scans.
+ * @param profileId the profile id
+ * @param window how many of the newest scans to fit, or
+ * TrendEngine::ALL_SCANS for the whole history
+ * @param fit output parameter; fit.scans is the number of scans fitted
+ * @return true if the operation was successful
+ */
+bool TrendController::getTrend(int profileId, int window, TrendFit& fit) {
+    try {
+        db.transaction([this, profileId, window, &fit]() {
+            ensureCurrent(profileId);
+
+            TrendPrefix last;
+            TrendPrefix start;
+            int scanId = -1;
+            prefixAt(profileId, -1, last, scanId);
+
+            const int startSeq = TrendEngine::windowStart(last.n, window);
+            if (startSeq > 0 && !prefixAt(profileId, startSeq, start, scanId))
+                throw std::runtime_error("Missing trend row " +
+                                         std::to_string(startSeq));
+
+            fit = TrendEngine::fit(last, start);
+        });
+        return true;
+    } catch (const std::exception& e) {
+        fit = TrendFit();
+        qCritical() << "Failed to get trend: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Gets the trend metrics of a profile, as
+ * HealthMetricCalculator::calculateTrendHealth reports them.
+ * @param profileId the profile id
+ * @param window how many of the newest scans to fit, or
+ * TrendEngine::ALL_SCANS
+ * @param hms output parameter, one metric per indicator
+ * @return true if the profile has at least two scans in the window
+ */
+bool TrendController::getTrendHealth(int profileId, int window,
+                                     QVector<HealthMetricModel>& hms) {
+    hms.clear();
+    TrendFit fit;
+    if (!getTrend(profileId, window, fit)) return false;
+    if (fit.scans <= 1) {
+        qCritical() << "Error: Not enough scans. Cannot calculate scan trends.";
+        return false;
+    }
+
+    TrendEngine::toHealthMetrics(fit, hms);
+    return true;
+}
+
+/**
+ * @brief Recomputes a profile's trend sums from its scans.
+ * @param profileId the profile id
+ * @return true if the operation was successful
+ */
+bool TrendController::rebuildTrends(int profileId) {
+    try {
+        db.transaction([this, profileId]() { rebuild(profileId); });
+        return true;
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to rebuild trends: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Gets the id of a profile's newest scan. Throws on database errors.
+ * @param profileId the profile id
+ * @return the scan id, or -1 if the profile has no scans
+ */
+int TrendController::newestScanId(int profileId) {
+    int scanId = -1;
+    db.queryEach(
+        "SELECT scan_id FROM scan WHERE profile_id = ? "
+        "ORDER BY created_on DESC, scan_id DESC LIMIT 1;",
+        {profileId},
+        [&scanId](const QSqlQuery& row) { scanId = row.value(0).toInt(); });
+    return scanId;
+}
+
+/**
+ * @brief Extends a profile's trend sums with a newly inserted scan in O(1).
+ * If the sums did not end at the scan that was newest before the insert,
+ * they are rebuilt instead. Throws on database errors; run it in the
+ * inserting transaction.
+ * @param scan the inserted scan, with its id set
+ * @param previousNewestId newestScanId() from before the insert
+ */
+void TrendController::appendScan(ScanModel& scan, int previousNewestId) {
+    const int profileId = scan.getProfileId();
+
+    TrendPrefix last;
+    int lastScanId = -1;
+    prefixAt(profileId, -1, last, lastScanId);
+    if (lastScanId != previousNewestId) {
+        rebuild(profileId);
+        return;
+    }
+
+    const TrendPrefix next =
+        TrendEngine::append(last, calculator.calculateIndicators(&scan));
+    db.execute(INSERT_PREFIX_QUERY,
+               prefixParams(profileId, scan.getId(), next));
+}
+
+/**
+ * @brief Drops a profile's trend sums, for when a scan other than the
+ * newest changes. The next read rebuilds them. Throws on database errors.
+ * @param profileId the profile id
+ */
+void TrendController::invalidate(int profileId) {
+    db.execute("DELETE FROM scan_trend WHERE profile_id = ?;", {profileId});
+}
+
+/**
+ * @brief Reads one row of a profile's trend sums. Throws on database
+ * errors.
+ * @param profileId the profile id
+ * @param seq the row to read, or -1 for the newest
+ * @param prefix output parameter, left empty if there is no such row
+ * @param scanId output parameter, the row's scan id or -1
+ * @return true if the row exists
+ */
+bool TrendController::prefixAt(int profileId, int seq, TrendPrefix& prefix,
+                               int& scanId) {
+    prefix = TrendPrefix();
+    scanId = -1;
+
+    const bool newest = seq < 0;
+    const int rows = db.queryEach(
+        newest ? LATEST_PREFIX_QUERY : PREFIX_AT_QUERY,
+        newest ? QList<QVariant>{profileId} : QList<QVariant>{profileId, seq},
+        [&prefix, &scanId](const QSqlQuery& row) {
+            using namespace TrendColumn;
+            prefix.n = row.value(Seq).toInt();
+            scanId = row.value(ScanId).toInt();
+            for (int k = 0; k < TrendPrefix::INDICATORS; ++k) {
+                prefix.latest[k] = row.value(Latest + k).toFloat();
+                prefix.sumY[k] = row.value(SumY + k).toDouble();
+                prefix.sumXY[k] = row.value(SumXY + k).toDouble();
+            }
+        });
+    return rows > 0;
+}
+
+/**
+ * @brief Rebuilds a profile's trend sums if they do not end at its newest
+ * scan. Throws on database errors.
+ * @param profileId the profile id
+ */
+void TrendController::ensureCurrent(int profileId) {
+    TrendPrefix last;
+    int lastScanId = -1;
+    prefixAt(profileId, -1, last, lastScanId);
+    if (lastScanId != newestScanId(profileId)) rebuild(profileId);
+}
+
+/**
+ * @brief Replaces a profile's trend sums with ones computed from all of its
+ * scans, oldest first. Throws on database errors.
+ * @param profileId the profile id
+ */
+void TrendController::rebuild(int profileId) {
+    qDebug() << "Rebuilding trends for profile" << profileId;
+    db.execute("DELETE FROM scan_trend WHERE profile_id = ?;", {profileId});
+
+    ScanBatch batch;
+    if (!UserProfileController(db).getProfileScanBatch(profileId, batch))
+        throw std::runtime_error("Could not load scans");
+    if (batch.isEmpty()) return;
+
+    IndicatorSeries series;
+    if (!calculator.calculateIndicatorSeries(batch, series))
+        throw std::runtime_error("Could not calculate indicators");
+
+    const QVector<TrendPrefix> prefixes = TrendEngine::prefixes(series);
+    QList<QList<QVariant>> paramSets;
+    paramSets.reserve(prefixes.size());
+    for (int i = 0; i < prefixes.size(); ++i)
+        paramSets.append(
+            prefixParams(profileId, batch.getIds()[i], prefixes[i]));
+    db.executeBatch(INSERT_PREFIX_QUERY, paramSets);
+}
+
+/**
+ * @brief Builds the positional parameters for INSERT_PREFIX_QUERY.
+ */
+QList<QVariant> TrendController::prefixParams(int profileId, int scanId,
+                                              const TrendPrefix& prefix) {
+    QList<QVariant> params = {profileId, prefix.n, scanId};
+    for (float value : prefix.latest) params.append(double(value));
+    for (double sum : prefix.sumY) params.append(sum);
+    for (double sum : prefix.sumXY) params.append(sum);
+    return params;
+}
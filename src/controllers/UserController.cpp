@@ -84,26 +84,28 @@ bool UserController::getUserByEmail(const QString& email, UserModel& user) const
  */
 bool UserController::getUserProfiles(int userId, QVector<ProfileModel*>& profiles) const {
 
-    QList<QMap<QString, QVariant>> results;
-
     try {
-        db.query("SELECT * from profile WHERE user_id = ?;", {userId}, results);
         profiles.clear();
-        for(const auto& result : results) {
-            ProfileModel* profile = new ProfileModel(
-                result.value("profile_id").toInt(),
-                result.value("user_id").toInt(),
-                result.value("name").toString(),
-                result.value("description").toString(),
-                result.value("sex").toString(),
-                result.value("weight").toInt(),
-                result.value("height").toInt(),
-                result.value("date_of_birth").toDate()
-            );
-            profiles.append(profile);
-        }
+        db.queryEach(
+            "SELECT profile_id, user_id, name, description, sex, weight, height, date_of_birth FROM profile WHERE user_id = ?;",
+            {userId},
+            [&profiles](const QSqlQuery& row) {
+                profiles.append(new ProfileModel(
+                    row.value(0).toInt(),
+                    row.value(1).toInt(),
+                    row.value(2).toString(),
+                    row.value(3).toString(),
+                    row.value(4).toString(),
+                    row.value(5).toInt(),
+                    row.value(6).toInt(),
+                    row.value(7).toDate()
+                ));
+            }
+        );
         return true;
     } catch(const std::exception& e) {
+        qDeleteAll(profiles);
+        profiles.clear();
         qCritical() << "Failed to get profiles: " << e.what();
         return false;
     }
@@ -5,6 +5,14 @@
 
 #include "UserProfileController.h"
 
+#include <QtConcurrent>
+#include <algorithm>
+#include <limits>
+
+#define PROFILE_SELECT_COLUMNS                                       \
+    "profile_id, user_id, name, description, sex, weight, height, " \
+    "date_of_birth"
+
 /**
  * @brief Constructor for a UserProfileController
  * @param db a reference to the database manager
@@ -60,29 +68,59 @@ bool UserProfileController::getProfileByName(int userId, const QString& name,
  */
 bool UserProfileController::getProfiles(
     int userId, QVector<ProfileModel*>& profiles) const {
-    QList<QMap<QString, QVariant>> results;
+    try {
+        profiles.clear();
+        db.queryEach(
+            "SELECT " PROFILE_SELECT_COLUMNS " FROM profile WHERE user_id = ?;",
+            {userId}, [&profiles](const QSqlQuery& row) {
+                profiles.append(new ProfileModel(profileFromRow(row)));
+            });
+        return true;
+    } catch (const std::exception& e) {
+        qDeleteAll(profiles);
+        profiles.clear();
+        qCritical() << "Failed to get profiles: " << e.what();
+        return false;
+    }
+}
 
+/**
+ * @brief Gets all profiles associated with a user by value
+ * @param userId the user id
+ * @param profiles reference to a vector that will be populated with the results
+ * @return true if the operation was successful
+ */
+bool UserProfileController::getProfiles(int userId,
+                                        QVector<ProfileModel>& profiles) const {
     try {
-        db.query("SELECT * from profile WHERE user_id = ?;", {userId}, results);
         profiles.clear();
-        for (const auto& result : results) {
-            ProfileModel* profile = new ProfileModel(
-                result.value("profile_id").toInt(),
-                result.value("user_id").toInt(),
-                result.value("name").toString(),
-                result.value("description").toString(),
-                result.value("sex").toString(), result.value("weight").toInt(),
-                result.value("height").toInt(),
-                result.value("date_of_birth").toDate());
-            profiles.append(profile);
-        }
+        db.queryEach(
+            "SELECT " PROFILE_SELECT_COLUMNS " FROM profile WHERE user_id = ?;",
+            {userId}, [&profiles](const QSqlQuery& row) {
+                profiles.append(profileFromRow(row));
+            });
         return true;
     } catch (const std::exception& e) {
+        profiles.clear();
         qCritical() << "Failed to get profiles: " << e.what();
         return false;
     }
 }
 
+/**
+ * @brief Loads a user's profiles on the global thread pool
+ * @param userId the user id
+ * @return a future holding the profiles, empty if loading failed
+ */
+QFuture<QVector<ProfileModel>> UserProfileController::getProfilesAsync(
+    int userId) const {
+    return QtConcurrent::run([this, userId]() {
+        QVector<ProfileModel> profiles;
+        getProfiles(userId, profiles);
+        return profiles;
+    });
+}
+
 /**
  * @brief Creates a profile
  * @param userId the user id associated with the profile
@@ -109,17 +147,19 @@ bool UserProfileController::createProfile(int userId, const QString& name,
 
 /**
  * @brief Creates a profile
- * @param profile the profile model to create the profile with
+ * @param profile the profile model to create the profile with; its id is
+ * set to the new profile id
  * @return true if the operation was successful
  */
 bool UserProfileController::createProfile(ProfileModel* profile) {
     try {
-        db.execute(
+        const QVariant id = db.execute(
             "INSERT INTO profile (user_id, name, description, sex, weight, "
             "height, date_of_birth) VALUES (?,?,?,?,?,?,?);",
             {profile->getUserId(), profile->getName(), profile->getDesc(),
              profile->getSex(), profile->getWeight(), profile->getHeight(),
              profile->getDobString()});
+        profile->setId(id.toInt());
         return true;
     } catch (const std::exception& e) {
         qCritical() << "Failed to createe profile: " << e.what();
@@ -216,61 +256,254 @@ bool UserProfileController::deleteProfile(ProfileModel* profile) {
  */
 bool UserProfileController::getProfileScans(int profileId,
                                             QVector<ScanModel*>& scans) const {
-    QList<QMap<QString, QVariant>> results;
     try {
-        db.query("SELECT * FROM scan WHERE profile_id = ?;", {profileId},
-                 results);
+        scans.clear();
+        db.queryEach(
+            "SELECT " SCAN_SELECT_COLUMNS
+            " FROM scan WHERE profile_id = ? ORDER BY created_on, scan_id;",
+            {profileId}, [&scans](const QSqlQuery& row) {
+                scans.append(new ScanModel(scanFromRow(row)));
+            });
 
+        return true;
+
+    } catch (const std::exception& e) {
+        qDeleteAll(scans);
+        scans.clear();
+        qCritical() << "Failed to get profile scans: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Gets all the scans associated with a profile by value
+ * @param profileId the profile id
+ * @param scans a reference to a vector that will be populated with the results
+ * @return true if the operation was successful
+ */
+bool UserProfileController::getProfileScans(int profileId,
+                                            QVector<ScanModel>& scans) const {
+    try {
         scans.clear();
-        for (const auto& result : results) {
-            ScanModel* scan =
-                new ScanModel(result.value("scan_id").toInt(),
-                              result.value("profile_id").toInt(),
-                              result.value("h1_lung").toInt(),
-                              result.value("h1_lung_r").toInt(),
-                              result.value("h2_heart_constrictor").toInt(),
-                              result.value("h2_heart_constrictor_r").toInt(),
-                              result.value("h3_heart").toInt(),
-                              result.value("h3_heart_r").toInt(),
-                              result.value("h4_small_intestine").toInt(),
-                              result.value("h4_small_intestine_r").toInt(),
-                              result.value("h5_triple_heater").toInt(),
-                              result.value("h5_triple_heater_r").toInt(),
-                              result.value("h6_large_intestine").toInt(),
-                              result.value("h6_large_intestine_r").toInt(),
-
-                              result.value("f1_spleen").toInt(),
-                              result.value("f1_spleen_r").toInt(),
-                              result.value("f2_liver").toInt(),
-                              result.value("f2_liver_r").toInt(),
-                              result.value("f3_kidney").toInt(),
-                              result.value("f3_kidney_r").toInt(),
-                              result.value("f4_urinary_bladder").toInt(),
-                              result.value("f4_urinary_bladder_r").toInt(),
-                              result.value("f5_gall_bladder").toInt(),
-                              result.value("f5_gall_bladder_r").toInt(),
-                              result.value("f6_stomach").toInt(),
-                              result.value("f6_stomach_r").toInt(),
-
-                              result.value("created_on").toDate(),
-
-                              result.value("body_temp").toInt(),
-                              result.value("blood_pressure").toInt(),
-                              result.value("heart_rate").toInt(),
-                              result.value("sleeping_time").toInt(),
-                              result.value("current_weight").toInt(),
-                              result.value("emotional_state").toInt(),
-                              result.value("overall_feeling").toInt(),
-                              result.value("name").toString(),
-                              result.value("notes").toString());
-
-            scans.append(scan);
-        }
+        db.queryEach(
+            "SELECT " SCAN_SELECT_COLUMNS
+            " FROM scan WHERE profile_id = ? ORDER BY created_on, scan_id;",
+            {profileId},
+            [&scans](const QSqlQuery& row) { scans.append(scanFromRow(row)); });
 
         return true;
 
     } catch (const std::exception& e) {
+        scans.clear();
         qCritical() << "Failed to get profile scans: " << e.what();
         return false;
     }
 }
+
+/**
+ * @brief Gets one scan by its id
+ * @param scanId the scan id
+ * @param scan a reference to the scan that will be populated with the result
+ * @return true if the scan exists
+ */
+bool UserProfileController::getScan(int scanId, ScanModel& scan) const {
+    try {
+        const int rows = db.queryEach(
+            "SELECT " SCAN_SELECT_COLUMNS " FROM scan WHERE scan_id = ?;",
+            {scanId},
+            [&scan](const QSqlQuery& row) { scan = scanFromRow(row); });
+
+        return rows > 0;
+
+    } catch (const std::exception& e) {
+        qCritical() << "Failed to get scan: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Gets the readings of all of a profile's scans, oldest first, as a
+ * column-wise batch. Only the id, date and reading columns are read, and each
+ * row goes straight into the batch's columns without building a ScanModel.
+ * @param profileId the profile id
+ * @param batch a reference to the batch that will be populated with the
+ * results
+ * @return true if the operation was successful
+ */
+bool UserProfileController::getProfileScanBatch(int profileId,
+                                                ScanBatch& batch) const {
+    try {
+        batch.clear();
+        Measurements readings;
+        db.queryEach(
+            "SELECT " SCAN_BATCH_COLUMNS
+            " FROM scan WHERE profile_id = ? ORDER BY created_on, scan_id;",
+            {profileId}, [&batch, &readings](const QSqlQuery& row) {
+                for (int point = 0; point < MeridianPoint::Count; ++point)
+                    readings[point] = row.value(2 + point).toInt();
+                batch.append(row.value(0).toInt(), row.value(1).toDate(),
+                             readings);
+            });
+
+        return true;
+
+    } catch (const std::exception& e) {
+        batch.clear();
+        qCritical() << "Failed to get profile scan batch: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Loads a profile's scans on the global thread pool. Cancelling the
+ * future before it starts skips the query; a load already running finishes
+ * but its result can simply be dropped.
+ * @param profileId the profile id
+ * @return a future holding the scans, empty if loading failed
+ */
+QFuture<QVector<ScanModel>> UserProfileController::getProfileScansAsync(
+    int profileId) const {
+    return QtConcurrent::run([this, profileId]() {
+        QVector<ScanModel> scans;
+        getProfileScans(profileId, scans);
+        return scans;
+    });
+}
+
+/**
+ * @brief Gets one page of a profile's scans, newest first, using the
+ * (created_on, scan_id) keyset instead of an OFFSET so every page costs the
+ * same regardless of how deep into the history it is.
+ * @param profileId the profile id
+ * @param cursor the scan to page from (exclusive); an invalid cursor starts
+ * from the newest scan for Older or the oldest scan for Newer
+ * @param pageSize the maximum number of scans to return
+ * @param direction whether to return scans older or newer than the cursor
+ * @param scans a reference to a vector that will be populated with the page,
+ * ordered newest first
+ * @param from optional earliest created_on date to include
+ * @param to optional latest created_on date to include
+ * @return true if the operation was successful
+ */
+bool UserProfileController::getProfileScansPage(
+    int profileId, const ScanCursor& cursor, int pageSize,
+    PageDirection direction, QVector<ScanModel>& scans, const QDate& from,
+    const QDate& to) const {
+    // Open bounds are bound as sentinels so only two statements are ever
+    // prepared, one per direction
+    const QString minDate = "0000-01-01";
+    const QString maxDate = "9999-12-31";
+    const bool older = direction == PageDirection::Older;
+
+    QString cursorDate = older ? maxDate : minDate;
+    int cursorId = older ? std::numeric_limits<int>::max() : -1;
+    if (cursor.isValid()) {
+        cursorDate = cursor.createdOn.toString("yyyy-MM-dd");
+        cursorId = cursor.scanId;
+    }
+
+    try {
+        scans.clear();
+        db.queryEach(
+            older ? "SELECT " SCAN_SELECT_COLUMNS
+                    " FROM scan WHERE profile_id = ? "
+                    "AND created_on BETWEEN ? AND ? "
+                    "AND (created_on, scan_id) < (?, ?) "
+                    "ORDER BY created_on DESC, scan_id DESC LIMIT ?;"
+                  : "SELECT " SCAN_SELECT_COLUMNS
+                    " FROM scan WHERE profile_id = ? "
+                    "AND created_on BETWEEN ? AND ? "
+                    "AND (created_on, scan_id) > (?, ?) "
+                    "ORDER BY created_on ASC, scan_id ASC LIMIT ?;",
+            {profileId, from.isValid() ? from.toString("yyyy-MM-dd") : minDate,
+             to.isValid() ? to.toString("yyyy-MM-dd") : maxDate, cursorDate,
+             cursorId, pageSize},
+            [&scans](const QSqlQuery& row) { scans.append(scanFromRow(row)); });
+
+        // Newer pages are read oldest first; flip them to match display order
+        if (!older) std::reverse(scans.begin(), scans.end());
+        return true;
+
+    } catch (const std::exception& e) {
+        scans.clear();
+        qCritical() << "Failed to get profile scans page: " << e.what();
+        return false;
+    }
+}
+
+/**
+ * @brief Loads one page of a profile's scans on the global thread pool. See
+ * getProfileScansPage for the parameters.
+ * @return a future holding the page, empty if loading failed
+ */
+QFuture<QVector<ScanModel>> UserProfileController::getProfileScansPageAsync(
+    int profileId, const ScanCursor& cursor, int pageSize,
+    PageDirection direction, const QDate& from, const QDate& to) const {
+    return QtConcurrent::run([this, profileId, cursor, pageSize, direction,
+                              from, to]() {
+        QVector<ScanModel> scans;
+        getProfileScansPage(profileId, cursor, pageSize, direction, scans,
+                            from, to);
+        return scans;
+    });
+}
+
+/**
+ * @brief Builds a profile from a row selected with PROFILE_SELECT_COLUMNS
+ * @param row the query positioned on the row to read
+ * @return the profile
+ */
+ProfileModel UserProfileController::profileFromRow(const QSqlQuery& row) {
+    return ProfileModel(row.value(0).toInt(), row.value(1).toInt(),
+                        row.value(2).toString(), row.value(3).toString(),
+                        row.value(4).toString(), row.value(5).toInt(),
+                        row.value(6).toInt(), row.value(7).toDate());
+}
+
+/**
+ * @brief Builds a scan from a row selected with SCAN_SELECT_COLUMNS
+ * @param row the query positioned on the row to read
+ * @return the scan
+ */
+ScanModel UserProfileController::scanFromRow(const QSqlQuery& row) {
+    return ScanModel(
+        row.value(ScanColumn::ScanId).toInt(),
+        row.value(ScanColumn::ProfileId).toInt(),
+        row.value(ScanColumn::H1Lung).toInt(),
+        row.value(ScanColumn::H1LungR).toInt(),
+        row.value(ScanColumn::H2HeartConstrictor).toInt(),
+        row.value(ScanColumn::H2HeartConstrictorR).toInt(),
+        row.value(ScanColumn::H3Heart).toInt(),
+        row.value(ScanColumn::H3HeartR).toInt(),
+        row.value(ScanColumn::H4SmallIntestine).toInt(),
+        row.value(ScanColumn::H4SmallIntestineR).toInt(),
+        row.value(ScanColumn::H5TripleHeater).toInt(),
+        row.value(ScanColumn::H5TripleHeaterR).toInt(),
+        row.value(ScanColumn::H6LargeIntestine).toInt(),
+        row.value(ScanColumn::H6LargeIntestineR).toInt(),
+
+        row.value(ScanColumn::F1Spleen).toInt(),
+        row.value(ScanColumn::F1SpleenR).toInt(),
+        row.value(ScanColumn::F2Liver).toInt(),
+        row.value(ScanColumn::F2LiverR).toInt(),
+        row.value(ScanColumn::F3Kidney).toInt(),
+        row.value(ScanColumn::F3KidneyR).toInt(),
+        row.value(ScanColumn::F4UrinaryBladder).toInt(),
+        row.value(ScanColumn::F4UrinaryBladderR).toInt(),
+        row.value(ScanColumn::F5GallBladder).toInt(),
+        row.value(ScanColumn::F5GallBladderR).toInt(),
+        row.value(ScanColumn::F6Stomach).toInt(),
+        row.value(ScanColumn::F6StomachR).toInt(),
+
+        row.value(ScanColumn::CreatedOn).toDate(),
+
+        row.value(ScanColumn::BodyTemp).toInt(),
+        row.value(ScanColumn::BloodPressure).toInt(),
+        row.value(ScanColumn::HeartRate).toInt(),
+        row.value(ScanColumn::SleepingTime).toInt(),
+        row.value(ScanColumn::CurrentWeight).toInt(),
+        row.value(ScanColumn::EmotionalState).toInt(),
+        row.value(ScanColumn::OverallFeeling).toInt(),
+        row.value(ScanColumn::Name).toString(),
+        row.value(ScanColumn::Notes).toString());
+}
@@ -10,11 +10,22 @@
 #ifdef QT_DEBUG
 #include "DatabaseManager.h"
 #include "DatabaseManagerTest.h"
+#include "DeviceStreamTest.h"
+#include "DeviceTraceTest.h"
 #include "HealthMetricCalculatorTest.h"
+#include "IndicatorKernelTest.h"
 #include "Logging.h"
+#include "PopulationControllerTest.h"
 #include "ProfileModelTest.h"
+#include "ProfileSummaryControllerTest.h"
+#include "QuantileSketchTest.h"
 #include "ScanModelTest.h"
+#include "ScanResultControllerTest.h"
+#include "ScanSessionTest.h"
+#include "SignalPipelineTest.h"
+#include "SimulationClockTest.h"
 #include "Test.h"
+#include "TrendControllerTest.h"
 #include "UserModelTest.h"
 #include "UserProfileControllerTest.h"
 #include "UserControllerTest.h"
@@ -34,12 +45,17 @@ int main(int argc, char* argv[]) {
 
 #ifdef QT_DEBUG
     DEBUG("\n***Start testing***\n");
-    DatabaseManager db;
+    DatabaseManager db(true);
     QVector<Test*> tests = {
         new DatabaseManagerTest(db),      new UserModelTest(),
         new ProfileModelTest(),           new ScanModelTest(),
         new HealthMetricCalculatorTest(), new UserProfileControllerTest(db),
-        new UserControllerTest(db)
+        new UserControllerTest(db),       new IndicatorKernelTest(),
+        new TrendControllerTest(),        new ScanResultControllerTest(),
+        new ProfileSummaryControllerTest(), new QuantileSketchTest(),
+        new PopulationControllerTest(),   new DeviceStreamTest(),
+        new SignalPipelineTest(),         new DeviceTraceTest(),
+        new SimulationClockTest(),        new ScanSessionTest()
     };
 
     // Run & delete tests
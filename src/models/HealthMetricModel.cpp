@@ -5,29 +5,77 @@
 
 #include "HealthMetricModel.h"
 
-HealthMetricModel::HealthMetricModel() {}
-HealthMetricModel::HealthMetricModel(QString name, float value, QString desc, int level): 
-    name(name), value(value), desc(desc), level(level) 
-{}
-HealthMetricModel::~HealthMetricModel() {}
+namespace {
 
-QString HealthMetricModel::getName() const { return name; }
-void HealthMetricModel::setName(QString name) { this->name = name; }
+const char* const NAMES[HealthMetric::Count] = {
+    "Lung",
+    "Heart Constrictor",
+    "Heart",
+    "Small Intestine",
+    "Triple Heater",
+    "Large Intestine",
+    "Spleen",
+    "Liver",
+    "Kidney",
+    "Urinary Bladder",
+    "Gall Bladder",
+    "Stomach",
+
+    "Energy Level",
+    "Immune system",
+    "Metabolism",
+    "Psycho-emotional state",
+    "Musculoskeletal system",
+
+    "Energy level trend",
+    "Immune system trend",
+    "Metabolism trend",
+    "Psycho-emotional state trend",
+    "Musculoskeletal system trend"};
+
+// Indexed by kind (organ, indicator, trend), then level + 1
+const char* const DESCRIPTIONS[3][3] = {
+    {"Organ below normal", "Organ is normal", "Organ above normal"},
+    {"Below Normal", "Normal", "Above Normal"},
+    {"Trending Down", "Trending Sideways", "Trending Up"}};
+
+int kindOf(HealthMetric::Id id) {
+    if (id >= HealthMetric::FirstTrend) return 2;
+    if (id >= HealthMetric::FirstIndicator) return 1;
+    return 0;
+}
+
+}  // namespace
+
+HealthMetricModel::HealthMetricModel()
+    : value(0), id(HealthMetric::Lung), level(0) {}
+HealthMetricModel::HealthMetricModel(HealthMetric::Id id, float value,
+                                     int level)
+    : value(value), id(id), level(static_cast<int8_t>(level)) {}
+
+HealthMetric::Id HealthMetricModel::getId() const { return id; }
+
+QLatin1String HealthMetricModel::getName() const {
+    return QLatin1String(NAMES[id]);
+}
 
 float HealthMetricModel::getValue() const { return value; }
 void HealthMetricModel::setValue(float value) { this->value = value; }
 
-QString HealthMetricModel::getDesc() const { return desc; }
-void HealthMetricModel::setDesc(QString desc) { this->desc = desc; }
+QLatin1String HealthMetricModel::getDesc() const {
+    const int row = level > 0 ? 2 : (level < 0 ? 0 : 1);
+    return QLatin1String(DESCRIPTIONS[kindOf(id)][row]);
+}
 
 int HealthMetricModel::getLevel() const { return level; }
-void HealthMetricModel::setLevel(int level) { this->level = level; }
+void HealthMetricModel::setLevel(int level) {
+    this->level = static_cast<int8_t>(level);
+}
 
-QString HealthMetricModel::toString() {
+QString HealthMetricModel::toString() const {
     return QString("Name: %1\nValue: %2\nDesc: %3\nLevel:%4")
-        .arg(name)
+        .arg(getName())
         .arg(value)
-        .arg(desc)
+        .arg(getDesc())
         .arg(level);
 }
-
@@ -0,0 +1,51 @@
+/**
+ * @file ScanBatch.cpp
+ * @brief A column-wise collection of scans for bulk analytics.
+ */
+
+#include "ScanBatch.h"
+
+ScanBatch::ScanBatch() {}
+
+int ScanBatch::size() const { return ids.size(); }
+
+bool ScanBatch::isEmpty() const { return ids.isEmpty(); }
+
+void ScanBatch::reserve(int rows) {
+    ids.reserve(rows);
+    createdOn.reserve(rows);
+    for (QVector<int16_t>& column : columns) column.reserve(rows);
+}
+
+void ScanBatch::clear() {
+    ids.clear();
+    createdOn.clear();
+    for (QVector<int16_t>& column : columns) column.clear();
+}
+
+void ScanBatch::append(int id, const QDate& date,
+                       const Measurements& readings) {
+    ids.append(id);
+    createdOn.append(date);
+    for (int point = 0; point < MeridianPoint::Count; ++point)
+        columns[point].append(readings[point]);
+}
+
+void ScanBatch::append(const ScanModel& scan) {
+    append(scan.getId(), scan.getCreatedOn(), scan.getMeasurements());
+}
+
+const int16_t* ScanBatch::column(int point) const {
+    return columns[point].constData();
+}
+
+const QVector<int>& ScanBatch::getIds() const { return ids; }
+
+const QVector<QDate>& ScanBatch::getCreatedOn() const { return createdOn; }
+
+Measurements ScanBatch::readingsAt(int row) const {
+    Measurements readings;
+    for (int point = 0; point < MeridianPoint::Count; ++point)
+        readings[point] = columns[point][row];
+    return readings;
+}
@@ -6,13 +6,26 @@
 #include "ScanModel.h"
 
 #include <QDebug>
+#include <limits>
+
+namespace {
+/**
+ * @brief Narrows a reading to the stored width, saturating out-of-range
+ * values instead of wrapping them.
+ */
+int16_t toReading(int value) {
+    return static_cast<int16_t>(
+        qBound<int>(std::numeric_limits<int16_t>::min(), value,
+                    std::numeric_limits<int16_t>::max()));
+}
+}  // namespace
 
 const QVector<QString> ScanModel::organNames = {
     "Lung",          "Heart Constrictor", "Heart",        "Small Intestine",
     "Triple Heater", "Large Intestine",   "Spleen",       "Liver",
     "Kidney",        "Urinary Bladder",   "Gall Bladder", "Stomach"};
 
-ScanModel::ScanModel() {}
+ScanModel::ScanModel() : id(-1), profileId(-1), measurements{} {}
 
 ScanModel::ScanModel(int id, int profileId,
 
@@ -50,31 +63,30 @@ ScanModel::ScanModel(int id, int profileId,
     : id(id),
       profileId(profileId),
 
-      h1Lung(h1Lung),
-      h1LungR(h1LungR),
-      h2HeartConstrictor(h2HeartConstrictor),
-      h2HeartConstrictorR(h2HeartConstrictorR),
-      h3Heart(h3Heart),
-      h3HeartR(h3HeartR),
-      h4SmallIntestine(h4SmallIntestine),
-      h4SmallIntestineR(h4SmallIntestineR),
-      h5TripleHeater(h5TripleHeater),
-      h5TripleHeaterR(h5TripleHeaterR),
-      h6LargeIntestine(h6LargeIntestine),
-      h6LargeIntestineR(h6LargeIntestineR),
-
-      f1Spleen(f1Spleen),
-      f1SpleenR(f1SpleenR),
-      f2Liver(f2Liver),
-      f2LiverR(f2LiverR),
-      f3Kidney(f3Kidney),
-      f3KidneyR(f3KidneyR),
-      f4UrinaryBladder(f4UrinaryBladder),
-      f4UrinaryBladderR(f4UrinaryBladderR),
-      f5GallBladder(f5GallBladder),
-      f5GallBladderR(f5GallBladderR),
-      f6Stomach(f6Stomach),
-      f6StomachR(f6StomachR),
+      measurements{{toReading(h1Lung),
+                     toReading(h1LungR),
+                     toReading(h2HeartConstrictor),
+                     toReading(h2HeartConstrictorR),
+                     toReading(h3Heart),
+                     toReading(h3HeartR),
+                     toReading(h4SmallIntestine),
+                     toReading(h4SmallIntestineR),
+                     toReading(h5TripleHeater),
+                     toReading(h5TripleHeaterR),
+                     toReading(h6LargeIntestine),
+                     toReading(h6LargeIntestineR),
+                     toReading(f1Spleen),
+                     toReading(f1SpleenR),
+                     toReading(f2Liver),
+                     toReading(f2LiverR),
+                     toReading(f3Kidney),
+                     toReading(f3KidneyR),
+                     toReading(f4UrinaryBladder),
+                     toReading(f4UrinaryBladderR),
+                     toReading(f5GallBladder),
+                     toReading(f5GallBladderR),
+                     toReading(f6Stomach),
+                     toReading(f6StomachR)}},
       createdOn(createdOn),
 
       // optional fields
@@ -86,56 +98,7 @@ ScanModel::ScanModel(int id, int profileId,
       emotionalState(emotionalState),
       overallFeeling(overallFeeling),
       name(name),
-      notes(notes) {
-    measurements = {h1Lung,
-                    h1LungR,
-                    h2HeartConstrictor,
-                    h2HeartConstrictorR,
-                    h3Heart,
-                    h3HeartR,
-                    h4SmallIntestine,
-                    h4SmallIntestineR,
-                    h5TripleHeater,
-                    h5TripleHeaterR,
-                    h6LargeIntestine,
-                    h6LargeIntestineR,
-                    f1Spleen,
-                    f1SpleenR,
-                    f2Liver,
-                    f2LiverR,
-                    f3Kidney,
-                    f3KidneyR,
-                    f4UrinaryBladder,
-                    f4UrinaryBladderR,
-                    f5GallBladder,
-                    f5GallBladderR,
-                    f6Stomach,
-                    f6StomachR};
-
-    upperMeasurements = {
-        h1Lung,          h2HeartConstrictor,
-        h3Heart,         h4SmallIntestine,
-        h5TripleHeater,  h6LargeIntestine,
-        h1LungR,         h2HeartConstrictorR,
-        h3HeartR,        h4SmallIntestineR,
-        h5TripleHeaterR, h6LargeIntestineR,
-    };
-
-    lowerMeasurements = {f1Spleen,          f2Liver,        f3Kidney,
-                         f4UrinaryBladder,  f5GallBladder,  f6Stomach,
-                         f1SpleenR,         f2LiverR,       f3KidneyR,
-                         f4UrinaryBladderR, f5GallBladderR, f6StomachR};
-
-    rightMeasurements = {
-        h1LungR,         h2HeartConstrictorR, h3HeartR,       h4SmallIntestineR,
-        h5TripleHeaterR, h6LargeIntestineR,   f1SpleenR,      f2LiverR,
-        f3KidneyR,       f4UrinaryBladderR,   f5GallBladderR, f6StomachR};
-
-    leftMeasurements = {
-        h1Lung,         h2HeartConstrictor, h3Heart,       h4SmallIntestine,
-        h5TripleHeater, h6LargeIntestine,   f1Spleen,      f2Liver,
-        f3Kidney,       f4UrinaryBladder,   f5GallBladder, f6Stomach};
-}
+      notes(notes) {}
 
 ScanModel::~ScanModel() {}
 
@@ -148,126 +111,203 @@ int ScanModel::getProfileId() const { return profileId; }
 void ScanModel::setProfileId(int id) { this->profileId = id; }
 
 // Meridian Points (Left)
-int ScanModel::getH1Lung() const { return h1Lung; }
+int ScanModel::getH1Lung() const {
+    return measurements[MeridianPoint::H1Lung];
+}
 
-void ScanModel::setH1Lung(int h1Lung) { this->h1Lung = h1Lung; }
+void ScanModel::setH1Lung(int h1Lung) {
+    measurements[MeridianPoint::H1Lung] = toReading(h1Lung);
+}
 
-int ScanModel::getH2HeartConstrictor() const { return h2HeartConstrictor; }
+int ScanModel::getH2HeartConstrictor() const {
+    return measurements[MeridianPoint::H2HeartConstrictor];
+}
 
 void ScanModel::setH2HeartConstrictor(int h2HeartConstrictor) {
-    this->h2HeartConstrictor = h2HeartConstrictor;
+    measurements[MeridianPoint::H2HeartConstrictor] =
+        toReading(h2HeartConstrictor);
 }
 
-int ScanModel::getH3Heart() const { return h3Heart; }
+int ScanModel::getH3Heart() const {
+    return measurements[MeridianPoint::H3Heart];
+}
 
-void ScanModel::setH3Heart(int h3Heart) { this->h3Heart = h3Heart; }
+void ScanModel::setH3Heart(int h3Heart) {
+    measurements[MeridianPoint::H3Heart] = toReading(h3Heart);
+}
 
-int ScanModel::getH4SmallIntestine() const { return h4SmallIntestine; }
+int ScanModel::getH4SmallIntestine() const {
+    return measurements[MeridianPoint::H4SmallIntestine];
+}
 
 void ScanModel::setH4SmallIntestine(int h4SmallIntestine) {
-    this->h4SmallIntestine = h4SmallIntestine;
+    measurements[MeridianPoint::H4SmallIntestine] = toReading(h4SmallIntestine);
 }
 
-int ScanModel::getH5TripleHeater() const { return h5TripleHeater; }
+int ScanModel::getH5TripleHeater() const {
+    return measurements[MeridianPoint::H5TripleHeater];
+}
 
 void ScanModel::setH5TripleHeater(int h5TripleHeater) {
-    this->h5TripleHeater = h5TripleHeater;
+    measurements[MeridianPoint::H5TripleHeater] = toReading(h5TripleHeater);
 }
 
-int ScanModel::getH6LargeIntestine() const { return h6LargeIntestine; }
+int ScanModel::getH6LargeIntestine() const {
+    return measurements[MeridianPoint::H6LargeIntestine];
+}
 
 void ScanModel::setH6LargeIntestine(int h6LargeIntestine) {
-    this->h6LargeIntestine = h6LargeIntestine;
+    measurements[MeridianPoint::H6LargeIntestine] = toReading(h6LargeIntestine);
 }
 
-int ScanModel::getF1Spleen() const { return f1Spleen; }
+int ScanModel::getF1Spleen() const {
+    return measurements[MeridianPoint::F1Spleen];
+}
 
-void ScanModel::setF1Spleen(int f1Spleen) { this->f1Spleen = f1Spleen; }
+void ScanModel::setF1Spleen(int f1Spleen) {
+    measurements[MeridianPoint::F1Spleen] = toReading(f1Spleen);
+}
 
-int ScanModel::getF2Liver() const { return f2Liver; }
+int ScanModel::getF2Liver() const {
+    return measurements[MeridianPoint::F2Liver];
+}
 
-void ScanModel::setF2Liver(int f2Liver) { this->f2Liver = f2Liver; }
+void ScanModel::setF2Liver(int f2Liver) {
+    measurements[MeridianPoint::F2Liver] = toReading(f2Liver);
+}
 
-int ScanModel::getF3Kidney() const { return f3Kidney; }
+int ScanModel::getF3Kidney() const {
+    return measurements[MeridianPoint::F3Kidney];
+}
 
-void ScanModel::setF3Kidney(int f3Kidney) { this->f3Kidney = f3Kidney; }
+void ScanModel::setF3Kidney(int f3Kidney) {
+    measurements[MeridianPoint::F3Kidney] = toReading(f3Kidney);
+}
 
-int ScanModel::getF4UrinaryBladder() const { return f4UrinaryBladder; }
+int ScanModel::getF4UrinaryBladder() const {
+    return measurements[MeridianPoint::F4UrinaryBladder];
+}
 
 void ScanModel::setF4UrinaryBladder(int f4UrinaryBladder) {
-    this->f4UrinaryBladder = f4UrinaryBladder;
+    measurements[MeridianPoint::F4UrinaryBladder] = toReading(f4UrinaryBladder);
 }
 
-int ScanModel::getF5GallBladder() const { return f5GallBladder; }
+int ScanModel::getF5GallBladder() const {
+    return measurements[MeridianPoint::F5GallBladder];
+}
 
 void ScanModel::setF5GallBladder(int f5GallBladder) {
-    this->f5GallBladder = f5GallBladder;
+    measurements[MeridianPoint::F5GallBladder] = toReading(f5GallBladder);
 }
 
-int ScanModel::getF6Stomach() const { return f6Stomach; }
+int ScanModel::getF6Stomach() const {
+    return measurements[MeridianPoint::F6Stomach];
+}
 
-void ScanModel::setF6Stomach(int f6Stomach) { this->f6Stomach = f6Stomach; }
+void ScanModel::setF6Stomach(int f6Stomach) {
+    measurements[MeridianPoint::F6Stomach] = toReading(f6Stomach);
+}
 
 // Meridian Points (Right)
-int ScanModel::getH1LungR() const { return h1LungR; }
+int ScanModel::getH1LungR() const {
+    return measurements[MeridianPoint::H1LungR];
+}
 
-void ScanModel::setH1LungR(int h1LungR) { this->h1LungR = h1LungR; }
+void ScanModel::setH1LungR(int h1LungR) {
+    measurements[MeridianPoint::H1LungR] = toReading(h1LungR);
+}
 
-int ScanModel::getH2HeartConstrictorR() const { return h2HeartConstrictorR; }
+int ScanModel::getH2HeartConstrictorR() const {
+    return measurements[MeridianPoint::H2HeartConstrictorR];
+}
 
 void ScanModel::setH2HeartConstrictorR(int h2HeartConstrictorR) {
-    this->h2HeartConstrictorR = h2HeartConstrictorR;
+    measurements[MeridianPoint::H2HeartConstrictorR] =
+        toReading(h2HeartConstrictorR);
 }
 
-int ScanModel::getH3HeartR() const { return h3HeartR; }
+int ScanModel::getH3HeartR() const {
+    return measurements[MeridianPoint::H3HeartR];
+}
 
-void ScanModel::setH3HeartR(int h3HeartR) { this->h3HeartR = h3HeartR; }
+void ScanModel::setH3HeartR(int h3HeartR) {
+    measurements[MeridianPoint::H3HeartR] = toReading(h3HeartR);
+}
 
-int ScanModel::getH4SmallIntestineR() const { return h4SmallIntestineR; }
+int ScanModel::getH4SmallIntestineR() const {
+    return measurements[MeridianPoint::H4SmallIntestineR];
+}
 
 void ScanModel::setH4SmallIntestineR(int h4SmallIntestineR) {
-    this->h4SmallIntestineR = h4SmallIntestineR;
+    measurements[MeridianPoint::H4SmallIntestineR] =
+        toReading(h4SmallIntestineR);
 }
 
-int ScanModel::getH5TripleHeaterR() const { return h5TripleHeaterR; }
+int ScanModel::getH5TripleHeaterR() const {
+    return measurements[MeridianPoint::H5TripleHeaterR];
+}
 
 void ScanModel::setH5TripleHeaterR(int h5TripleHeaterR) {
-    this->h5TripleHeaterR = h5TripleHeaterR;
+    measurements[MeridianPoint::H5TripleHeaterR] = toReading(h5TripleHeaterR);
 }
 
-int ScanModel::getH6LargeIntestineR() const { return h6LargeIntestineR; }
+int ScanModel::getH6LargeIntestineR() const {
+    return measurements[MeridianPoint::H6LargeIntestineR];
+}
 
 void ScanModel::setH6LargeIntestineR(int h6LargeIntestineR) {
-    this->h6LargeIntestineR = h6LargeIntestineR;
+    measurements[MeridianPoint::H6LargeIntestineR] =
+        toReading(h6LargeIntestineR);
 }
 
-int ScanModel::getF1SpleenR() const { return f1SpleenR; }
+int ScanModel::getF1SpleenR() const {
+    return measurements[MeridianPoint::F1SpleenR];
+}
 
-void ScanModel::setF1SpleenR(int f1SpleenR) { this->f1SpleenR = f1SpleenR; }
+void ScanModel::setF1SpleenR(int f1SpleenR) {
+    measurements[MeridianPoint::F1SpleenR] = toReading(f1SpleenR);
+}
 
-int ScanModel::getF2LiverR() const { return f2LiverR; }
+int ScanModel::getF2LiverR() const {
+    return measurements[MeridianPoint::F2LiverR];
+}
 
-void ScanModel::setF2LiverR(int f2LiverR) { this->f2LiverR = f2LiverR; }
+void ScanModel::setF2LiverR(int f2LiverR) {
+    measurements[MeridianPoint::F2LiverR] = toReading(f2LiverR);
+}
 
-int ScanModel::getF3KidneyR() const { return f3KidneyR; }
+int ScanModel::getF3KidneyR() const {
+    return measurements[MeridianPoint::F3KidneyR];
+}
 
-void ScanModel::setF3KidneyR(int f3KidneyR) { this->f3KidneyR = f3KidneyR; }
+void ScanModel::setF3KidneyR(int f3KidneyR) {
+    measurements[MeridianPoint::F3KidneyR] = toReading(f3KidneyR);
+}
 
-int ScanModel::getF4UrinaryBladderR() const { return f4UrinaryBladderR; }
+int ScanModel::getF4UrinaryBladderR() const {
+    return measurements[MeridianPoint::F4UrinaryBladderR];
+}
 
 void ScanModel::setF4UrinaryBladderR(int f4UrinaryBladderR) {
-    this->f4UrinaryBladderR = f4UrinaryBladderR;
+    measurements[MeridianPoint::F4UrinaryBladderR] =
+        toReading(f4UrinaryBladderR);
 }
 
-int ScanModel::getF5GallBladderR() const { return f5GallBladderR; }
+int ScanModel::getF5GallBladderR() const {
+    return measurements[MeridianPoint::F5GallBladderR];
+}
 
 void ScanModel::setF5GallBladderR(int f5GallBladderR) {
-    this->f5GallBladderR = f5GallBladderR;
+    measurements[MeridianPoint::F5GallBladderR] = toReading(f5GallBladderR);
 }
 
-int ScanModel::getF6StomachR() const { return f6StomachR; }
+int ScanModel::getF6StomachR() const {
+    return measurements[MeridianPoint::F6StomachR];
+}
 
-void ScanModel::setF6StomachR(int f6StomachR) { this->f6StomachR = f6StomachR; }
+void ScanModel::setF6StomachR(int f6StomachR) {
+    measurements[MeridianPoint::F6StomachR] = toReading(f6StomachR);
+}
 
 int ScanModel::getBodyTemp() const { return bodyTemp; }
 
@@ -321,69 +361,28 @@ void ScanModel::setCreatedOn(const QDate& createdOn) {
     this->createdOn = createdOn;
 }
 
-const QVector<int>& ScanModel::getMeasurements() const { return measurements; }
+const Measurements& ScanModel::getMeasurements() const {
+    return measurements;
+}
 
-void ScanModel::setMeasurements(const QVector<int>& newMeasurements) {
+void ScanModel::setMeasurements(const Measurements& newMeasurements) {
     measurements = newMeasurements;
+}
+
+MeasurementView ScanModel::getUpperMeasurements() const {
+    return MeasurementView(measurements.data(), UPPER_LAYOUT, SIDE_POINTS);
+}
+
+MeasurementView ScanModel::getLowerMeasurements() const {
+    return MeasurementView(measurements.data(), LOWER_LAYOUT, SIDE_POINTS);
+}
+
+MeasurementView ScanModel::getRightMeasurements() const {
+    return MeasurementView(measurements.data(), RIGHT_LAYOUT, SIDE_POINTS);
+}
 
-    // Update the grouped measurements
-    if (measurements.size() >= 24) {
-        upperMeasurements = {
-            measurements[0],  measurements[1],
-            measurements[2],  // h1-h3 Left
-            measurements[3],  measurements[4],
-            measurements[5],  // h4-h6 Left
-            measurements[12], measurements[13],
-            measurements[14],  // h1-h3 Right
-            measurements[15], measurements[16],
-            measurements[17]  // h4-h6 Right
-        };
-
-        lowerMeasurements = {
-            measurements[6],  measurements[7],
-            measurements[8],  // f1-f3 Left
-            measurements[9],  measurements[10],
-            measurements[11],  // f4-f6 Left
-            measurements[18], measurements[19],
-            measurements[20],  // f1-f3 Right
-            measurements[21], measurements[22],
-            measurements[23]  // f4-f6 Right
-        };
-
-        leftMeasurements = {
-            measurements[0], measurements[1],  measurements[2],  // h1-h3 Left
-            measurements[3], measurements[4],  measurements[5],  // h4-h6 Left
-            measurements[6], measurements[7],  measurements[8],  // f1-f3 Left
-            measurements[9], measurements[10], measurements[11]  // f4-f6 Left
-        };
-
-        rightMeasurements = {
-            measurements[12], measurements[13],
-            measurements[14],  // h1-h3 Right
-            measurements[15], measurements[16],
-            measurements[17],  // h4-h6 Right
-            measurements[18], measurements[19],
-            measurements[20],  // f1-f3 Right
-            measurements[21], measurements[22],
-            measurements[23]  // f4-f6 Right
-        };
-    }
-}
-
-const QVector<int>& ScanModel::getUpperMeasurements() const {
-    return upperMeasurements;
-}
-
-const QVector<int>& ScanModel::getLowerMeasurements() const {
-    return lowerMeasurements;
-}
-
-const QVector<int>& ScanModel::getRightMeasurements() const {
-    return rightMeasurements;
-}
-
-const QVector<int>& ScanModel::getLeftMeasurements() const {
-    return leftMeasurements;
+MeasurementView ScanModel::getLeftMeasurements() const {
+    return MeasurementView(measurements.data(), LEFT_LAYOUT, SIDE_POINTS);
 }
 
 const QVector<QString>& ScanModel::getOrganNames() { return organNames; }
@@ -426,30 +425,30 @@ QString ScanModel::toString() const {
                "Notes: %34")
         .arg(id)
         .arg(name)
-        .arg(h1Lung)
-        .arg(h1LungR)
-        .arg(h2HeartConstrictor)
-        .arg(h2HeartConstrictorR)
-        .arg(h3Heart)
-        .arg(h3HeartR)
-        .arg(h4SmallIntestine)
-        .arg(h4SmallIntestineR)
-        .arg(h5TripleHeater)
-        .arg(h5TripleHeaterR)
-        .arg(h6LargeIntestine)
-        .arg(h6LargeIntestineR)
-        .arg(f1Spleen)
-        .arg(f1SpleenR)
-        .arg(f2Liver)
-        .arg(f2LiverR)
-        .arg(f3Kidney)
-        .arg(f3KidneyR)
-        .arg(f4UrinaryBladder)
-        .arg(f4UrinaryBladderR)
-        .arg(f5GallBladder)
-        .arg(f5GallBladderR)
-        .arg(f6Stomach)
-        .arg(f6StomachR)
+        .arg(measurements[MeridianPoint::H1Lung])
+        .arg(measurements[MeridianPoint::H1LungR])
+        .arg(measurements[MeridianPoint::H2HeartConstrictor])
+        .arg(measurements[MeridianPoint::H2HeartConstrictorR])
+        .arg(measurements[MeridianPoint::H3Heart])
+        .arg(measurements[MeridianPoint::H3HeartR])
+        .arg(measurements[MeridianPoint::H4SmallIntestine])
+        .arg(measurements[MeridianPoint::H4SmallIntestineR])
+        .arg(measurements[MeridianPoint::H5TripleHeater])
+        .arg(measurements[MeridianPoint::H5TripleHeaterR])
+        .arg(measurements[MeridianPoint::H6LargeIntestine])
+        .arg(measurements[MeridianPoint::H6LargeIntestineR])
+        .arg(measurements[MeridianPoint::F1Spleen])
+        .arg(measurements[MeridianPoint::F1SpleenR])
+        .arg(measurements[MeridianPoint::F2Liver])
+        .arg(measurements[MeridianPoint::F2LiverR])
+        .arg(measurements[MeridianPoint::F3Kidney])
+        .arg(measurements[MeridianPoint::F3KidneyR])
+        .arg(measurements[MeridianPoint::F4UrinaryBladder])
+        .arg(measurements[MeridianPoint::F4UrinaryBladderR])
+        .arg(measurements[MeridianPoint::F5GallBladder])
+        .arg(measurements[MeridianPoint::F5GallBladderR])
+        .arg(measurements[MeridianPoint::F6Stomach])
+        .arg(measurements[MeridianPoint::F6StomachR])
         .arg(bodyTemp)
         .arg(bloodPressure)
         .arg(heartRate)
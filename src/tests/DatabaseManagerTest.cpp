@@ -5,11 +5,15 @@
 
 #include "DatabaseManagerTest.h"
 
+#include <QThread>
+
 DatabaseManagerTest::DatabaseManagerTest(DatabaseManager& db): db(db) {}
 DatabaseManagerTest::~DatabaseManagerTest() {}
 
 bool DatabaseManagerTest::test() const {
-    return testCRUD();
+    return testCRUD() && testStatementCache() && testSchemaVersion() &&
+           testThreadConnections() && testQueryStats() && testQueryPlanCheck() &&
+           testNestedQueryEach();
 }
 
 bool DatabaseManagerTest::testCRUD() const {
@@ -89,3 +93,163 @@ bool DatabaseManagerTest::testCRUD() const {
 
     return true;
 }
+
+bool DatabaseManagerTest::testStatementCache() const {
+
+    const QString userQuery = "SELECT * FROM users WHERE user_id = ?;";
+    QList<QMap<QString, QVariant>> userRes;
+
+    qDebug() << "\nTESTING STATEMENT CACHE ******************";
+    db.query(userQuery, {1}, userRes);
+    int hits = db.getStatementCacheHits();
+    int misses = db.getStatementCacheMisses();
+
+    // Same SQL text again should reuse the prepared statement
+    db.query(userQuery, {1}, userRes);
+    if (db.getStatementCacheHits() != hits + 1 || db.getStatementCacheMisses() != misses) {
+        qDebug() << "Statement was not reused from the cache";
+        return false;
+    }
+
+    qDebug() << "Hits:" << db.getStatementCacheHits() << "Misses:" << db.getStatementCacheMisses();
+    return true;
+}
+
+bool DatabaseManagerTest::testSchemaVersion() const {
+
+    qDebug() << "\nTESTING SCHEMA VERSION ******************";
+    int version = db.schemaVersion();
+    qDebug() << "Schema version:" << version;
+
+    // Migrations run on construction, so the schema must be past version 0
+    if (version < 1) {
+        qDebug() << "Database was not migrated";
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManagerTest::testThreadConnections() const {
+
+    qDebug() << "\nTESTING WORKER THREAD CONNECTIONS ******************";
+    const QString userQuery = "SELECT user_id FROM users WHERE user_id = ?;";
+    const int threadCount = 4;
+    std::atomic<int> succeeded(0);
+
+    // Each worker opens its own connection and reads concurrently
+    QVector<QThread*> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(QThread::create([this, &userQuery, &succeeded]() {
+            try {
+                QList<QMap<QString, QVariant>> results;
+                db.query(userQuery, {1}, results);
+                if (db.isConnectionOpen()) ++succeeded;
+            } catch (const std::exception& e) {
+                qDebug() << "Worker query failed:" << e.what();
+            }
+        }));
+        threads.last()->start();
+    }
+
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    qDebug() << succeeded.load() << "of" << threadCount << "workers succeeded";
+    return succeeded == threadCount;
+}
+
+bool DatabaseManagerTest::testQueryStats() const {
+
+    qDebug() << "\nTESTING QUERY STATS ******************";
+    QList<QMap<QString, QVariant>> results;
+    db.resetQueryStats();
+
+    // Statements differing only in literals are counted together
+    const int threshold = db.getSlowQueryThreshold();
+    db.setSlowQueryThreshold(0);
+    db.query("SELECT user_id FROM users WHERE user_id = 1;", {}, results);
+    db.setSlowQueryThreshold(threshold);
+    db.query("SELECT user_id FROM  users WHERE user_id = 2;", {}, results);
+
+    StatementStats stats = db.getQueryStats("SELECT user_id FROM users WHERE user_id = ?;");
+    qDebug().noquote() << db.getQueryStatsReport();
+
+    if (stats.latency.count() != 2) {
+        qDebug() << "Expected 2 executions, got" << stats.latency.count();
+        return false;
+    }
+
+    const LatencyHistogram& latency = stats.latency;
+    return latency.percentile(50) <= latency.percentile(95) &&
+           latency.percentile(95) <= latency.percentile(99) &&
+           latency.percentile(99) <= latency.max();
+}
+
+bool DatabaseManagerTest::testQueryPlanCheck() const {
+
+    qDebug() << "\nTESTING QUERY PLAN CHECK ******************";
+    const QString searchQuery = "SELECT user_id FROM users WHERE user_id = ?;";
+    const QString constantQuery = "SELECT 1;";
+    // Answered by walking every entry of a covering index
+    const QString indexScanQuery = "SELECT COUNT(*) FROM scan;";
+    QList<QMap<QString, QVariant>> results;
+
+    db.setQueryPlanCheck(true);
+    bool passed = true;
+    try {
+        db.query(searchQuery, {1}, results);
+        db.query(constantQuery, {}, results);
+    } catch (const std::exception& e) {
+        qDebug() << "Indexed statement was rejected:" << e.what();
+        passed = false;
+    }
+
+    bool rejected = false;
+    try {
+        db.query(indexScanQuery, {}, results);
+    } catch (const std::exception&) {
+        rejected = true;
+    }
+    if (!rejected) {
+        qDebug() << "Index scan was not rejected";
+        passed = false;
+    }
+
+    // Once allowed it passes; the earlier rejection stays recorded
+    db.allowFullScan(indexScanQuery);
+    try {
+        db.query(indexScanQuery, {}, results);
+    } catch (const std::exception& e) {
+        qDebug() << "Allowed statement was rejected:" << e.what();
+        passed = false;
+    }
+    db.setQueryPlanCheck(false);
+
+    return passed && db.getFullScanStatements() == QStringList{indexScanQuery};
+}
+
+bool DatabaseManagerTest::testNestedQueryEach() const {
+
+    qDebug() << "\nTESTING NESTED QUERY EACH ******************";
+    const QString profileQuery = "SELECT profile_id FROM profile WHERE user_id = ? ORDER BY profile_id;";
+    QList<QMap<QString, QVariant>> expected;
+    db.query(profileQuery, {1}, expected);
+
+    // The visitor reruns the same SQL and empties the statement cache, which
+    // must not disturb the rows still being read
+    QList<int> visited;
+    db.queryEach(profileQuery, {1}, [this, &profileQuery, &visited](const QSqlQuery& row) {
+        visited.append(row.value(0).toInt());
+        db.queryEach(profileQuery, {-1}, [](const QSqlQuery&) {});
+        db.clearStatementCache();
+    });
+
+    bool passed = !expected.isEmpty() && visited.size() == expected.size();
+    for (int i = 0; passed && i < visited.size(); ++i)
+        passed = visited[i] == expected[i]["profile_id"].toInt();
+    if (!passed) qDebug() << "Nested queries disturbed the outer rows:" << visited;
+    return passed;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file DeviceStreamTest.cpp
+ * @brief Tests for the sample ring and DeviceController's sample streams.
+ */
+
+#include "DeviceStreamTest.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+
+namespace {
+
+// How long each stream runs, and how often the test drains it: a consumer
+// as slow as a 100 Hz UI timer
+const int STREAM_MS = 500;
+const int POLL_MS = 10;
+
+}  // namespace
+
+DeviceStreamTest::DeviceStreamTest() {}
+DeviceStreamTest::~DeviceStreamTest() {}
+
+bool DeviceStreamTest::test() const {
+    bool passed = testRingBounds();
+    passed = testRingThreads() && passed;
+    passed = testStream(DeviceController::MIN_SAMPLE_RATE) && passed;
+    passed = testStream(DeviceController::MAX_SAMPLE_RATE) && passed;
+    passed = testDeviceOff() && passed;
+
+    if (passed) qInfo() << "DeviceStreamTest: all tests passed";
+    return passed;
+}
+
+bool DeviceStreamTest::testRingBounds() const {
+    // Capacity rounds up to a power of two and a full ring refuses the rest
+    SampleRing<int> ring(5);
+    const int items[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    if (ring.capacity() != 8 || ring.push(items, 10) != 8) return false;
+    if (ring.push(items[0]) || ring.size() != 8) return false;
+
+    // Reads come out in order and wrap around the end
+    int out[10];
+    if (ring.pop(out, 5) != 5 || out[4] != 4) return false;
+    if (ring.push(items, 5) != 5 || ring.pop(out, 10) != 8) return false;
+    if (out[0] != 5 || out[2] != 7 || out[3] != 0 || out[7] != 4) {
+        qCritical() << "DeviceStreamTest: ring returned items out of order";
+        return false;
+    }
+    return ring.isEmpty() && ring.pop(out, 1) == 0;
+}
+
+/**
+ * @brief Pushes a counting sequence from a second thread while this one
+ * pops it, and checks that nothing is lost, repeated or reordered. The rate
+ * is reported as the ring's ceiling. Both sides yield when they cannot make
+ * progress, so the test also runs on a single core.
+ */
+bool DeviceStreamTest::testRingThreads() const {
+    const int total = 4000000;
+    SampleRing<int> ring(1024);
+
+    QThread* producer = QThread::create([&ring]() {
+        int block[64];
+        int next = 0;
+        while (next < total) {
+            const int count = std::min(64, total - next);
+            for (int i = 0; i < count; ++i) block[i] = next + i;
+            const int pushed = ring.push(block, count);
+            if (pushed == 0) QThread::yieldCurrentThread();
+            next += pushed;
+        }
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    producer->start();
+
+    int block[256];
+    int expected = 0;
+    bool ordered = true;
+    while (expected < total) {
+        const int count = ring.pop(block, 256);
+        if (count == 0) QThread::yieldCurrentThread();
+        for (int i = 0; i < count; ++i) ordered &= block[i] == expected + i;
+        expected += count;
+    }
+    producer->wait();
+    delete producer;
+
+    qInfo() << "DeviceStreamTest: ring moved" << total << "items in"
+            << timer.elapsed() << "ms";
+    if (!ordered) qCritical() << "DeviceStreamTest: ring lost or reordered";
+    return ordered;
+}
+
+/**
+ * @brief Streams for a while at a rate and drains the ring the way a slow
+ * consumer would. Checks the rate, the sample clock and that nothing was
+ * dropped, and reports how full the ring got.
+ */
+bool DeviceStreamTest::testStream(int sampleRate) const {
+    DeviceController device;
+    device.setDeviceOn(true);
+
+    StreamConfig config;
+    config.sampleRate = sampleRate;
+    config.seed = 7;
+    if (!device.startStream(3, config)) return false;
+
+    QVector<DeviceSample> samples;
+    DeviceSample block[1024];
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < STREAM_MS) {
+        QThread::msleep(POLL_MS);
+        for (int count; (count = device.readSamples(block, 1024)) > 0;)
+            for (int i = 0; i < count; ++i) samples.append(block[i]);
+    }
+    device.stopStream();
+    const qint64 elapsed = timer.elapsed();
+    for (int count; (count = device.readSamples(block, 1024)) > 0;)
+        for (int i = 0; i < count; ++i) samples.append(block[i]);
+
+    const StreamStats stats = device.getStreamStats();
+    qInfo() << "DeviceStreamTest:" << sampleRate << "Hz," << stats.produced
+            << "samples," << stats.dropped << "dropped, ring high water"
+            << stats.highWater << "of" << stats.capacity;
+
+    if (stats.dropped != 0 || stats.consumed != stats.produced ||
+        samples.size() != stats.produced) {
+        qCritical() << "DeviceStreamTest: consumer did not keep up";
+        return false;
+    }
+
+    // The sample clock runs at the rate, give or take the last tick
+    const qint64 expected = sampleRate * elapsed / 1000;
+    if (stats.produced < expected * 9 / 10 ||
+        stats.produced > expected * 11 / 10 + sampleRate / 100) {
+        qCritical() << "DeviceStreamTest: expected about" << expected
+                    << "samples";
+        return false;
+    }
+
+    const qint64 period = 1000000000LL / sampleRate;
+    for (int i = 0; i < samples.size(); ++i) {
+        if (samples[i].timestamp != i * period || samples[i].point != 3 ||
+            samples[i].value < 0) {
+            qCritical() << "DeviceStreamTest: bad sample" << i;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool DeviceStreamTest::testDeviceOff() const {
+    // Streams need the device on, and turning it off stops them
+    DeviceController device;
+    if (device.startStream(0)) return false;
+
+    device.setDeviceOn(true);
+    if (!device.startStream(0) || !device.isStreaming()) return false;
+    device.setDeviceOn(false);
+    return !device.isStreaming();
+}
@@ -0,0 +1,208 @@
+/**
+ * @file DeviceTraceTest.cpp
+ * @brief Tests for device traces and DeviceController's record and replay.
+ */
+
+#include "DeviceTraceTest.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QVector>
+
+#include "DeviceController.h"
+
+namespace {
+
+const int SAMPLE_RATE = DeviceController::MAX_SAMPLE_RATE;
+const int STREAM_MS = 200;
+
+// Drains a device until its stream or replay ends, like a 100 Hz consumer
+QVector<DeviceSample> drain(DeviceController& device, int pollMs) {
+    QVector<DeviceSample> samples;
+    DeviceSample block[1024];
+    for (bool more = true; more;) {
+        more = device.isStreaming();
+        QThread::msleep(pollMs);
+        QCoreApplication::processEvents();
+        for (int count; (count = device.readSamples(block, 1024)) > 0;)
+            for (int i = 0; i < count; ++i) samples.append(block[i]);
+    }
+    return samples;
+}
+
+bool sameSamples(const QVector<DeviceSample>& a,
+                 const QVector<DeviceSample>& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].timestamp != b[i].timestamp || a[i].value != b[i].value ||
+            a[i].point != b[i].point)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+DeviceTraceTest::DeviceTraceTest()
+    : path(QDir::temp().filePath("radotech-trace-test.rdt")) {}
+
+DeviceTraceTest::~DeviceTraceTest() { QFile::remove(path); }
+
+bool DeviceTraceTest::test() const {
+    bool passed = testRoundTrip();
+    passed = testDamage() && passed;
+    passed = testRecordReplay() && passed;
+    passed = testRealTime() && passed;
+
+    if (passed) qInfo() << "DeviceTraceTest: all tests passed";
+    return passed;
+}
+
+bool DeviceTraceTest::testRoundTrip() const {
+    const float values[] = {0.0f, 12.5f, 99.75f, 1e-3f, 123456.0f};
+    TraceWriter writer;
+    if (!writer.open(path)) return false;
+    writer.write(TraceRecord::Power, 1);
+    writer.write(TraceRecord::Battery, 87);
+    writer.write(TraceRecord::StreamStart, 23, SAMPLE_RATE);
+    writer.writeSamples(23, 5000000000LL, values, 5);
+    writer.write(TraceRecord::StreamStop);
+    writer.write(TraceRecord::Data, 110);
+    writer.close();
+
+    TraceReader reader;
+    if (!reader.open(path)) return false;
+    QVector<TraceEvent> events;
+    for (TraceEvent event; reader.next(event);) events.append(event);
+
+    const bool read =
+        events.size() == 6 && events[0].type == TraceRecord::Power &&
+        events[0].value == 1 && events[1].value == 87 &&
+        events[2].value == 23 && events[2].sampleRate == SAMPLE_RATE &&
+        events[3].type == TraceRecord::Samples && events[3].value == 23 &&
+        events[3].timestamp == 5000000000LL && events[3].samples.size() == 5 &&
+        events[4].type == TraceRecord::StreamStop && events[5].value == 110 &&
+        !reader.isCorrupt();
+    if (!read) {
+        qCritical() << "DeviceTraceTest: events changed in the trace";
+        return false;
+    }
+    for (int i = 0; i < 5; ++i)
+        if (events[3].samples[i] != values[i]) return false;
+
+    // Times never go backwards
+    for (int i = 1; i < events.size(); ++i)
+        if (events[i].time < events[i - 1].time) return false;
+    return true;
+}
+
+/**
+ * @brief A trace cut mid-record reads up to the cut; an unknown record type
+ * stops the reader and is reported.
+ */
+bool DeviceTraceTest::testDamage() const {
+    const float values[100] = {};
+    TraceWriter writer;
+    if (!writer.open(path)) return false;
+    writer.write(TraceRecord::Power, 1);
+    writer.writeSamples(0, 0, values, 100);
+    writer.close();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) return false;
+    QByteArray bytes = file.readAll();
+    file.resize(bytes.size() - 10);
+    file.close();
+
+    TraceReader reader;
+    TraceEvent event;
+    if (!reader.open(path) || !reader.next(event) || reader.next(event) ||
+        reader.isCorrupt())
+        return false;
+
+    bytes[8] = char(0x7f);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    file.write(bytes);
+    file.close();
+    if (!reader.open(path) || reader.next(event) || !reader.isCorrupt())
+        return false;
+
+    // A file that is not a trace is refused
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    file.write("not a trace");
+    file.close();
+    return !reader.open(path);
+}
+
+/**
+ * @brief Records a live stream and replays it at maximum speed: the replay
+ * delivers exactly the samples the device produced, and the recorded state
+ * changes. Reports the trace's size and the replay's speed.
+ */
+bool DeviceTraceTest::testRecordReplay() const {
+    QVector<DeviceSample> live;
+    qint64 traceSize = 0;
+    {
+        DeviceController device;
+        if (!device.startRecording(path)) return false;
+        device.setDeviceOn(true);
+
+        StreamConfig config;
+        config.sampleRate = SAMPLE_RATE;
+        config.seed = 21;
+        if (!device.startStream(4, config)) return false;
+        QThread::msleep(STREAM_MS);
+        device.stopStream();
+        live = drain(device, 0);
+        device.transmitData();
+        device.stopRecording();
+
+        if (device.getStreamStats().dropped != 0) return false;
+        traceSize = QFileInfo(path).size();
+    }
+
+    DeviceController replayer;
+    QElapsedTimer timer;
+    timer.start();
+    if (!replayer.startReplay(path, ReplaySpeed::Maximum)) return false;
+    const QVector<DeviceSample> replayed = drain(replayer, 1);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    qInfo() << "DeviceTraceTest:" << live.size() << "samples recorded in"
+            << traceSize << "bytes, replayed in" << elapsed / 1000 << "us";
+
+    if (!sameSamples(live, replayed)) {
+        qCritical() << "DeviceTraceTest: replay gave" << replayed.size()
+                    << "samples for" << live.size() << "recorded";
+        return false;
+    }
+    if (!replayer.isDeviceOn() || replayer.isReplaying()) {
+        qCritical() << "DeviceTraceTest: replay did not restore the state";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief A real-time replay takes about as long as the recording did and
+ * delivers the same samples as one at maximum speed.
+ */
+bool DeviceTraceTest::testRealTime() const {
+    DeviceController replayer;
+    if (!replayer.startReplay(path, ReplaySpeed::Maximum)) return false;
+    const QVector<DeviceSample> fast = drain(replayer, 1);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!replayer.startReplay(path, ReplaySpeed::RealTime)) return false;
+    const QVector<DeviceSample> paced = drain(replayer, 10);
+    const qint64 elapsed = timer.elapsed();
+
+    qInfo() << "DeviceTraceTest: real-time replay took" << elapsed << "ms";
+    return !paced.isEmpty() && sameSamples(fast, paced) &&
+           elapsed >= STREAM_MS * 8 / 10;
+}
@@ -5,13 +5,15 @@
 
 #include "HealthMetricCalculatorTest.h"
 
+#include <QElapsedTimer>
+
 HealthMetricCalculatorTest::HealthMetricCalculatorTest() {}
 HealthMetricCalculatorTest::~HealthMetricCalculatorTest() {}
 
 bool HealthMetricCalculatorTest::test() const {
 
     HealthMetricCalculator* hmc = new HealthMetricCalculator();
-    QVector<HealthMetricModel*> hms;
+    QVector<HealthMetricModel> hms;
     int id = -1;
     int profileId = 2;
     
@@ -76,25 +78,173 @@ bool HealthMetricCalculatorTest::test() const {
     qDebug() << "\nTesting HealthMetricCalculator";
     qDebug() << "\nCalculating Organ Health";
     if(!(hmc->calculateOrganHealth(&newScan, hms))) return false;
-    for(auto* hm : hms){
-        qDebug() << hm->toString();
-        delete hm;
+    for(const auto& hm : hms){
+        qDebug() << hm.toString();
     }
 
     qDebug() << "\nCalculating Indicator Health";
     if(!(hmc->calculateIndicatorHealth(&newScan, hms))) return false;
-    for(auto* hm : hms){
-        qDebug() << hm->toString();
-        delete hm;
+    for(const auto& hm : hms){
+        qDebug() << hm.toString();
     }
 
     qDebug() << "\nCalculating Trend Indicators";
     if(!(hmc->calculateTrendHealth(scans, hms))) return false;
-    for(auto* hm : hms){
-        qDebug() << hm->toString();
-        delete hm;
+    for(const auto& hm : hms){
+        qDebug() << hm.toString();
     }
+
+    bool passed = testBatch(hmc, scans);
+    passed = testDeterminism(hmc, scans) && passed;
+    passed = testScoreBatch(hmc) && passed;
     delete hmc;
+    return passed;
+}
+
+bool HealthMetricCalculatorTest::testBatch(HealthMetricCalculator* hmc, const QVector<ScanModel*>& scans) const {
+
+    qDebug() << "\nCalculating Batch Indicators";
+    ScanBatch batch;
+    for(const ScanModel* scan : scans) batch.append(*scan);
+
+    IndicatorSeries series;
+    if(!hmc->calculateIndicatorSeries(batch, series)) return false;
+
+    // Column-wise results must match the per-scan calculations
+    for(int i = 0; i < scans.size(); ++i) {
+        if(series.energy[i] != hmc->calculateEnergyHealth(scans[i]) ||
+           series.immune[i] != hmc->calculateImmuneHealth(scans[i]) ||
+           series.metabolism[i] != hmc->calculateMetabolismHealth(scans[i]) ||
+           series.psycho[i] != hmc->calculatePsychoHealth(scans[i]) ||
+           series.skeletal[i] != hmc->calculateSkeletalHealth(scans[i])) {
+            qDebug() << "Batch indicators differ for scan" << i;
+            return false;
+        }
+    }
+
+    qDebug() << "Batch indicators match";
+    return true;
+}
+
+
+bool HealthMetricCalculatorTest::testDeterminism(HealthMetricCalculator* hmc, const QVector<ScanModel*>& scans) const {
+
+    qDebug() << "\nTesting Deterministic Metabolism";
+    if(!hmc->isDeterministic()) return false;
+
+    // The same scan always scores the same
+    const float first = hmc->calculateMetabolismHealth(scans[0]);
+    if(hmc->calculateMetabolismHealth(scans[0]) != first) {
+        qDebug() << "Metabolism changed between calculations";
+        return false;
+    }
+
+    // Scans not stored yet share a key, so equal readings score equally
+    ScanModel unsaved;
+    ScanModel unsavedCopy;
+    unsaved.setMeasurements(scans[0]->getMeasurements());
+    unsavedCopy.setMeasurements(scans[0]->getMeasurements());
+    if(unsaved.getId() != -1 ||
+       hmc->calculateMetabolismHealth(&unsaved) != hmc->calculateMetabolismHealth(&unsavedCopy)) {
+        qDebug() << "Unsaved scans are not scored deterministically";
+        return false;
+    }
+
+    // Batch rows get the weights their scan gets on its own
+    ScanBatch batch;
+    for(const ScanModel* scan : scans) batch.append(*scan);
+    IndicatorSeries series;
+    if(!hmc->calculateIndicatorSeries(batch, series)) return false;
+    for(int i = 0; i < scans.size(); ++i) {
+        if(series.metabolism[i] != hmc->calculateMetabolismHealth(scans[i])) {
+            qDebug() << "Batch metabolism differs for scan" << i;
+            return false;
+        }
+    }
+
+    // Another seed gives other weights, and restoring it gives the old ones
+    hmc->setSeed(HealthMetricCalculator::DEFAULT_SEED + 1);
+    const float reseeded = hmc->calculateMetabolismHealth(scans[0]);
+    hmc->setSeed(HealthMetricCalculator::DEFAULT_SEED);
+    if(reseeded == first || hmc->calculateMetabolismHealth(scans[0]) != first) {
+        qDebug() << "Seed does not control the metabolism weights";
+        return false;
+    }
+
+    // Non-deterministic mode draws fresh weights every time
+    hmc->setDeterministic(false);
+    const bool varies = hmc->calculateMetabolismHealth(scans[0]) != hmc->calculateMetabolismHealth(scans[0]);
+    hmc->setDeterministic(true);
+    hmc->setSeed(HealthMetricCalculator::DEFAULT_SEED);
+    if(!varies) {
+        qDebug() << "Non-deterministic mode repeated its weights";
+        return false;
+    }
+
+    qDebug() << "Metabolism is deterministic";
     return true;
 }
 
+bool HealthMetricCalculatorTest::testScoreBatch(HealthMetricCalculator* hmc) const {
+
+    qDebug() << "\nTesting Batch Scoring";
+
+    // Enough scans for several chunks and a partial last one
+    const int count = 3 * HealthMetricCalculator::BATCH_CHUNK + 17;
+    ScanBatch batch;
+    batch.reserve(count);
+    QVector<ScanModel*> scans;
+    for(int i = 0; i < count; ++i) {
+        Measurements readings;
+        for(int point = 0; point < MeridianPoint::Count; ++point)
+            readings[point] = 20 + (i * 7 + point * 13) % 70;
+        batch.append(i + 1, QDate(2000, 1, 1), readings);
+
+        ScanModel* scan = new ScanModel();
+        scan->setId(i + 1);
+        scan->setMeasurements(readings);
+        scans.append(scan);
+    }
+
+    ScoreTable indicators;
+    ScoreTable organs;
+    QElapsedTimer timer;
+    timer.start();
+    bool passed = hmc->calculateIndicatorHealthBatch(batch, indicators) &&
+                  hmc->calculateOrganHealthBatch(batch, organs);
+    const qint64 batchNs = timer.nsecsElapsed();
+
+    // Every row must match the single-scan results
+    QVector<HealthMetricModel> hms;
+    timer.start();
+    for(int i = 0; passed && i < count; ++i) {
+        hmc->calculateIndicatorHealth(scans[i], hms);
+        for(int k = 0; k < hms.size(); ++k) {
+            if(indicators.value(i, k) != hms[k].getValue() ||
+               indicators.outlier(i, k) != hms[k].getLevel()) {
+                qDebug() << "Batch indicator" << k << "differs for scan" << i;
+                passed = false;
+            }
+        }
+
+        hmc->calculateOrganHealth(scans[i], hms);
+        for(int k = 0; k < hms.size(); ++k) {
+            if(organs.value(i, k) != hms[k].getValue() ||
+               organs.outlier(i, k) != hms[k].getLevel() ||
+               hms[k].getName() != ScanModel::getOrganNames()[k]) {
+                qDebug() << "Batch organ" << k << "differs for scan" << i;
+                passed = false;
+            }
+        }
+    }
+    const qint64 singleNs = timer.nsecsElapsed();
+    qDeleteAll(scans);
+
+    if(indicators.rows() != count || organs.rows() != count) passed = false;
+    if(passed) {
+        qDebug() << "Batch scores match;" << count << "scans in"
+                 << batchNs / 1000 << "us batched vs" << singleNs / 1000
+                 << "us one at a time";
+    }
+    return passed;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file IndicatorKernelTest.cpp
+ * @brief Tests for the IndicatorKernel class.
+ */
+
+#include "IndicatorKernelTest.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const float WEIGHTS[MeridianPoint::Count] = {
+    0.05f, 0.10f, 0.15f, 0.20f, 0.25f, 0.30f, 0.35f, 0.40f,
+    0.45f, 0.50f, 0.00f, 0.05f, 0.10f, 0.15f, 0.20f, 0.25f,
+    0.30f, 0.35f, 0.40f, 0.45f, 0.50f, 0.00f, 0.05f, 0.10f};
+
+// The sums the indicators used to make, one pass per reading group
+ReadingSums referenceSums(const Measurements& readings) {
+    ScanModel scan;
+    scan.setMeasurements(readings);
+
+    ReadingSums sums;
+    for (int16_t reading : scan.getUpperMeasurements()) sums.upper += reading;
+    for (int16_t reading : scan.getLowerMeasurements()) sums.lower += reading;
+    for (int16_t reading : scan.getLeftMeasurements()) sums.left += reading;
+    for (int16_t reading : scan.getRightMeasurements()) sums.right += reading;
+    sums.total = sums.upper + sums.lower;
+    for (int k = 0; k < ScanModel::SIDE_POINTS; ++k) {
+        const int left = ScanModel::LEFT_LAYOUT[k];
+        const int right = ScanModel::RIGHT_LAYOUT[k];
+        sums.weightedLeft += readings[left] + readings[left] * WEIGHTS[left];
+        sums.weightedRight +=
+            readings[right] + readings[right] * WEIGHTS[right];
+    }
+    return sums;
+}
+
+bool closeTo(float a, float b) {
+    return std::abs(a - b) <= 1e-3f * std::max(1.0f, std::abs(b));
+}
+
+}  // namespace
+
+IndicatorKernelTest::IndicatorKernelTest() {}
+IndicatorKernelTest::~IndicatorKernelTest() {}
+
+bool IndicatorKernelTest::test() const {
+    std::mt19937 generator(2024);
+    std::uniform_int_distribution<int> reading(-32768, 32767);
+
+    // Full-range readings plus the extremes, so widening is exercised
+    QVector<Measurements> scans(1003);
+    for (Measurements& scan : scans)
+        for (int16_t& value : scan)
+            value = static_cast<int16_t>(reading(generator));
+    scans[0].fill(32767);
+    scans[1].fill(-32768);
+    scans[2].fill(0);
+
+    const IndicatorKernel::Isa best = IndicatorKernel::bestSupportedIsa();
+    const IndicatorKernel::Isa isas[] = {IndicatorKernel::Isa::Scalar,
+                                         IndicatorKernel::Isa::SSE2,
+                                         IndicatorKernel::Isa::AVX2};
+
+    bool passed = true;
+    for (IndicatorKernel::Isa isa : isas) {
+        if (isa > best) continue;
+        passed = testSum(isa, scans) && passed;
+        passed = testColumns(isa, scans) && passed;
+    }
+
+    benchmark(scans);
+    IndicatorKernel::setIsa(best);
+
+    if (passed) qInfo() << "IndicatorKernelTest: all tests passed";
+    return passed;
+}
+
+bool IndicatorKernelTest::testSum(IndicatorKernel::Isa isa,
+                                  const QVector<Measurements>& scans) const {
+    IndicatorKernel::setIsa(isa);
+    for (int i = 0; i < scans.size(); ++i) {
+        const ReadingSums expected = referenceSums(scans[i]);
+        const ReadingSums actual =
+            IndicatorKernel::sum(scans[i].data(), WEIGHTS);
+        if (actual.total != expected.total || actual.upper != expected.upper ||
+            actual.lower != expected.lower || actual.left != expected.left ||
+            actual.right != expected.right ||
+            !closeTo(actual.weightedLeft, expected.weightedLeft) ||
+            !closeTo(actual.weightedRight, expected.weightedRight)) {
+            qCritical() << "IndicatorKernelTest: sum mismatch on scan" << i
+                        << "with" << IndicatorKernel::isaName(isa);
+            return false;
+        }
+
+        // Without weights the weighted sums are the plain side sums
+        const ReadingSums plain = IndicatorKernel::sum(scans[i].data());
+        if (plain.weightedLeft != expected.left ||
+            plain.weightedRight != expected.right) {
+            qCritical() << "IndicatorKernelTest: unweighted sum mismatch on"
+                        << "scan" << i << "with"
+                        << IndicatorKernel::isaName(isa);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IndicatorKernelTest::testColumns(
+    IndicatorKernel::Isa isa, const QVector<Measurements>& scans) const {
+    IndicatorKernel::setIsa(isa);
+
+    // Row counts around every vector width, so each tail path runs
+    const int counts[] = {0, 1, 7, 8, 15, 16, 17, 33, scans.size()};
+    for (int rows : counts) {
+        QVector<QVector<int16_t>> data(MeridianPoint::Count,
+                                       QVector<int16_t>(rows));
+        const int16_t* columns[MeridianPoint::Count];
+        for (int point = 0; point < MeridianPoint::Count; ++point) {
+            for (int i = 0; i < rows; ++i) data[point][i] = scans[i][point];
+            columns[point] = data[point].constData();
+        }
+
+        QVector<int32_t> upper(rows), lower(rows), left(rows), right(rows);
+        IndicatorKernel::sumColumns(columns, rows, upper.data(), lower.data(),
+                                    left.data(), right.data());
+
+        QVector<float> weights(rows * MeridianPoint::Count);
+        for (int i = 0; i < rows; ++i)
+            std::copy(WEIGHTS, WEIGHTS + MeridianPoint::Count,
+                      weights.data() + i * MeridianPoint::Count);
+        QVector<float> weightedLeft(rows), weightedRight(rows);
+        IndicatorKernel::sumWeightedColumns(columns, weights.constData(), rows,
+                                            weightedLeft.data(),
+                                            weightedRight.data());
+
+        for (int i = 0; i < rows; ++i) {
+            const ReadingSums expected = referenceSums(scans[i]);
+            // Weighted sums must match a single scan's to the last bit
+            const ReadingSums single =
+                IndicatorKernel::sum(scans[i].data(), WEIGHTS);
+            if (upper[i] != expected.upper || lower[i] != expected.lower ||
+                left[i] != expected.left || right[i] != expected.right ||
+                weightedLeft[i] != single.weightedLeft ||
+                weightedRight[i] != single.weightedRight) {
+                qCritical() << "IndicatorKernelTest: column sum mismatch on row"
+                            << i << "of" << rows << "with"
+                            << IndicatorKernel::isaName(isa);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Times the old per-group passes against the kernel on every
+ * supported instruction set. Timings are reported, never asserted.
+ */
+void IndicatorKernelTest::benchmark(const QVector<Measurements>& scans) const {
+    const int rounds = 200;
+    const qint64 work = static_cast<qint64>(rounds) * scans.size();
+    QElapsedTimer timer;
+    volatile float sink = 0;
+
+    QVector<ScanModel*> models;
+    for (const Measurements& readings : scans) {
+        ScanModel* model = new ScanModel();
+        model->setMeasurements(readings);
+        models.append(model);
+    }
+
+    timer.start();
+    for (int round = 0; round < rounds; ++round) {
+        for (ScanModel* scan : models) {
+            float upper = 0, lower = 0, left = 0, right = 0;
+            for (int16_t value : scan->getUpperMeasurements()) upper += value;
+            for (int16_t value : scan->getLowerMeasurements()) lower += value;
+            for (int16_t value : scan->getLeftMeasurements()) left += value;
+            for (int16_t value : scan->getRightMeasurements()) right += value;
+            sink = sink + upper + lower + left + right;
+        }
+    }
+    qInfo() << "IndicatorKernelTest: per-group passes"
+            << timer.nsecsElapsed() / work << "ns/scan";
+    qDeleteAll(models);
+
+    QVector<QVector<int16_t>> data(MeridianPoint::Count,
+                                   QVector<int16_t>(scans.size()));
+    const int16_t* columns[MeridianPoint::Count];
+    for (int point = 0; point < MeridianPoint::Count; ++point) {
+        for (int i = 0; i < scans.size(); ++i) data[point][i] = scans[i][point];
+        columns[point] = data[point].constData();
+    }
+    QVector<int32_t> upper(scans.size()), lower(scans.size()),
+        left(scans.size()), right(scans.size());
+
+    const IndicatorKernel::Isa isas[] = {IndicatorKernel::Isa::Scalar,
+                                         IndicatorKernel::Isa::SSE2,
+                                         IndicatorKernel::Isa::AVX2};
+    for (IndicatorKernel::Isa isa : isas) {
+        if (isa > IndicatorKernel::bestSupportedIsa()) continue;
+        IndicatorKernel::setIsa(isa);
+
+        timer.start();
+        for (int round = 0; round < rounds; ++round) {
+            for (const Measurements& scan : scans) {
+                const ReadingSums sums =
+                    IndicatorKernel::sum(scan.data(), WEIGHTS);
+                sink = sink + sums.total + sums.weightedLeft;
+            }
+        }
+        const qint64 single = timer.nsecsElapsed() / work;
+
+        timer.start();
+        for (int round = 0; round < rounds; ++round) {
+            IndicatorKernel::sumColumns(columns, scans.size(), upper.data(),
+                                        lower.data(), left.data(),
+                                        right.data());
+            sink = sink + upper[round % scans.size()];
+        }
+        const qint64 batch = timer.nsecsElapsed() / work;
+
+        qInfo() << "IndicatorKernelTest:" << IndicatorKernel::isaName(isa)
+                << "sum" << single << "ns/scan, sumColumns" << batch
+                << "ns/scan";
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file PopulationControllerTest.cpp
+ * @brief Tests for the PopulationController class.
+ */
+
+#include "PopulationControllerTest.h"
+
+#include "TestFixtures.h"
+
+namespace {
+
+ScanModel populationScan(int profileId, int i) {
+    return TestFixtures::makeScan(profileId, "Population Test Scan", [i](int point) {
+        return 20 + (point * 11 + i * 17) % 60;
+    });
+}
+
+double sketchCount(DatabaseManager& db, int sketchId) {
+    QuantileSketch sketch;
+    if(!PopulationController(db).getSketch(sketchId, sketch)) return -1;
+    return sketch.count();
+}
+
+}  // namespace
+
+PopulationControllerTest::PopulationControllerTest(): db(scratch.get()) {}
+PopulationControllerTest::~PopulationControllerTest() {}
+
+bool PopulationControllerTest::test() const {
+    qDebug() << "\n\nTesting PopulationController";
+
+    UserProfileController upc(db);
+    ProfileModel profile(-1, 1, "Population Test Profile", "Population test", "Male", 70, 175, QDate(1980, 8, 8));
+    if(!upc.createProfile(&profile)) return false;
+
+    bool passed = testIngest(profile.getId());
+    passed = passed && testPercentiles();
+    passed = testRebuild(profile.getId()) && passed;
+
+    qDebug() << (passed ? "Population sketches match" : "Population sketches differ");
+    return passed;
+}
+
+bool PopulationControllerTest::testIngest(int profileId) const {
+    double before[PopulationSketch::Count];
+    for(int sketchId = 0; sketchId < PopulationSketch::Count; ++sketchId) {
+        before[sketchId] = sketchCount(db, sketchId);
+        if(before[sketchId] < 0) return false;
+    }
+
+    // Each insert is added and saved, so a fresh controller sees it
+    ScanController sc(db);
+    const int count = 20;
+    for(int i = 0; i < count; ++i) {
+        ScanModel scan = populationScan(profileId, i);
+        if(!sc.storeScan(scan)) return false;
+    }
+    for(int sketchId = 0; sketchId < PopulationSketch::Count; ++sketchId) {
+        if(sketchCount(db, sketchId) != before[sketchId] + count) {
+            qDebug() << "Sketch" << sketchId << "missed stored scans";
+            return false;
+        }
+    }
+
+    // Bulk inserts too
+    QVector<ScanModel> scans;
+    for(int i = 0; i < 5; ++i) scans.append(populationScan(profileId, count + i));
+    if(!sc.storeScans(scans)) return false;
+    const int energy = PopulationSketch::FirstIndicator;
+    return sketchCount(db, energy) == before[energy] + count + 5;
+}
+
+bool PopulationControllerTest::testPercentiles() const {
+    PopulationController pc(db);
+    Measurements lowest;
+    Measurements highest;
+    lowest.fill(-32768);
+    highest.fill(32767);
+
+    ScanModel low;
+    ScanModel high;
+    low.setMeasurements(lowest);
+    high.setMeasurements(highest);
+
+    PopulationPercentiles lowRanks;
+    PopulationPercentiles highRanks;
+    if(!pc.getPercentiles(low, lowRanks) || !pc.getPercentiles(high, highRanks)) return false;
+    if(lowRanks.population <= 0 || lowRanks.population != highRanks.population) return false;
+
+    for(int point = 0; point < MeridianPoint::Count; ++point) {
+        if(lowRanks.points[point] != 0 || highRanks.points[point] != 100) {
+            qDebug() << "Point" << point << "ranked" << lowRanks.points[point]
+                     << "and" << highRanks.points[point];
+            return false;
+        }
+    }
+    for(int k = 0; k < HealthMetricCalculator::INDICATOR_COUNT; ++k) {
+        if(highRanks.indicators[k] < 0 || highRanks.indicators[k] > 100) return false;
+    }
+    qDebug() << "Population of" << highRanks.population << "scans";
+    return true;
+}
+
+bool PopulationControllerTest::testRebuild(int profileId) const {
+    // Deleted scans stay in the sketches until they are rebuilt
+    if(!TestFixtures::deleteProfile(db, profileId)) return false;
+
+    int scans = -1;
+    db.queryEach("SELECT COUNT(*) FROM scan;", {},
+                 [&scans](const QSqlQuery& row) { scans = row.value(0).toInt(); });
+
+    PopulationController pc(db);
+    return pc.rebuildSketches() && sketchCount(db, PopulationSketch::FirstPoint) == scans;
+}
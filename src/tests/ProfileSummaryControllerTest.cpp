@@ -0,0 +1,125 @@
+/**
+ * @file ProfileSummaryControllerTest.cpp
+ * @brief Tests for the ProfileSummaryController class.
+ */
+
+#include "ProfileSummaryControllerTest.h"
+
+#include <cmath>
+
+#include "TestFixtures.h"
+
+namespace {
+
+ScanModel summaryScan(int profileId, int i) {
+    return TestFixtures::makeScan(profileId, "Summary Test Scan", [i](int point) {
+        return 25 + (point * 13 + i * 7) % 50;
+    });
+}
+
+bool closeTo(float a, float b) {
+    return std::abs(a - b) <= 1e-4f + 1e-4f * std::abs(b);
+}
+
+}  // namespace
+
+ProfileSummaryControllerTest::ProfileSummaryControllerTest(): db(scratch.get()) {}
+ProfileSummaryControllerTest::~ProfileSummaryControllerTest() {}
+
+bool ProfileSummaryControllerTest::test() const {
+    qDebug() << "\n\nTesting ProfileSummaryController";
+
+    UserProfileController upc(db);
+    ProfileModel profile(-1, 1, "Summary Test Profile", "Summary test", "Female", 58, 165, QDate(1995, 3, 3));
+    if(!upc.createProfile(&profile)) return false;
+    const int profileId = profile.getId();
+
+    bool passed = matchesScans(profileId, "new profile");
+
+    // Inserts update the summary through indexes only
+    ScanController sc(db);
+    db.setQueryPlanCheck(true);
+    for(int i = 0; passed && i < 10; ++i) {
+        ScanModel scan = summaryScan(profileId, i);
+        passed = sc.storeScan(scan);
+    }
+    db.setQueryPlanCheck(false);
+    for(const QString& statement : db.getFullScanStatements()) {
+        qDebug() << "Full table scan in:" << statement;
+        passed = false;
+    }
+    passed = passed && matchesScans(profileId, "inserts");
+    passed = passed && testDeletes(profileId);
+
+    // Bulk inserts rebuild it in their transaction
+    QVector<ScanModel> scans;
+    for(int i = 0; i < 3; ++i) scans.append(summaryScan(profileId, 50 + i));
+    passed = passed && sc.storeScans(scans) && matchesScans(profileId, "bulk insert");
+
+    // A lost row is rebuilt by the next read
+    if(passed) db.execute("DELETE FROM profile_summary WHERE profile_id = ?;", {profileId});
+    passed = passed && matchesScans(profileId, "lost row");
+
+    TestFixtures::deleteProfile(db, profileId);
+    qDebug() << (passed ? "Profile summaries match" : "Profile summaries differ");
+    return passed;
+}
+
+bool ProfileSummaryControllerTest::testDeletes(int profileId) const {
+    ScanController sc(db);
+    UserProfileController upc(db);
+    QVector<ScanModel> scans;
+    if(!upc.getProfileScans(profileId, scans) || scans.size() < 3) return false;
+
+    // A middle scan, then the newest, then the oldest
+    if(!sc.deleteScan(scans[scans.size() / 2].getId()) || !matchesScans(profileId, "middle delete"))
+        return false;
+    if(!sc.deleteScan(scans.last().getId()) || !matchesScans(profileId, "newest delete"))
+        return false;
+    if(!sc.deleteScan(scans.first().getId()) || !matchesScans(profileId, "oldest delete"))
+        return false;
+
+    ScanModel deleted;
+    if(upc.getScan(scans.first().getId(), deleted)) return false;
+
+    // Trends are rebuilt without the deleted scans
+    TrendController tc(db);
+    TrendFit fit;
+    return tc.getTrend(profileId, TrendEngine::ALL_SCANS, fit) && fit.scans == scans.size() - 3;
+}
+
+bool ProfileSummaryControllerTest::matchesScans(int profileId, const char* step) const {
+    ProfileSummaryController psc(db);
+    UserProfileController upc(db);
+    HealthMetricCalculator calculator;
+
+    ProfileSummary summary;
+    QVector<ScanModel> scans;
+    if(!psc.getSummary(profileId, summary) || !upc.getProfileScans(profileId, scans)) return false;
+
+    bool matches = summary.scanCount == scans.size();
+    if(matches && !scans.isEmpty()) {
+        matches = summary.firstScanOn == scans.first().getCreatedOn() &&
+                  summary.lastScanOn == scans.last().getCreatedOn() &&
+                  summary.lastScanId == scans.last().getId();
+
+        QVector<HealthMetricModel> organs;
+        QVector<float> sums(HealthMetricCalculator::ORGAN_COUNT, 0.0f);
+        for(ScanModel& scan : scans) {
+            calculator.calculateOrganHealth(&scan, organs);
+            for(int k = 0; k < organs.size(); ++k) sums[k] += organs[k].getValue();
+        }
+        for(int k = 0; matches && k < sums.size(); ++k)
+            matches = closeTo(summary.organAverage(k), sums[k] / scans.size());
+
+        QVector<HealthMetricModel> indicators;
+        calculator.calculateIndicatorHealth(&scans.last(), indicators);
+        for(int k = 0; matches && k < indicators.size(); ++k)
+            matches = closeTo(summary.latest[k], indicators[k].getValue());
+    } else if(matches) {
+        matches = summary.lastScanId == -1 && !summary.firstScanOn.isValid();
+    }
+
+    if(!matches) qDebug() << "Summary differs from the scans after" << step;
+    return matches;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file QuantileSketchTest.cpp
+ * @brief Tests for the QuantileSketch class.
+ */
+
+#include "QuantileSketchTest.h"
+
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const double QUANTILES[] = {0.001, 0.01, 0.1,  0.25, 0.5,
+                            0.75,  0.9,  0.99, 0.999};
+
+// Sketch error allowed on a rank: one percentile
+const double RANK_TOLERANCE = 0.01;
+
+// Exact mid-rank of a value in sorted data, the quantity cdf() estimates
+double exactCdf(const QVector<double>& sorted, double value) {
+    const auto lower = std::lower_bound(sorted.begin(), sorted.end(), value);
+    const auto upper = std::upper_bound(lower, sorted.end(), value);
+    return ((lower - sorted.begin()) + (upper - lower) / 2.0) / sorted.size();
+}
+
+// Whether value lies between the exact quantiles q - and q + tolerance.
+// Quantiles of tied values are interpolated between neighbouring values, so
+// they may land up to one step (resolution) outside.
+bool rankCovers(const QVector<double>& sorted, double value, double q,
+                double resolution = 0) {
+    auto at = [&sorted](double rank) {
+        const double clamped = std::min(std::max(rank, 0.0), 1.0);
+        return sorted[static_cast<int>(clamped * (sorted.size() - 1))];
+    };
+    return value >= at(q - RANK_TOLERANCE) - resolution &&
+           value <= at(q + RANK_TOLERANCE) + resolution;
+}
+
+QuantileSketch sketchOf(const QVector<double>& values) {
+    QuantileSketch sketch;
+    for (double value : values) sketch.add(value);
+    sketch.flush();
+    return sketch;
+}
+
+}  // namespace
+
+QuantileSketchTest::QuantileSketchTest() {}
+QuantileSketchTest::~QuantileSketchTest() {}
+
+bool QuantileSketchTest::test() const {
+    std::mt19937 generator(2024);
+    const int count = 100000;
+
+    // Skewed continuous values, and integer readings with heavy ties
+    std::lognormal_distribution<double> skewed(0.0, 1.0);
+    std::normal_distribution<double> reading(60.0, 15.0);
+    QVector<double> continuous(count);
+    QVector<double> readings(count);
+    for (int i = 0; i < count; ++i) {
+        continuous[i] = skewed(generator);
+        readings[i] = std::max(0.0, std::round(reading(generator)));
+    }
+
+    bool passed = testAccuracy("lognormal", continuous, 0);
+    passed = testAccuracy("readings", readings, 1) && passed;
+    passed = testMerge(continuous) && passed;
+    passed = testBytes(readings) && passed;
+
+    // An empty sketch answers without dividing by zero
+    QuantileSketch empty;
+    passed = passed && empty.cdf(1.0) == 0 && empty.quantile(0.5) == 0;
+
+    benchmark(readings);
+
+    if (passed) qInfo() << "QuantileSketchTest: all tests passed";
+    return passed;
+}
+
+bool QuantileSketchTest::testAccuracy(const char* name,
+                                      const QVector<double>& values,
+                                      double resolution) const {
+    const QuantileSketch sketch = sketchOf(values);
+    QVector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    if (sketch.count() != values.size() || sketch.min() != sorted.first() ||
+        sketch.max() != sorted.last()) {
+        qCritical() << "QuantileSketchTest:" << name << "lost values";
+        return false;
+    }
+
+    for (double q : QUANTILES) {
+        const double estimate = sketch.quantile(q);
+        if (!rankCovers(sorted, estimate, q, resolution)) {
+            qCritical() << "QuantileSketchTest:" << name << "quantile" << q
+                        << "estimated as" << estimate << "at rank"
+                        << exactCdf(sorted, estimate);
+            return false;
+        }
+
+        const double value = sorted[static_cast<int>(q * (sorted.size() - 1))];
+        const double error =
+            std::abs(sketch.cdf(value) - exactCdf(sorted, value));
+        if (error > RANK_TOLERANCE) {
+            qCritical() << "QuantileSketchTest:" << name << "cdf of" << value
+                        << "off by" << error;
+            return false;
+        }
+    }
+
+    qInfo() << "QuantileSketchTest:" << name << values.size() << "values in"
+            << sketch.centroidCount() << "centroids";
+    return true;
+}
+
+bool QuantileSketchTest::testMerge(const QVector<double>& values) const {
+    // Four sketches over interleaved parts merge into one over the whole
+    QuantileSketch parts[4];
+    for (int i = 0; i < values.size(); ++i) parts[i % 4].add(values[i]);
+
+    QuantileSketch merged;
+    for (const QuantileSketch& part : parts) merged.merge(part);
+    merged.flush();
+
+    QVector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    if (merged.count() != values.size()) return false;
+    for (double q : QUANTILES) {
+        if (!rankCovers(sorted, merged.quantile(q), q)) {
+            qCritical() << "QuantileSketchTest: merged quantile" << q << "is"
+                        << merged.quantile(q);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool QuantileSketchTest::testBytes(const QVector<double>& values) const {
+    const QuantileSketch sketch = sketchOf(values);
+
+    QuantileSketch restored;
+    if (!QuantileSketch::fromBytes(sketch.toBytes(), restored)) return false;
+    if (restored.count() != sketch.count() ||
+        restored.centroidCount() != sketch.centroidCount())
+        return false;
+    for (double q : QUANTILES) {
+        if (restored.quantile(q) != sketch.quantile(q)) {
+            qCritical() << "QuantileSketchTest: quantile" << q
+                        << "changed when restored";
+            return false;
+        }
+    }
+
+    // Truncated bytes are rejected
+    QuantileSketch broken;
+    return !QuantileSketch::fromBytes(sketch.toBytes().left(30), broken);
+}
+
+/**
+ * @brief Times percentile lookups against sorting the values for each one.
+ * Timings are reported, never asserted.
+ */
+void QuantileSketchTest::benchmark(const QVector<double>& values) const {
+    const QuantileSketch sketch = sketchOf(values);
+    const int lookups = 10000;
+    QElapsedTimer timer;
+    volatile double sink = 0;
+
+    timer.start();
+    for (int i = 0; i < lookups; ++i) sink = sink + sketch.cdf(i % 120);
+    qInfo() << "QuantileSketchTest: sketch percentile"
+            << timer.nsecsElapsed() / lookups << "ns";
+
+    timer.start();
+    QVector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    sink = sink + exactCdf(sorted, 60);
+    qInfo() << "QuantileSketchTest: sorting for one percentile"
+            << timer.nsecsElapsed() << "ns";
+}
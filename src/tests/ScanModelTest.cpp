@@ -106,10 +106,38 @@ bool ScanModelTest::test() const {
         qDebug() << "All Tests Passed";
         qDebug() << "Printing measurements";
         for(int m : scan.getMeasurements()) qDebug() << QString("%1").arg(m);
-        return true;
+        return testLayout();
     } 
 
     qDebug() << "Tests Failed";
     return false;
 }
 
+
+bool ScanModelTest::testLayout() const {
+
+    qDebug() << "\nTesting Scan Measurement Layout";
+    ScanModel scan;
+    Measurements readings;
+    for(int i = 0; i < MeridianPoint::Count; ++i) readings[i] = i;
+    scan.setMeasurements(readings);
+
+    // Views read through the layout tables, so setters show up in them
+    scan.setF6StomachR(99);
+
+    MeasurementView upper = scan.getUpperMeasurements();
+    MeasurementView lower = scan.getLowerMeasurements();
+    MeasurementView left = scan.getLeftMeasurements();
+    MeasurementView right = scan.getRightMeasurements();
+
+    bool passed =
+        upper.size() == 12 && lower.size() == 12 &&
+        left.size() == 12 && right.size() == 12 &&
+        upper[0] == MeridianPoint::H1Lung && upper[6] == MeridianPoint::H1LungR &&
+        lower[0] == MeridianPoint::F1Spleen && lower[11] == 99 &&
+        left[6] == MeridianPoint::F1Spleen && right[0] == MeridianPoint::H1LungR &&
+        right[11] == 99 && scan.getH3HeartR() == MeridianPoint::H3HeartR;
+
+    qDebug() << (passed ? "Layout Tests Passed" : "Layout Tests Failed");
+    return passed;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file ScanResultControllerTest.cpp
+ * @brief Tests for the ScanResultController class.
+ */
+
+#include "ScanResultControllerTest.h"
+
+#include "TestFixtures.h"
+
+namespace {
+
+bool sameMetrics(const QVector<HealthMetricModel>& a, const QVector<HealthMetricModel>& b) {
+    if(a.size() != b.size()) return false;
+    for(int i = 0; i < a.size(); ++i) {
+        if(a[i].getId() != b[i].getId() || a[i].getValue() != b[i].getValue() ||
+           a[i].getLevel() != b[i].getLevel())
+            return false;
+    }
+    return true;
+}
+
+bool sameResult(const ScanResult& a, const ScanResult& b) {
+    return sameMetrics(a.organs, b.organs) && sameMetrics(a.indicators, b.indicators);
+}
+
+int storedVersions(DatabaseManager& db, int scanId) {
+    int count = 0;
+    db.queryEach("SELECT COUNT(*) FROM scan_result WHERE scan_id = ?;", {scanId},
+                 [&count](const QSqlQuery& row) { count = row.value(0).toInt(); });
+    return count;
+}
+
+}  // namespace
+
+ScanResultControllerTest::ScanResultControllerTest(): db(scratch.get()) {}
+ScanResultControllerTest::~ScanResultControllerTest() {}
+
+bool ScanResultControllerTest::test() const {
+    qDebug() << "\n\nTesting ScanResultController";
+
+    UserProfileController upc(db);
+    ProfileModel profile(-1, 1, "Result Test Profile", "Result test", "Male", 75, 180, QDate(1985, 6, 1));
+    if(!upc.createProfile(&profile)) return false;
+
+    ScanModel scan = TestFixtures::makeScan(profile.getId(), "Result Test Scan", [](int point) {
+        return 20 + (point * 7) % 60;
+    });
+
+    bool passed = false;
+    try {
+        passed = testCache(scan) && testVersion(scan);
+    } catch(const std::exception& e) {
+        qCritical() << "Scan result test failed:" << e.what();
+    }
+
+    TestFixtures::deleteProfile(db, profile.getId());
+    qDebug() << (passed ? "Scan results are reused" : "Scan results are not reused");
+    return passed;
+}
+
+bool ScanResultControllerTest::testCache(ScanModel& scan) const {
+    ScanController sc(db);
+    ScanResultController& results = sc.getResultController();
+
+    // Storing a scan stores its results alongside it
+    if(!sc.storeScan(scan) || scan.getId() <= 0) return false;
+    if(storedVersions(db, scan.getId()) != 1) {
+        qDebug() << "Results were not stored with the scan";
+        return false;
+    }
+
+    ScanResult expected;
+    if(!results.getCalculator().calculateScanResult(&scan, expected)) return false;
+
+    ScanResult cached;
+    if(!results.getResult(scan, cached) || !sameResult(cached, expected)) return false;
+    if(results.getCacheHits() != 1 || results.getCacheMisses() != 0) {
+        qDebug() << "Freshly stored results were not cached";
+        return false;
+    }
+
+    // A fresh controller has to read the stored row
+    ScanResultController reader(db);
+    ScanResult stored;
+    if(!reader.getResult(scan, stored) || !sameResult(stored, expected)) {
+        qDebug() << "Stored results differ from calculated ones";
+        return false;
+    }
+    if(reader.getCacheMisses() != 1) return false;
+    if(!reader.getResult(scan, stored) || reader.getCacheHits() != 1) return false;
+    return true;
+}
+
+bool ScanResultControllerTest::testVersion(ScanModel& scan) const {
+    ScanResultController results(db);
+    HealthMetricCalculator& calculator = results.getCalculator();
+    const quint64 before = calculator.getVersion();
+
+    // Narrowing a range must not serve the results computed under the old one
+    const Range energy = calculator.getRange(HealthMetricCalculator::Energy);
+    calculator.setRange(HealthMetricCalculator::Energy, Range(energy.max + 100.0f, energy.max + 200.0f));
+    if(calculator.getVersion() == before) {
+        qDebug() << "Changing a range kept the calculator version";
+        return false;
+    }
+
+    ScanResult result;
+    if(!results.getResult(scan, result)) return false;
+    const HealthMetricModel& level = result.indicators[HealthMetricCalculator::Energy];
+    if(level.getLevel() != -1) {
+        qDebug() << "Results were not recalculated:" << level.toString();
+        return false;
+    }
+
+    // Only the current version is kept
+    if(storedVersions(db, scan.getId()) != 1) return false;
+
+    calculator.setRange(HealthMetricCalculator::Energy, energy);
+    return calculator.getVersion() == before;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file ScanSessionTest.cpp
+ * @brief Tests for the ScanSession class, run headless without a device.
+ */
+
+#include "ScanSessionTest.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "ConductanceWaveform.h"
+#include "SimulationClock.h"
+#include "TestFixtures.h"
+
+namespace {
+
+// Drops debug messages while many sessions run, since each writes a few
+// per point, and passes the rest on
+QtMessageHandler previousHandler = nullptr;
+
+void dropDebug(QtMsgType type, const QMessageLogContext& context, const QString& message) {
+    if(type != QtDebugMsg && previousHandler) previousHandler(type, context, message);
+}
+
+// Sessions run side by side, and the reading error allowed against each
+// point's plateau, as in SignalPipelineTest
+const int SESSIONS = 50;
+const float READING_TOLERANCE = 0.04f;
+
+// Samples fed per push at 1 kHz, like a 100 Hz consumer, and the most fed
+// to one point: the session's timeout
+const int BLOCK = 10;
+const int MAX_SAMPLES =
+    ScanSession::STREAM_SAMPLE_RATE * ScanSession::MEASUREMENT_TIMEOUT_SECONDS;
+
+float plateauOf(int session, int page) {
+    return 75.0f + (session * 7 + page * 13) % 50;
+}
+
+ConductanceWaveform waveformOf(int session, int page) {
+    WaveformShape shape;
+    shape.plateau = plateauOf(session, page);
+    return ConductanceWaveform(shape, ScanSession::STREAM_SAMPLE_RATE,
+                               session * 31 + page + 1);
+}
+
+// The getter for each scan page's reading, by the setters MeasureNowWidget
+// stored them with: the left side's points, then the right side's
+using ReadingGetter = int (ScanModel::*)() const;
+const ReadingGetter PAGE_READINGS[ScanSession::SCAN_PAGES] = {
+    &ScanModel::getH1Lung,          &ScanModel::getH2HeartConstrictor,
+    &ScanModel::getH3Heart,         &ScanModel::getH4SmallIntestine,
+    &ScanModel::getH5TripleHeater,  &ScanModel::getH6LargeIntestine,
+    &ScanModel::getF1Spleen,        &ScanModel::getF2Liver,
+    &ScanModel::getF3Kidney,        &ScanModel::getF4UrinaryBladder,
+    &ScanModel::getF5GallBladder,   &ScanModel::getF6Stomach,
+    &ScanModel::getH1LungR,         &ScanModel::getH2HeartConstrictorR,
+    &ScanModel::getH3HeartR,        &ScanModel::getH4SmallIntestineR,
+    &ScanModel::getH5TripleHeaterR, &ScanModel::getH6LargeIntestineR,
+    &ScanModel::getF1SpleenR,       &ScanModel::getF2LiverR,
+    &ScanModel::getF3KidneyR,       &ScanModel::getF4UrinaryBladderR,
+    &ScanModel::getF5GallBladderR,  &ScanModel::getF6StomachR,
+};
+
+}  // namespace
+
+ScanSessionTest::ScanSessionTest(): db(scratch.get()) {}
+ScanSessionTest::~ScanSessionTest() {}
+
+bool ScanSessionTest::test() const {
+    qDebug() << "\n\nTesting ScanSession";
+
+    UserProfileController upc(db);
+    ProfileModel profile(-1, 1, "Session Test Profile", "Session test", "Male", 70, 175, QDate(1990, 6, 6));
+    if(!upc.createProfile(&profile)) return false;
+    const int profileId = profile.getId();
+
+    bool passed = testConcurrent(profileId);
+    passed = testTimeout() && passed;
+    passed = testCancel() && passed;
+
+    TestFixtures::deleteProfile(db, profileId);
+    if(passed) qInfo() << "ScanSessionTest: all tests passed";
+    return passed;
+}
+
+/**
+ * @brief Runs many full scans at once on one stepped clock, feeding every
+ * session's points a block at a time in turn, and checks that each session
+ * reads every plateau and stores a scan with its readings in place. The
+ * time spent measuring and storing is reported.
+ */
+bool ScanSessionTest::testConcurrent(int profileId) const {
+    SimulationClock clock;
+    clock.setStepped();
+    ScanController sc(db);
+
+    previousHandler = qInstallMessageHandler(dropDebug);
+    struct HandlerGuard {
+        ~HandlerGuard() { qInstallMessageHandler(previousHandler); }
+    } guard;
+
+    std::vector<std::unique_ptr<ScanSession>> sessions;
+    QVector<QVector<int>> readings(SESSIONS, QVector<int>(ScanSession::RESULTS_PAGE, -1));
+    QVector<ScanModel> stored;
+    for(int s = 0; s < SESSIONS; ++s) {
+        sessions.emplace_back(new ScanSession(nullptr, &sc, nullptr, &clock));
+        ScanSession* session = sessions.back().get();
+        session->setProfileId(profileId);
+        QObject::connect(session, &ScanSession::measurementTaken, [&readings, s](int page, int value) {
+            readings[s][page] = value;
+        });
+        QObject::connect(session, &ScanSession::scanStored, [&stored](const ScanModel& scan) {
+            stored.append(scan);
+        });
+        if(!session->begin()) return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 samples = 0;
+    float block[BLOCK];
+    for(int page = 1; page <= ScanSession::SCAN_PAGES; ++page) {
+        std::vector<ConductanceWaveform> waveforms;
+        waveforms.reserve(SESSIONS);
+        for(int s = 0; s < SESSIONS; ++s) {
+            waveforms.push_back(waveformOf(s, page));
+            if(!sessions[s]->startMeasurement()) return false;
+        }
+
+        for(bool pending = true; pending;) {
+            pending = false;
+            for(int s = 0; s < SESSIONS; ++s) {
+                if(sessions[s]->isMeasurementDone() || waveforms[s].position() >= MAX_SAMPLES)
+                    continue;
+                waveforms[s].generate(block, BLOCK);
+                sessions[s]->addSamples(block, BLOCK);
+                samples += BLOCK;
+                pending = true;
+            }
+        }
+
+        for(int s = 0; s < SESSIONS; ++s) {
+            if(!sessions[s]->isMeasurementDone()) {
+                qCritical() << "ScanSessionTest: session" << s << "has no reading at page" << page;
+                return false;
+            }
+            sessions[s]->release();
+            if(sessions[s]->getPage() != page + 1) return false;
+        }
+    }
+    const qint64 measureMs = timer.elapsed();
+
+    timer.restart();
+    for(auto& session : sessions) session->submitInputs(ScanInputs());
+    const qint64 storeMs = timer.elapsed();
+
+    qInfo() << "ScanSessionTest:" << SESSIONS << "sessions measured"
+            << SESSIONS * ScanSession::SCAN_PAGES << "points from" << samples
+            << "samples in" << measureMs << "ms and stored their scans in" << storeMs << "ms";
+
+    if(stored.size() != SESSIONS) {
+        qCritical() << "ScanSessionTest: stored" << stored.size() << "of" << SESSIONS << "scans";
+        return false;
+    }
+    for(int s = 0; s < SESSIONS; ++s) {
+        if(sessions[s]->getPage() != ScanSession::RESULTS_PAGE) return false;
+        for(int page = 1; page <= ScanSession::SCAN_PAGES; ++page) {
+            const float plateau = plateauOf(s, page);
+            const int reading = readings[s][page];
+            if(std::abs(reading - plateau) > READING_TOLERANCE * plateau) {
+                qCritical() << "ScanSessionTest: session" << s << "page" << page
+                            << "read" << reading << "for a plateau of" << plateau;
+                return false;
+            }
+        }
+    }
+
+    // Scans are stored in the order they finish, which is session order here
+    for(int s = 0; s < SESSIONS; ++s) {
+        for(int page = 1; page <= ScanSession::SCAN_PAGES; ++page) {
+            if((stored[s].*PAGE_READINGS[page - 1])() != readings[s][page]) {
+                qCritical() << "ScanSessionTest: session" << s << "stored page" << page << "out of place";
+                return false;
+            }
+        }
+        if(stored[s].getId() <= 0) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that a point without contact gives up after the timeout on
+ * virtual time and can be measured again, and that releasing the device
+ * mid-measurement interrupts it.
+ */
+bool ScanSessionTest::testTimeout() const {
+    SimulationClock clock;
+    clock.setStepped();
+    ScanSession session(nullptr, nullptr, nullptr, &clock);
+
+    QStringList alerts;
+    QObject::connect(&session, &ScanSession::alert, [&alerts](const QString& message) {
+        alerts << message;
+    });
+    if(!session.begin() || !session.startMeasurement()) return false;
+
+    // Open circuit: the probe never touches the point
+    QVector<float> open(1000, 0.0f);
+    session.addSamples(open.constData(), open.size());
+    clock.advance(ScanSession::MEASUREMENT_TIMEOUT_SECONDS * 1000 + 999);
+    if(!session.isScanInProgress() || !alerts.isEmpty()) {
+        qCritical() << "ScanSessionTest: measurement ended before its timeout";
+        return false;
+    }
+    clock.advance(1);
+    if(session.isScanInProgress() || session.isMeasurementDone() || alerts.size() != 1 ||
+       !alerts[0].startsWith("No stable reading")) {
+        qCritical() << "ScanSessionTest: timeout gave" << alerts;
+        return false;
+    }
+
+    // The point can be measured again, then the next is interrupted
+    ConductanceWaveform waveform = waveformOf(0, 1);
+    float block[BLOCK];
+    if(!session.startMeasurement()) return false;
+    while(!session.isMeasurementDone() && waveform.position() < MAX_SAMPLES) {
+        waveform.generate(block, BLOCK);
+        session.addSamples(block, BLOCK);
+    }
+    session.release();
+    if(session.getPage() != 2 || !session.startMeasurement()) return false;
+    session.addSamples(open.constData(), 100);
+    session.release();
+    if(session.getPage() != 2 || session.isScanInProgress() || alerts.size() != 2 ||
+       !alerts[1].startsWith("Scan interrupted")) {
+        qCritical() << "ScanSessionTest: release mid-measurement gave" << alerts;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Checks that cancelling drops the readings and returns to the intro.
+ */
+bool ScanSessionTest::testCancel() const {
+    SimulationClock clock;
+    clock.setStepped();
+    ScanSession session(nullptr, nullptr, nullptr, &clock);
+
+    QVector<int> pages;
+    QObject::connect(&session, &ScanSession::pageChanged, [&pages](int page) { pages << page; });
+
+    ConductanceWaveform waveform = waveformOf(1, 1);
+    float block[BLOCK];
+    if(!session.begin() || !session.startMeasurement()) return false;
+    while(!session.isMeasurementDone() && waveform.position() < MAX_SAMPLES) {
+        waveform.generate(block, BLOCK);
+        session.addSamples(block, BLOCK);
+    }
+    session.release();
+    session.cancel();
+
+    // Inputs are only taken on their page
+    session.submitInputs(ScanInputs());
+    if(pages != QVector<int>({1, 2, ScanSession::INTRO_PAGE}) || session.areAllMeasurementsComplete()) {
+        qCritical() << "ScanSessionTest: cancel went through pages" << pages;
+        return false;
+    }
+    return session.begin() && session.getPage() == 1;
+}
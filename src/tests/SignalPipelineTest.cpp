@@ -0,0 +1,247 @@
+/**
+ * @file SignalPipelineTest.cpp
+ * @brief Tests for the SignalPipeline class and its stages.
+ */
+
+#include "SignalPipelineTest.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "ConductanceWaveform.h"
+#include "DeviceController.h"
+
+namespace {
+
+// Reading error allowed against the waveform's plateau, which the signal
+// only approaches
+const float READING_TOLERANCE = 0.04f;
+
+// Samples fed per push: what a 100 Hz consumer drains at a rate
+int blockAt(int sampleRate) { return sampleRate / 100; }
+
+// Feeds a waveform to a pipeline until it has a reading or time runs out
+void feed(SignalPipeline& pipeline, ConductanceWaveform& waveform,
+          int sampleRate, int maxMs) {
+    QVector<float> block(blockAt(sampleRate));
+    const qint64 limit = qint64(sampleRate) * maxMs / 1000;
+    while (!pipeline.isComplete() && waveform.position() < limit) {
+        waveform.generate(block.data(), block.size());
+        pipeline.push(block.constData(), block.size());
+    }
+}
+
+bool closeTo(int reading, float plateau) {
+    return std::abs(reading - plateau) <= READING_TOLERANCE * plateau;
+}
+
+}  // namespace
+
+SignalPipelineTest::SignalPipelineTest() {}
+SignalPipelineTest::~SignalPipelineTest() {}
+
+bool SignalPipelineTest::test() const {
+    bool passed = testMedian(3);
+    passed = testMedian(5) && passed;
+    passed = testMedian(7) && passed;
+    passed = testBlocks() && passed;
+    passed = testReadings(DeviceController::MIN_SAMPLE_RATE) && passed;
+    passed = testReadings(DeviceController::MAX_SAMPLE_RATE) && passed;
+    passed = testContactLoss() && passed;
+    passed = testLive() && passed;
+
+    benchmark();
+
+    if (passed) qInfo() << "SignalPipelineTest: all tests passed";
+    return passed;
+}
+
+/**
+ * @brief Compares a median filter, fed in uneven blocks, with sorting each
+ * window.
+ */
+bool SignalPipelineTest::testMedian(int window) const {
+    std::mt19937 generator(window);
+    std::uniform_real_distribution<float> uniform(0.0f, 100.0f);
+    QVector<float> input(1000);
+    for (float& value : input) value = uniform(generator);
+
+    QVector<float> output = input;
+    MedianFilter filter(window);
+    for (int offset = 0, size = 1; offset < output.size(); offset += size) {
+        size = std::min(size % 37 + 1, output.size() - offset);
+        filter.process(output.data() + offset, size);
+    }
+
+    for (int i = 0; i < input.size(); ++i) {
+        QVector<float> sorted;
+        for (int k = i - window + 1; k <= i; ++k)
+            sorted.append(input[std::max(k, 0)]);
+        std::sort(sorted.begin(), sorted.end());
+        if (output[i] != sorted[window / 2]) {
+            qCritical() << "SignalPipelineTest: median" << window
+                        << "wrong at sample" << i;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Splitting the stream into blocks differently gives the same
+ * reading from the same samples.
+ */
+bool SignalPipelineTest::testBlocks() const {
+    const int sampleRate = 2000;
+    WaveformShape shape;
+    QVector<float> samples(3 * sampleRate);
+    ConductanceWaveform(shape, sampleRate, 11)
+        .generate(samples.data(), samples.size());
+
+    SignalPipeline whole = SignalPipeline::standard(sampleRate);
+    whole.push(samples.constData(), samples.size());
+
+    SignalPipeline single = SignalPipeline::standard(sampleRate);
+    for (int i = 0; i < samples.size() && !single.isComplete(); ++i)
+        single.push(samples.constData() + i, 1);
+
+    if (!whole.isComplete() || whole.reading() != single.reading()) {
+        qCritical() << "SignalPipelineTest: block size changed the reading";
+        return false;
+    }
+    return true;
+}
+
+bool SignalPipelineTest::testReadings(int sampleRate) const {
+    int slowestMs = 0;
+    for (float plateau : {75.0f, 100.0f, 125.0f}) {
+        for (quint32 seed = 1; seed <= 10; ++seed) {
+            WaveformShape shape;
+            shape.plateau = plateau;
+            ConductanceWaveform waveform(shape, sampleRate, seed);
+            SignalPipeline pipeline = SignalPipeline::standard(sampleRate);
+            feed(pipeline, waveform, sampleRate, 3000);
+
+            if (!pipeline.isComplete() ||
+                !closeTo(pipeline.reading(), plateau)) {
+                qCritical() << "SignalPipelineTest:" << sampleRate
+                            << "Hz read" << pipeline.reading() << "for"
+                            << plateau << "with seed" << seed;
+                return false;
+            }
+            slowestMs = std::max<int>(
+                slowestMs, waveform.position() * 1000 / sampleRate);
+        }
+    }
+    qInfo() << "SignalPipelineTest:" << sampleRate
+            << "Hz readings took at most" << slowestMs << "ms";
+    return true;
+}
+
+/**
+ * @brief Lifting the probe before the signal settles restarts the reading,
+ * so the first touch does not leak into it.
+ */
+bool SignalPipelineTest::testContactLoss() const {
+    const int sampleRate = DeviceController::MIN_SAMPLE_RATE;
+    SignalPipeline pipeline = SignalPipeline::standard(sampleRate);
+
+    WaveformShape first;
+    first.plateau = 125.0f;
+    ConductanceWaveform touch(first, sampleRate, 3);
+    feed(pipeline, touch, sampleRate, 250);
+
+    const QVector<float> lifted(100, 0.0f);
+    pipeline.push(lifted.constData(), lifted.size());
+
+    WaveformShape second;
+    second.plateau = 80.0f;
+    ConductanceWaveform retouch(second, sampleRate, 4);
+    feed(pipeline, retouch, sampleRate, 3000);
+
+    if (!pipeline.isComplete() || !closeTo(pipeline.reading(), 80.0f)) {
+        qCritical() << "SignalPipelineTest: read" << pipeline.reading()
+                    << "after the probe was lifted and placed again";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a point from a live 10 kHz device stream, drained by a
+ * 100 Hz consumer, without the ring dropping anything.
+ */
+bool SignalPipelineTest::testLive() const {
+    DeviceController device;
+    device.setDeviceOn(true);
+
+    StreamConfig config;
+    config.sampleRate = DeviceController::MAX_SAMPLE_RATE;
+    config.seed = 5;
+    config.shape.plateau = 100.0f;
+    SignalPipeline pipeline = SignalPipeline::standard(config.sampleRate);
+    if (!device.startStream(0, config)) return false;
+
+    DeviceSample samples[1024];
+    float values[1024];
+    QElapsedTimer timer;
+    timer.start();
+    while (!pipeline.isComplete() && timer.elapsed() < 3000) {
+        QThread::msleep(10);
+        for (int count; (count = device.readSamples(samples, 1024)) > 0;) {
+            for (int i = 0; i < count; ++i) values[i] = samples[i].value;
+            pipeline.push(values, count);
+        }
+    }
+    device.stopStream();
+
+    const StreamStats stats = device.getStreamStats();
+    qInfo() << "SignalPipelineTest: live reading" << pipeline.reading()
+            << "after" << timer.elapsed() << "ms," << stats.dropped
+            << "samples dropped";
+    return pipeline.isComplete() && stats.dropped == 0 &&
+           closeTo(pipeline.reading(), 100.0f);
+}
+
+/**
+ * @brief Times the standard pipeline over many points at 10 kHz, per stage,
+ * against the 100 us a sample takes to arrive. Timings are reported, never
+ * asserted.
+ */
+void SignalPipelineTest::benchmark() const {
+    const int sampleRate = DeviceController::MAX_SAMPLE_RATE;
+    const int points = 200;
+
+    // One recorded point replayed, so generating samples is not timed
+    QVector<float> samples(2 * sampleRate);
+    ConductanceWaveform(WaveformShape(), sampleRate, 9)
+        .generate(samples.data(), samples.size());
+
+    SignalPipeline pipeline = SignalPipeline::standard(sampleRate);
+    const int block = blockAt(sampleRate);
+    qint64 fed = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int point = 0; point < points; ++point) {
+        pipeline.reset();
+        for (int offset = 0;
+             !pipeline.isComplete() && offset + block <= samples.size();
+             offset += block)
+            pipeline.push(samples.constData() + offset, block);
+        fed += pipeline.samplesIn();
+    }
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    for (const StageTiming& timing : pipeline.getTimings()) {
+        const qint64 count = std::max<qint64>(timing.samples, 1);
+        qInfo() << "SignalPipelineTest:" << timing.name
+                << double(timing.nanoseconds) / count << "ns per sample over"
+                << timing.samples << "samples";
+    }
+    const double perSample = double(elapsed) / fed;
+    qInfo() << "SignalPipelineTest:" << perSample << "ns per sample in total,"
+            << 1e9 / sampleRate / perSample << "times faster than 10 kHz";
+}
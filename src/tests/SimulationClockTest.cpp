@@ -0,0 +1,180 @@
+/**
+ * @file SimulationClockTest.cpp
+ * @brief Tests for the simulation clock and the device running on it.
+ */
+
+#include "SimulationClockTest.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThread>
+
+#include "DeviceController.h"
+
+SimulationClockTest::SimulationClockTest() {}
+SimulationClockTest::~SimulationClockTest() {}
+
+bool SimulationClockTest::test() const {
+    bool passed = testStepped();
+    passed = testBatteryDrain() && passed;
+    passed = testSteppedStream() && passed;
+    passed = testAccelerated() && passed;
+
+    if (passed) qInfo() << "SimulationClockTest: all tests passed";
+    return passed;
+}
+
+/**
+ * @brief Steps two periodic timers and a single shot past each other and
+ * checks they fire in due order, at their due times, keeping their phase.
+ */
+bool SimulationClockTest::testStepped() const {
+    SimulationClock clock;
+    clock.setStepped();
+
+    QObject owner;
+    QStringList fired;
+    ClockTimer* fast = clock.createTimer(&owner);
+    ClockTimer* slow = clock.createTimer(&owner);
+    QObject::connect(fast, &ClockTimer::timeout, [&]() {
+        fired << QString("fast@%1").arg(clock.now());
+    });
+    QObject::connect(slow, &ClockTimer::timeout, [&]() {
+        fired << QString("slow@%1").arg(clock.now());
+    });
+    fast->start(300);
+    slow->start(500);
+    clock.singleShot(700, &owner,
+                     [&]() { fired << QString("once@%1").arg(clock.now()); });
+
+    clock.advance(1500);
+    const QStringList expected = {"fast@300",  "slow@500",  "fast@600",
+                                  "once@700",  "fast@900",  "slow@1000",
+                                  "fast@1200", "slow@1500", "fast@1500"};
+    if (fired != expected) {
+        qCritical() << "SimulationClockTest: stepped timers fired as" << fired;
+        return false;
+    }
+    if (clock.now() != 1500 || fast->remainingTime() != 300) return false;
+
+    // Stopped timers stay silent; advancing to the next one jumps to it
+    fast->stop();
+    fired.clear();
+    if (!clock.advanceToNext() || fired != QStringList{"slow@2000"}) {
+        qCritical() << "SimulationClockTest: advanceToNext fired" << fired;
+        return false;
+    }
+    slow->stop();
+    return !clock.advanceToNext() && clock.now() == 2000;
+}
+
+/**
+ * @brief Runs a full battery drain on a stepped clock: the device connects
+ * after 2 virtual seconds and turns itself off when the last percent is
+ * gone, 100 virtual seconds in.
+ */
+bool SimulationClockTest::testBatteryDrain() const {
+    SimulationClock clock;
+    clock.setStepped();
+    DeviceController device(nullptr, &clock);
+
+    QElapsedTimer timer;
+    timer.start();
+    device.setDeviceOn(true);
+    clock.advance(1999);
+    if (device.isConnected()) {
+        qCritical() << "SimulationClockTest: connected before 2 s";
+        return false;
+    }
+    clock.advance(1);
+    if (!device.isConnected() || device.getBatteryLevel() != 98) {
+        qCritical() << "SimulationClockTest: expected a connected device at"
+                    << "98%, got" << device.getBatteryLevel();
+        return false;
+    }
+
+    clock.advance(97999);
+    if (!device.isDeviceOn() || device.getBatteryLevel() != 1) {
+        qCritical() << "SimulationClockTest: battery at"
+                    << device.getBatteryLevel() << "after 99.999 s";
+        return false;
+    }
+    clock.advance(1);
+    if (device.isDeviceOn() || device.getBatteryLevel() != 0) {
+        qCritical() << "SimulationClockTest: device still on after drain";
+        return false;
+    }
+
+    qInfo() << "SimulationClockTest: 100 s battery drain took"
+            << timer.elapsed() << "ms";
+    return true;
+}
+
+/**
+ * @brief Checks that a stream on a stepped clock produces only the samples
+ * the steps make due.
+ */
+bool SimulationClockTest::testSteppedStream() const {
+    SimulationClock clock;
+    clock.setStepped();
+    DeviceController device(nullptr, &clock);
+    device.setDeviceOn(true);
+
+    StreamConfig config;
+    config.sampleRate = DeviceController::MIN_SAMPLE_RATE;
+    if (!device.startStream(0, config)) return false;
+
+    // Only the sample at time zero is due until the clock moves
+    QThread::msleep(50);
+    const qint64 before = device.getStreamStats().produced;
+    clock.advance(100);
+    QElapsedTimer timer;
+    timer.start();
+    while (device.getStreamStats().produced < 101 && timer.elapsed() < 1000)
+        QThread::msleep(1);
+    QThread::msleep(20);
+    const qint64 after = device.getStreamStats().produced;
+    device.stopStream();
+
+    if (before != 1 || after != 101) {
+        qCritical() << "SimulationClockTest: stepped stream produced" << before
+                    << "then" << after << "samples, expected 1 then 101";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs a periodic timer on a clock 1000 times faster than real time
+ * and checks that it fires once per virtual interval, none lost to the
+ * event loop's latency. The virtual time reached is reported.
+ */
+bool SimulationClockTest::testAccelerated() const {
+    SimulationClock clock;
+    clock.setAccelerated(1000);
+
+    QObject owner;
+    int ticks = 0;
+    ClockTimer* tick = clock.createTimer(&owner);
+    QObject::connect(tick, &ClockTimer::timeout, [&]() { ++ticks; });
+    const qint64 start = clock.now();
+    tick->start(1000);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < 200) QCoreApplication::processEvents();
+
+    // Catch up with anything due, then compare against virtual time
+    clock.setStepped();
+    clock.advance(0);
+    const qint64 expected = (clock.now() - start) / 1000;
+    qInfo() << "SimulationClockTest: 200 ms at 1000x reached"
+            << clock.now() - start << "virtual ms," << ticks << "ticks";
+    if (ticks != expected || ticks == 0) {
+        qCritical() << "SimulationClockTest: expected" << expected
+                    << "ticks, got" << ticks;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file TestFixtures.cpp
+ * @brief Scan and profile fixtures shared by the controller tests.
+ */
+
+#include "TestFixtures.h"
+
+#include <QDebug>
+
+namespace TestFixtures {
+
+ScratchDatabase::ScratchDatabase(): db(true, dir.filePath("Radotech.db")) {
+    if(!dir.isValid()) qCritical() << "Failed to create a scratch database:" << dir.errorString();
+}
+
+ScanModel makeScan(int profileId, const QString& name,
+                   const std::function<int(int)>& reading) {
+    Measurements readings;
+    for(int point = 0; point < MeridianPoint::Count; ++point)
+        readings[point] = reading(point);
+
+    ScanModel scan;
+    scan.setProfileId(profileId);
+    scan.setName(name);
+    scan.setMeasurements(readings);
+    return scan;
+}
+
+bool deleteProfile(DatabaseManager& db, int profileId) {
+    try {
+        db.execute("DELETE FROM scan_result WHERE scan_id IN "
+                   "(SELECT scan_id FROM scan WHERE profile_id = ?);", {profileId});
+        db.execute("DELETE FROM scan_trend WHERE profile_id = ?;", {profileId});
+        db.execute("DELETE FROM profile_summary WHERE profile_id = ?;", {profileId});
+        db.execute("DELETE FROM scan WHERE profile_id = ?;", {profileId});
+        db.execute("DELETE FROM profile WHERE profile_id = ?;", {profileId});
+    } catch(const std::exception& e) {
+        qCritical() << "Failed to delete test profile" << profileId << ":" << e.what();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace TestFixtures
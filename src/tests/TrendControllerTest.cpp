@@ -0,0 +1,148 @@
+/**
+ * @file TrendControllerTest.cpp
+ * @brief Tests for the TrendController class.
+ */
+
+#include "TrendControllerTest.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "TestFixtures.h"
+
+namespace {
+
+// Readings that drift upwards with a little wobble, so every indicator moves
+ScanModel trendScan(int profileId, int i) {
+    return TestFixtures::makeScan(profileId, "Trend Test Scan", [i](int point) {
+        return 30 + i / 2 + (point * 5 + i * 3) % 11 + (point % 2) * (i % 4);
+    });
+}
+
+// Ordinary least squares over the last `window` values, x = 1..window
+float referenceSlope(const QVector<float>& ys, int window) {
+    const int n = window <= 0 ? ys.size() : std::min(window, ys.size());
+    const int first = ys.size() - n;
+    double meanX = (n + 1) / 2.0;
+    double meanY = 0;
+    for(int i = 0; i < n; ++i) meanY += ys[first + i];
+    meanY /= n;
+
+    double num = 0, den = 0;
+    for(int i = 0; i < n; ++i) {
+        num += (i + 1 - meanX) * (ys[first + i] - meanY);
+        den += (i + 1 - meanX) * (i + 1 - meanX);
+    }
+    return static_cast<float>(num / den);
+}
+
+bool closeTo(float a, float b) {
+    return std::abs(a - b) <= 1e-4f + 1e-3f * std::abs(b);
+}
+
+}  // namespace
+
+TrendControllerTest::TrendControllerTest(): db(scratch.get()) {}
+TrendControllerTest::~TrendControllerTest() {}
+
+bool TrendControllerTest::test() const {
+    qDebug() << "\n\nTesting TrendController";
+
+    UserProfileController upc(db);
+    ProfileModel profile(-1, 1, "Trend Test Profile", "Trend test", "Female", 60, 170, QDate(1990, 1, 1));
+    if(!upc.createProfile(&profile)) return false;
+
+    // Storing scans must extend the sums through indexes only
+    const int count = 40;
+    ScanController sc(db);
+    db.setQueryPlanCheck(true);
+    bool passed = true;
+    for(int i = 0; passed && i < count; ++i) {
+        ScanModel scan = trendScan(profile.getId(), i);
+        passed = sc.storeScan(scan) && scan.getId() > 0;
+    }
+    db.setQueryPlanCheck(false);
+    for(const QString& statement : db.getFullScanStatements()) {
+        qDebug() << "Full table scan in:" << statement;
+        passed = false;
+    }
+
+    passed = passed && testWindows(profile.getId(), count);
+    passed = passed && testResync(profile.getId());
+
+    TestFixtures::deleteProfile(db, profile.getId());
+    qDebug() << (passed ? "Trends match" : "Trends differ");
+    return passed;
+}
+
+bool TrendControllerTest::testWindows(int profileId, int count) const {
+    TrendController tc(db);
+    UserProfileController upc(db);
+    HealthMetricCalculator calculator;
+
+    ScanBatch batch;
+    IndicatorSeries series;
+    if(!upc.getProfileScanBatch(profileId, batch) || batch.size() != count) return false;
+    if(!calculator.calculateIndicatorSeries(batch, series)) return false;
+    const QVector<float>* ys[TrendFit::INDICATORS] = {
+        &series.energy, &series.immune, &series.metabolism, &series.psycho, &series.skeletal};
+
+    const int windows[] = {TrendEngine::ALL_SCANS, TrendEngine::SHORT_WINDOW,
+                           TrendEngine::MEDIUM_WINDOW, TrendEngine::LONG_WINDOW};
+    for(int window : windows) {
+        TrendFit fit;
+        if(!tc.getTrend(profileId, window, fit)) return false;
+
+        const int expected = window == TrendEngine::ALL_SCANS ? count : std::min(window, count);
+        if(fit.scans != expected) {
+            qDebug() << "Window" << window << "fitted" << fit.scans << "scans";
+            return false;
+        }
+        for(int k = 0; k < TrendFit::INDICATORS; ++k) {
+            const float slope = referenceSlope(*ys[k], window);
+            if(!closeTo(fit.slope[k], slope) || !closeTo(fit.latest[k], ys[k]->last())) {
+                qDebug() << "Window" << window << "indicator" << k << "slope"
+                         << fit.slope[k] << "expected" << slope;
+                return false;
+            }
+        }
+        qDebug() << "Window" << window << "energy slope" << fit.slope[0];
+    }
+
+    // The stored sums agree with recomputing from every scan
+    QVector<HealthMetricModel> stored;
+    QVector<HealthMetricModel> computed;
+    if(!tc.getTrendHealth(profileId, TrendEngine::ALL_SCANS, stored)) return false;
+    if(!calculator.calculateTrendHealth(batch, computed)) return false;
+    for(int k = 0; k < stored.size(); ++k) {
+        qDebug() << stored[k].toString();
+        if(stored[k].getId() != computed[k].getId() || stored[k].getLevel() != computed[k].getLevel())
+            return false;
+    }
+    return true;
+}
+
+bool TrendControllerTest::testResync(int profileId) const {
+    TrendController tc(db);
+    ScanController sc(db);
+    TrendFit fit;
+
+    // Bulk inserts skip the sums; the next read rebuilds them
+    QVector<ScanModel> scans;
+    for(int i = 0; i < 3; ++i) scans.append(trendScan(profileId, 100 + i));
+    if(!sc.storeScans(scans)) return false;
+    if(!tc.getTrend(profileId, TrendEngine::ALL_SCANS, fit) || fit.scans != 43) {
+        qDebug() << "Trend did not pick up bulk inserted scans";
+        return false;
+    }
+
+    // Lost sums are rebuilt by the next insert instead of appended to
+    db.execute("DELETE FROM scan_trend WHERE profile_id = ?;", {profileId});
+    ScanModel scan = trendScan(profileId, 200);
+    if(!sc.storeScan(scan)) return false;
+    if(!tc.getTrend(profileId, TrendEngine::ALL_SCANS, fit) || fit.scans != 44) {
+        qDebug() << "Trend was not rebuilt after its rows were lost";
+        return false;
+    }
+    return true;
+}
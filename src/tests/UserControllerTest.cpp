@@ -7,7 +7,7 @@
 #include "UserControllerTest.h"
 #include "ProfileModel.h"
 
-UserControllerTest::UserControllerTest(DatabaseManager& db) {
+UserControllerTest::UserControllerTest(DatabaseManager& db): db(db) {
     uc = new UserController(db);
 }
 
@@ -16,7 +16,19 @@ UserControllerTest::~UserControllerTest() {
 }
 
 bool UserControllerTest::test() const {
-    return testCRUD();
+    return testQueryPlans();
+}
+
+bool UserControllerTest::testQueryPlans() const {
+    // Every statement issued by the controller must be served by an index
+    db.setQueryPlanCheck(true);
+    bool passed = testCRUD();
+    db.setQueryPlanCheck(false);
+
+    for (const QString& statement : db.getFullScanStatements()) {
+        qDebug() << "Full table scan in:" << statement;
+    }
+    return passed && db.getFullScanStatements().isEmpty();
 }
 
 bool UserControllerTest::testCRUD() const {
@@ -5,7 +5,7 @@
 
 #include "UserProfileControllerTest.h"
 
-UserProfileControllerTest::UserProfileControllerTest(DatabaseManager& db) {
+UserProfileControllerTest::UserProfileControllerTest(DatabaseManager& db): db(db) {
     upc = new UserProfileController(db);
 }
 
@@ -14,7 +14,19 @@ UserProfileControllerTest::~UserProfileControllerTest() {
 }
 
 bool UserProfileControllerTest::test() const {
-    return testCRUD();
+    return testQueryPlans() && testAsync() && testPaging() && testScanBatch();
+}
+
+bool UserProfileControllerTest::testQueryPlans() const {
+    // Every statement issued by the controller must be served by an index
+    db.setQueryPlanCheck(true);
+    bool passed = testCRUD();
+    db.setQueryPlanCheck(false);
+
+    for (const QString& statement : db.getFullScanStatements()) {
+        qDebug() << "Full table scan in:" << statement;
+    }
+    return passed && db.getFullScanStatements().isEmpty();
 }
 
 bool UserProfileControllerTest::testCRUD() const {
@@ -113,3 +125,86 @@ void UserProfileControllerTest::cleanup(QVector<ProfileModel*>& profiles) const
     for(const auto* prof : profiles) delete prof;
 }
 
+bool UserProfileControllerTest::testAsync() const {
+
+    qDebug() << "\nLOADING PROFILES AND SCANS ASYNCHRONOUSLY ******************";
+    QVector<ProfileModel*> profiles;
+    if(!upc->getProfiles(1, profiles)) return false;
+
+    QFuture<QVector<ProfileModel>> profilesFuture = upc->getProfilesAsync(1);
+    profilesFuture.waitForFinished();
+    bool passed = profilesFuture.result().size() == profiles.size();
+
+    for(const auto* prof : profiles) {
+        QVector<ScanModel*> scans;
+        upc->getProfileScans(prof->getId(), scans);
+
+        QFuture<QVector<ScanModel>> scansFuture = upc->getProfileScansAsync(prof->getId());
+        scansFuture.waitForFinished();
+        if(scansFuture.result().size() != scans.size()) passed = false;
+
+        qDeleteAll(scans);
+    }
+
+    cleanup(profiles);
+    qDebug() << (passed ? "Async results match" : "Async results differ");
+    return passed;
+}
+
+bool UserProfileControllerTest::testPaging() const {
+
+    qDebug() << "\nPAGING PROFILE SCANS FOR: " << "Test Profile 1" << "******************";
+    ProfileModel profile;
+    if(!upc->getProfileByName(1, "Test Profile 1", profile)) return false;
+
+    QVector<ScanModel> scans;
+    if(!upc->getProfileScans(profile.getId(), scans)) return false;
+
+    // Walking every page from the newest must visit each scan exactly once
+    QVector<ScanModel> paged;
+    QVector<ScanModel> page;
+    ScanCursor cursor;
+    do {
+        if(!upc->getProfileScansPage(profile.getId(), cursor, 2, PageDirection::Older, page)) return false;
+        paged += page;
+        if(!page.isEmpty()) cursor = ScanCursor(page.last());
+    } while(!page.isEmpty());
+
+    bool passed = paged.size() == scans.size();
+    for(int i = 0; passed && i < paged.size(); ++i) {
+        if(paged[i].getId() != scans[scans.size() - 1 - i].getId()) passed = false;
+    }
+
+    // Paging back towards newer scans returns the page before the cursor
+    if(passed && scans.size() > 2) {
+        if(!upc->getProfileScansPage(profile.getId(), ScanCursor(scans.first()), 2, PageDirection::Newer, page)) return false;
+        passed = page.size() == 2 && page[0].getId() == scans[2].getId() && page[1].getId() == scans[1].getId();
+    }
+
+    qDebug() << (passed ? "Paged results match" : "Paged results differ");
+    return passed;
+}
+
+bool UserProfileControllerTest::testScanBatch() const {
+
+    qDebug() << "\nLOADING SCAN BATCH FOR: " << "Test Profile 1" << "******************";
+    ProfileModel profile;
+    if(!upc->getProfileByName(1, "Test Profile 1", profile)) return false;
+
+    QVector<ScanModel> scans;
+    ScanBatch batch;
+    if(!upc->getProfileScans(profile.getId(), scans)) return false;
+    if(!upc->getProfileScanBatch(profile.getId(), batch)) return false;
+
+    // The batch holds the same scans, in the same order, column-wise
+    bool passed = batch.size() == scans.size();
+    for(int i = 0; passed && i < scans.size(); ++i) {
+        passed = batch.getIds()[i] == scans[i].getId() &&
+                 batch.getCreatedOn()[i] == scans[i].getCreatedOn() &&
+                 batch.readingsAt(i) == scans[i].getMeasurements() &&
+                 batch.column(MeridianPoint::F6StomachR)[i] == scans[i].getF6StomachR();
+    }
+
+    qDebug() << (passed ? "Scan batch matches" : "Scan batch differs");
+    return passed;
+}
@@ -5,24 +5,37 @@
 
 #include "HistoryWidget.h"
 
-#include <QGridLayout>
 #include <QLabel>
-#include <QPushButton>
-#include <QScrollArea>
+#include <QListView>
 #include <QVBoxLayout>
 
 #include "Logging.h"
-#include "UserProfileController.h"
+#include "ScanItemDelegate.h"
+#include "ScanListModel.h"
 
 HistoryWidget::HistoryWidget(QWidget* parent, UserProfileController* controller)
     : QWidget(parent),
       userProfileController(controller),
+      currentProfileId(-1),
+      scanListModel(new ScanListModel(controller, this)),
       historyView(new QWidget(this)),
       resultsView(new ResultsWidget(this)),
       mainLayout(new QVBoxLayout(this)),
-      scansGrid(new QVBoxLayout()),
-      scrollArea(new QScrollArea(this)) {
+      scanList(new QListView(this)),
+      emptyView(new QWidget(this)) {
     setupUI();
+
+    connect(scanListModel, &ScanListModel::pageLoaded, this,
+            &HistoryWidget::onScansLoaded);
+}
+
+/**
+ * @brief Sets where the results of a selected scan are read from, so going
+ * back and forth between scans does not recompute them.
+ * @param controller the shared result store
+ */
+void HistoryWidget::setResultController(ScanResultController* controller) {
+    resultsView->setResultController(controller);
 }
 
 /**
@@ -33,22 +46,19 @@ HistoryWidget::HistoryWidget(QWidget* parent, UserProfileController* controller)
 void HistoryWidget::setCurrentProfile(int profileId) {
     DEBUG(QString("Setting current profile ID: %1").arg(profileId));
 
-    qDeleteAll(profileScans);
-    profileScans.clear();
-
-    QLayoutItem* child;
-    while ((child = scansGrid->takeAt(0)) != nullptr) {
-        delete child->widget();
-        delete child;
-    }
-
     if (profileId <= 0) {
         WARNING("Invalid profile ID");
+        scanListModel->setProfile(-1);
+        return;
+    }
+
+    if (!userProfileController) {
+        ERROR("UserProfileController is null");
         return;
     }
 
     currentProfileId = profileId;
-    loadScansForProfile();
+    scanListModel->setProfile(profileId);
     showHistoryView();
 }
 
@@ -65,93 +75,44 @@ void HistoryWidget::showHistoryView() {
     }
 
     resultsView->hide();
-    scrollArea->show();
+    updateEmptyState();
 }
 
 /**
  * @brief
  *
- * @param scan
+ * @param index
  */
-void HistoryWidget::onScanSelected(ScanModel* scan) {
-    if (!profileScans.contains(scan)) {
+void HistoryWidget::onScanSelected(const QModelIndex& index) {
+    if (!index.isValid() || index.row() >= scanListModel->rowCount()) {
         WARNING("Attempted to access invalid scan");
         return;
     }
 
     DEBUG("Scan selected");
-    showResultsView(scan);
+    showResultsView(scanListModel->scanAt(index.row()));
 }
 
 /**
  * @brief
  */
-void HistoryWidget::loadScansForProfile() {
-    DEBUG(QString("Loading scans for profile ID: %1").arg(currentProfileId));
-
-    qDeleteAll(profileScans);
-    profileScans.clear();
-
-    if (!userProfileController) {
-        ERROR("UserProfileController is null");
-        return;
-    }
-
-    if (currentProfileId <= 0) {
-        WARNING("Invalid profile ID");
-        return;
-    }
-
-    if (!userProfileController->getProfileScans(currentProfileId,
-                                                profileScans)) {
-        ERROR("Failed to load scans from database");
-        return;
-    }
-
-    INFO(QString("Loaded %1 scans for profile").arg(profileScans.size()));
-
-    if (profileScans.isEmpty()) {
+void HistoryWidget::onScansLoaded() {
+    if (scanListModel->rowCount() == 0) {
         INFO("No scans found for this profile");
-
-        QWidget* card = new QWidget;
-        card->setStyleSheet(
-            "QWidget { "
-            "    background-color: white; "
-            "    border-radius: 10px; "
-            "    border: 1px solid #E0E0E0; "
-            "}");
-
-        QVBoxLayout* cardLayout = new QVBoxLayout(card);
-        cardLayout->setContentsMargins(20, 30, 20, 30);
-        cardLayout->setSpacing(8);
-
-        QLabel* messageLabel = new QLabel("No Scans Available");
-        messageLabel->setStyleSheet(
-            "background-color: transparent; "
-            "color: #333333; "
-            "font-size: 20px; "
-            "font-weight: bold; "
-            "border: none;");
-        messageLabel->setAlignment(Qt::AlignCenter);
-
-        QLabel* descLabel = new QLabel("Complete a new scan to see it here");
-        descLabel->setStyleSheet(
-            "background-color: transparent; "
-            "color: #666666; "
-            "font-size: 15px; "
-            "border: none;");
-        descLabel->setAlignment(Qt::AlignCenter);
-
-        cardLayout->addWidget(messageLabel);
-        cardLayout->addWidget(descLabel);
-
-        scansGrid->addStretch();
-        scansGrid->addWidget(card);
-        scansGrid->addStretch();
-        return;
     }
 
-    displayScans();
+    if (resultsView->isHidden()) updateEmptyState();
+}
+
+/**
+ * @brief Swaps the list for the empty state once a profile is known to
+ * have no scans.
+ */
+void HistoryWidget::updateEmptyState() {
+    const bool empty =
+        !scanListModel->isLoading() && scanListModel->rowCount() == 0;
+    scanList->setVisible(!empty);
+    emptyView->setVisible(empty);
 }
 
 /**
@@ -163,114 +124,81 @@ void HistoryWidget::setupUI() {
     setLayout(mainLayout);
     mainLayout->setContentsMargins(0, 0, 0, 0);
 
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setFrameShape(QFrame::NoFrame);
-    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    scrollArea->setStyleSheet(
-        "QScrollArea { background: transparent; }"
-        "QScrollArea > QWidget > QWidget { background: transparent; }");
-
-    QWidget* containerWidget = new QWidget;
-    containerWidget->setStyleSheet("background: transparent;");
-
-    scansGrid = new QVBoxLayout(containerWidget);
-    scansGrid->setSpacing(10);
-    scansGrid->setContentsMargins(0, 0, 0, 0);
-
-    scrollArea->setWidget(containerWidget);
-    mainLayout->addWidget(scrollArea);
+    // Rows are painted by the delegate and all share one height, so the view
+    // only lays out and draws the handful of scans that are on screen
+    scanList->setModel(scanListModel);
+    scanList->setItemDelegate(new ScanItemDelegate(scanList));
+    scanList->setUniformItemSizes(true);
+    scanList->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    scanList->setSelectionMode(QAbstractItemView::NoSelection);
+    scanList->setFocusPolicy(Qt::NoFocus);
+    scanList->setMouseTracking(true);
+    scanList->setFrameShape(QFrame::NoFrame);
+    scanList->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    scanList->viewport()->setCursor(Qt::PointingHandCursor);
+    scanList->setStyleSheet(
+        "QListView { background: transparent; }"
+        "QListView::item { background: transparent; }");
+
+    connect(scanList, &QListView::clicked, this,
+            &HistoryWidget::onScanSelected);
+
+    mainLayout->addWidget(scanList);
+
+    setupEmptyView();
+    mainLayout->addWidget(emptyView);
 
     resultsView->hide();
     mainLayout->addWidget(resultsView);
+
+    connect(resultsView, &ResultsWidget::backButtonClicked, this,
+            &HistoryWidget::onBackToHistoryClicked);
 }
 
 /**
- * @brief
+ * @brief Builds the card shown in place of the list when a profile has no
+ * scans.
  */
-void HistoryWidget::displayScans() {
-    DEBUG("Displaying scans");
-
-    QLayoutItem* child;
-    while ((child = scansGrid->takeAt(0)) != nullptr) {
-        delete child->widget();
-        delete child;
-    }
-
-    for (ScanModel* scan : profileScans) {
-        QWidget* card = new QWidget;
-        card->setFixedHeight(80);
-        card->setObjectName("scanCard");
-
-        QHBoxLayout* cardLayout = new QHBoxLayout(card);
-        cardLayout->setContentsMargins(20, 0, 20, 0);
-        cardLayout->setSpacing(20);
-
-        QWidget* dateWidget = new QWidget;
-        dateWidget->setStyleSheet("border: none;");
-        QVBoxLayout* dateLayout = new QVBoxLayout(dateWidget);
-        dateLayout->setContentsMargins(0, 10, 0, 10);
-        dateLayout->setSpacing(2);
-
-        QLabel* dayLabel = new QLabel(scan->getCreatedOn().toString("dd"));
-        dayLabel->setStyleSheet(
-            "color: #333333; font-size: 22px; font-weight: bold;");
-
-        QLabel* monthLabel =
-            new QLabel(scan->getCreatedOn().toString("MMM yyyy"));
-        monthLabel->setStyleSheet("color: #666666; font-size: 14px;");
-
-        dateLayout->addWidget(dayLabel, 0, Qt::AlignLeft);
-        dateLayout->addWidget(monthLabel, 0, Qt::AlignLeft);
-        dateWidget->setFixedWidth(100);
-
-        QWidget* vitalsWidget = new QWidget;
-        vitalsWidget->setStyleSheet("border: none;");
-        QVBoxLayout* vitalsLayout = new QVBoxLayout(vitalsWidget);
-        vitalsLayout->setContentsMargins(0, 10, 0, 10);
-        vitalsLayout->setSpacing(2);
-
-        QLabel* tempLabel =
-            new QLabel(QString("Temperature: %1°C").arg(scan->getBodyTemp()));
-        tempLabel->setStyleSheet("color: #333333; font-size: 15px;");
-
-        QLabel* otherVitalsLabel =
-            new QLabel(QString("HR: %1 bpm  •  BP: %2 mmHg")
-                           .arg(scan->getHeartRate())
-                           .arg(scan->getBloodPressure()));
-        otherVitalsLabel->setStyleSheet("color: #666666; font-size: 14px;");
-
-        vitalsLayout->addWidget(tempLabel);
-        vitalsLayout->addWidget(otherVitalsLabel);
-
-        cardLayout->addWidget(dateWidget);
-        cardLayout->addWidget(vitalsWidget, 1);
-
-        card->setCursor(Qt::PointingHandCursor);
-        card->installEventFilter(this);
-        card->setProperty("scan_ptr", QVariant::fromValue((void*)scan));
-        card->setStyleSheet(
-            "#scanCard { "
-            "    background-color: white; "
-            "    border-radius: 10px; "
-            "    border: 1px solid #E0E0E0; "
-            "} "
-            "#scanCard:hover { "
-            "    background-color: #F8F8F8; "
-            "    border: 1px solid #D0D0D0; "
-            "} "
-            "#scanCard > QWidget { "
-            "    border: none; "
-            "    background: transparent; "
-            "} "
-            "#scanCard QLabel { "
-            "    border: none; "
-            "    background: transparent; "
-            "}");
-
-        scansGrid->addWidget(card);
-    }
-
-    scansGrid->addStretch();
+void HistoryWidget::setupEmptyView() {
+    QWidget* card = new QWidget;
+    card->setStyleSheet(
+        "QWidget { "
+        "    background-color: white; "
+        "    border-radius: 10px; "
+        "    border: 1px solid #E0E0E0; "
+        "}");
+
+    QVBoxLayout* cardLayout = new QVBoxLayout(card);
+    cardLayout->setContentsMargins(20, 30, 20, 30);
+    cardLayout->setSpacing(8);
+
+    QLabel* messageLabel = new QLabel("No Scans Available");
+    messageLabel->setStyleSheet(
+        "background-color: transparent; "
+        "color: #333333; "
+        "font-size: 20px; "
+        "font-weight: bold; "
+        "border: none;");
+    messageLabel->setAlignment(Qt::AlignCenter);
+
+    QLabel* descLabel = new QLabel("Complete a new scan to see it here");
+    descLabel->setStyleSheet(
+        "background-color: transparent; "
+        "color: #666666; "
+        "font-size: 15px; "
+        "border: none;");
+    descLabel->setAlignment(Qt::AlignCenter);
+
+    cardLayout->addWidget(messageLabel);
+    cardLayout->addWidget(descLabel);
+
+    QVBoxLayout* emptyLayout = new QVBoxLayout(emptyView);
+    emptyLayout->setContentsMargins(0, 0, 0, 0);
+    emptyLayout->addStretch();
+    emptyLayout->addWidget(card);
+    emptyLayout->addStretch();
+
+    emptyView->hide();
 }
 
 /**
@@ -278,16 +206,13 @@ void HistoryWidget::displayScans() {
  *
  * @param scan
  */
-void HistoryWidget::showResultsView(ScanModel* scan) {
+void HistoryWidget::showResultsView(const ScanModel& scan) {
     DEBUG("Showing results view");
 
-    scrollArea->hide();
+    scanList->hide();
+    emptyView->hide();
     resultsView->setShowBackButton(true);
-    resultsView->setScanModel(*scan);
-
-    connect(resultsView, &ResultsWidget::backButtonClicked, this,
-            &HistoryWidget::onBackToHistoryClicked);
-
+    resultsView->setScanModel(scan);
     resultsView->show();
 }
 
@@ -299,29 +224,6 @@ void HistoryWidget::onBackToHistoryClicked() {
     showHistoryView();
 }
 
-/**
- * @brief
- *
- * @param obj
- * @param event
- * @return
- */
-bool HistoryWidget::eventFilter(QObject* obj, QEvent* event) {
-    if (event->type() == QEvent::MouseButtonPress) {
-        QWidget* card = qobject_cast<QWidget*>(obj);
-        if (card) {
-            QVariant scanPtr = card->property("scan_ptr");
-            if (scanPtr.isValid()) {
-                ScanModel* scan =
-                    static_cast<ScanModel*>(scanPtr.value<void*>());
-                onScanSelected(scan);
-                return true;
-            }
-        }
-    }
-    return QWidget::eventFilter(obj, event);
-}
-
 /**
  * @brief
  *
@@ -329,7 +231,7 @@ bool HistoryWidget::eventFilter(QObject* obj, QEvent* event) {
  */
 void HistoryWidget::onNewScanStored(const ScanModel& scan) {
     if (scan.getProfileId() == currentProfileId) {
-        loadScansForProfile();
+        scanListModel->reload();
         showHistoryView();
     }
 }
@@ -16,12 +16,18 @@
 #include "ProfileModel.h"
 
 HomeWidget::HomeWidget(QWidget* parent, UserProfileController* controller)
-    : QWidget(parent), profileController(controller), currentUserId(-1) {
+    : QWidget(parent),
+      profileController(controller),
+      profilesWatcher(new QFutureWatcher<QVector<ProfileModel>>(this)),
+      currentUserId(-1) {
     DEBUG("Initializing HomeWidget");
     if (!controller) {
         ERROR("Null controller provided to HomeWidget");
     }
     setupUI();
+
+    connect(profilesWatcher, &QFutureWatcher<QVector<ProfileModel>>::finished,
+            this, &HomeWidget::onProfilesLoaded);
 }
 
 /**
@@ -136,7 +142,8 @@ void HomeWidget::setUserId(int userId) {
 }
 
 /**
- * @brief
+ * @brief Starts loading the user's profiles on a worker thread. A load still
+ * pending for a previous user is cancelled.
  */
 void HomeWidget::populateProfileList() {
     INFO("Starting profile population");
@@ -146,32 +153,34 @@ void HomeWidget::populateProfileList() {
         return;
     }
 
-    profileSelector->clear();
-    QVector<ProfileModel*> profiles;
-
     INFO(QString("Attempting to get profiles for userId: %1")
              .arg(currentUserId));
-    if (profileController->getProfiles(currentUserId, profiles)) {
-        INFO(QString("Retrieved %1 profiles").arg(profiles.size()));
-        for (const auto* profile : profiles) {
-            if (profile) {
-                profileSelector->addItem(profile->getName(), profile->getId());
-                INFO(QString("Added profile - Name: %1, ID: %2")
-                         .arg(profile->getName())
-                         .arg(profile->getId()));
-            }
-        }
-
-        if (profileSelector->count() > 0) {
-            profileSelector->setCurrentIndex(0);
-            INFO("Set initial profile selection");
-        } else {
-            WARNING("No profiles were added to selector");
-        }
-    } else {
-        ERROR("Failed to get profiles from controller");
+    if (profilesWatcher->isRunning()) profilesWatcher->cancel();
+    profilesWatcher->setFuture(
+        profileController->getProfilesAsync(currentUserId));
+}
+
+/**
+ * @brief Fills the profile selector once the background load has finished.
+ */
+void HomeWidget::onProfilesLoaded() {
+    if (profilesWatcher->isCanceled()) return;
+
+    const QVector<ProfileModel> profiles = profilesWatcher->result();
+    profileSelector->clear();
+
+    INFO(QString("Retrieved %1 profiles").arg(profiles.size()));
+    for (const ProfileModel& profile : profiles) {
+        profileSelector->addItem(profile.getName(), profile.getId());
+        INFO(QString("Added profile - Name: %1, ID: %2")
+                 .arg(profile.getName())
+                 .arg(profile.getId()));
     }
 
-    qDeleteAll(profiles);
-    profiles.clear();
+    if (profileSelector->count() > 0) {
+        profileSelector->setCurrentIndex(0);
+        INFO("Set initial profile selection");
+    } else {
+        WARNING("No profiles were added to selector");
+    }
 }
@@ -5,6 +5,7 @@
 
 #include "MainWindow.h"
 
+#include <QApplication>
 #include <QFrame>
 #include <QHBoxLayout>
 #include <QIcon>
@@ -36,8 +37,19 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     currentProfileName = "";
 
     // Initialize controllers
-    databaseManager = new DatabaseManager();
+    databaseManager =
+        new DatabaseManager(qEnvironmentVariableIsSet("RADOTECH_DEV_MODE"));
+    if (qEnvironmentVariableIsSet("RADOTECH_SLOW_QUERY_MS"))
+        databaseManager->setSlowQueryThreshold(
+            qEnvironmentVariableIntValue("RADOTECH_SLOW_QUERY_MS"));
+    connect(qApp, &QCoreApplication::aboutToQuit, this,
+            [this]() { databaseManager->dumpQueryStats(); });
     deviceController = new DeviceController(this);
+    if (qEnvironmentVariableIsSet("RADOTECH_CLOCK_SPEED")) {
+        const double speed =
+            qEnvironmentVariable("RADOTECH_CLOCK_SPEED").toDouble();
+        if (speed > 0) deviceController->getClock()->setAccelerated(speed);
+    }
     userProfileController = new UserProfileController(*databaseManager);
     scanController = new ScanController(*databaseManager);
     userController = new UserController(*databaseManager);
@@ -202,6 +214,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
     profilesWidget->setUserId(loggedInUserId);
 
     historyWidget = new HistoryWidget(this, userProfileController);
+    historyWidget->setResultController(&scanController->getResultController());
     historyWidget->setStyleSheet("background-color: transparent;");
 
     // Add the widgets to the contentStackedWidget
@@ -14,10 +14,12 @@
 #include "ProfileModel.h"
 #include "ResultsWidget.h"
 #include "ScanController.h"
+#include "SimulationClock.h"
 #include "UserProfileController.h"
 
 /**
- * @brief Constructs and initializes the MeasureNowWidget
+ * @brief Constructs and initializes the MeasureNowWidget, a view over a
+ * ScanSession that runs the measurement workflow
  * @param parent The parent widget
  */
 MeasureNowWidget::MeasureNowWidget(QWidget* parent,
@@ -29,11 +31,7 @@ MeasureNowWidget::MeasureNowWidget(QWidget* parent,
       scanController(scanController),
       currentUserId(userId),
       deviceController(deviceController),
-      countdownTimer(nullptr),
-      remainingTime(0),
-      currentScanPage(1),
-      measurementDone(false),
-      scanInProgress(false) {
+      session(new ScanSession(this, scanController, deviceController)) {
     INFO("Initializing MeasureNowWidget");
 
     try {
@@ -53,39 +51,10 @@ MeasureNowWidget::MeasureNowWidget(QWidget* parent,
         // Setup UI components and layouts
         initializeUIComponents(mainLayout);
 
-        // Initialize and configure countdown timer
-        countdownTimer = new QTimer(this);
-        if (!countdownTimer) {
-            throw std::runtime_error("Failed to create countdown timer");
-        }
-        countdownTimer->setInterval(1000);
-        connect(countdownTimer, &QTimer::timeout, this,
-                &MeasureNowWidget::updateCountdown);
-
-        // Connect to the device controller
-        if (this->deviceController) {
-            connect(this->deviceController, &DeviceController::dataReceived,
-                    this, &MeasureNowWidget::receiveData);
-            DEBUG("DeviceController connected successfully");
-        } else {
+        if (!this->deviceController) {
             ERROR("DeviceController is null in setDeviceController");
         }
-
-        // Initialize and configure connection check timer
-        connectionTimer = new QTimer(this);
-        if (!connectionTimer) {
-            throw std::runtime_error("Failed to create connection check timer");
-        }
-        connectionTimer->setInterval(1000);
-        connect(connectionTimer, &QTimer::timeout, this, [this]() {
-            if (!this->deviceController->isConnected() &&
-                stackedWidget->currentIndex() != 0 &&
-                !areAllMeasurementsComplete()) {
-                DEBUG("Device disconnected - resetting measurement");
-                showAlert("Device disconnected - measurement cancelled");
-                resetMeasurement();
-            }
-        });
+        connectSession();
 
         // Setup measurement data and pages
         initImagePaths();
@@ -109,6 +78,9 @@ void MeasureNowWidget::createResultsPage() {
     DEBUG("Creating results page");
 
     resultsWidget = new ResultsWidget(this);
+    if (scanController)
+        resultsWidget->setResultController(
+            &scanController->getResultController());
 
     stackedWidget->addWidget(resultsWidget);
     DEBUG("Results page created successfully");
@@ -119,7 +91,6 @@ void MeasureNowWidget::createResultsPage() {
  */
 void MeasureNowWidget::displayResults() {
     DEBUG("Displaying results");
-    DEBUG("Number of calculated results: " << calculatedResults.size());
 
     updateButtonState();
 
@@ -231,7 +202,7 @@ void MeasureNowWidget::setupPages() {
     try {
         createIntroPage();
 
-        for (int i = 1; i <= TOTAL_SCAN_PAGES; ++i) {
+        for (int i = 1; i <= ScanSession::SCAN_PAGES; ++i) {
             createScanPage(i);
             DEBUG("Created scan page " << i);
         }
@@ -319,9 +290,10 @@ void MeasureNowWidget::createIntroPage() {
     connect(
         profileComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
         this, [this](int index) {
-            selectedProfileId = profileComboBox->itemData(index).toInt();
-            emit profileSelected(selectedProfileId, "Name");
-            DEBUG(QString("Selected profile ID: %1").arg(selectedProfileId));
+            const int profileId = profileComboBox->itemData(index).toInt();
+            session->setProfileId(profileId);
+            emit profileSelected(profileId, "Name");
+            DEBUG(QString("Selected profile ID: %1").arg(profileId));
         });
 
     populateProfileList(profileComboBox);
@@ -375,9 +347,9 @@ void MeasureNowWidget::createScanPage(int pageNum) {
     containerLayout->setSpacing(25);
     containerLayout->setContentsMargins(30, 30, 30, 30);
 
-    bool isRightSide = pageNum > MEASUREMENTS_PER_SIDE;
-    int imageIndex =
-        isRightSide ? (pageNum - MEASUREMENTS_PER_SIDE - 1) : (pageNum - 1);
+    const int perSide = ScanSession::MEASUREMENTS_PER_SIDE;
+    bool isRightSide = pageNum > perSide;
+    int imageIndex = isRightSide ? (pageNum - perSide - 1) : (pageNum - 1);
     QString sideText = isRightSide ? "Right" : "Left";
 
     auto* headerContainer = new QWidget;
@@ -387,8 +359,8 @@ void MeasureNowWidget::createScanPage(int pageNum) {
 
     QString progressText =
         QString("Point %1 of %2")
-            .arg(isRightSide ? pageNum - MEASUREMENTS_PER_SIDE : pageNum)
-            .arg(MEASUREMENTS_PER_SIDE);
+            .arg(isRightSide ? pageNum - perSide : pageNum)
+            .arg(perSide);
     auto* progressLabel = new QLabel(progressText);
     progressLabel->setStyleSheet(
         "font-size: 16px;"
@@ -475,255 +447,91 @@ void MeasureNowWidget::createScanPage(int pageNum) {
 /**
  * @brief Initiates the measurement countdown process
  */
-void MeasureNowWidget::startCountdown() {
-    int currentIndex = stackedWidget->currentIndex();
-    bool isOnScanPage =
-        currentIndex > 0 && currentIndex < stackedWidget->count() - 1;
-
-    if (!isOnScanPage) {
-        DEBUG("Cannot start measurement - not on a scan page");
-        return;
-    }
-
-    if (!deviceController || !deviceController->isDeviceOn() ||
-        !deviceController->isConnected()) {
-        DEBUG("Cannot start measurement - device not connected");
-        return;
-    }
-
-    if (scanInProgress) {
-        DEBUG("Measurement already in progress");
-        return;
-    }
-
-    DEBUG("Starting new measurement");
-    resetState();
-
-    int scanPageIndex = currentIndex - 1;
-    if (scanPageIndex >= 0 && scanPageIndex < countdownLabels.size()) {
-        countdownLabels[scanPageIndex]->setText("Measuring...");
-    }
-
-    measurementDone = false;
-    scanInProgress = true;
-    countdownTimer->start();
-}
+void MeasureNowWidget::startCountdown() { session->startMeasurement(); }
 
 /**
- * @brief Handles completion of a measurement
+ * @brief Handles the start/stop button click event
  */
-void MeasureNowWidget::measurementComplete() {
-    DEBUG("Measurement complete");
+void MeasureNowWidget::onStartStopButtonClicked() {
+    DEBUG("Start/Stop button clicked. Current page index: "
+          << session->getPage());
 
-    if (deviceController) {
-        deviceController->transmitData();
+    if (session->getPage() == ScanSession::INTRO_PAGE) {
+        session->begin();
     } else {
-        ERROR("DeviceController is null in measurementComplete");
-        return;
+        session->cancel();
     }
-
-    measurementDone = true;
 }
 
 /**
- * @brief Processes received measurement data
- * @param data The measurement value received from the device
+ * @brief Handles the image release event during measurement
  */
-void MeasureNowWidget::receiveData(int data) {
-    DEBUG("Received data: " << data);
-
-    int currentPage = stackedWidget->currentIndex();
-    DEBUG("Current page: " << currentPage);
-
-    ScanPoint scanPoint{currentPage, data};
-    rawMeasurements.append(scanPoint);
-    DEBUG("Total measurements collected: " << rawMeasurements.size());
-
-    showMeasurementResult(data);
-}
+void MeasureNowWidget::onImageReleased() { session->release(); }
 
 /**
- * @brief Processes all collected measurements and calculates final results
+ * @brief Mirrors the session's progress in the pages and the alert
  */
-void MeasureNowWidget::processMeasurements() {
-    if (selectedProfileId == -1) {
-        WARNING("No profile selected");
-        return;
-    }
-
-    DEBUG("Processing measurements");
-
-    if (rawMeasurements.size() != TOTAL_SCAN_PAGES) {
-        ERROR("Not all measurements have been collected");
-        return;
-    }
-
-    ScanModel scanModel;
-    scanModel.setProfileId(selectedProfileId);
-
-    QVector<int> measurements(TOTAL_SCAN_PAGES);  // 24 measurements
-
-    std::sort(rawMeasurements.begin(), rawMeasurements.end(),
-              [](const ScanPoint& a, const ScanPoint& b) {
-                  return a.position < b.position;
-              });
-
-    for (int i = 0; i < rawMeasurements.size(); ++i) {
-        measurements[i] = rawMeasurements[i].rawValue;
-    }
-
-    scanModel.setName("Name");
-
-    // Left Side Measurements (positions 1-12)
-    scanModel.setH1Lung(measurements[0]);              // Lungs (Left)
-    scanModel.setH2HeartConstrictor(measurements[1]);  // Pericardium (Left)
-    scanModel.setH3Heart(measurements[2]);             // Heart (Left)
-    scanModel.setH4SmallIntestine(measurements[3]);    // Small Intestine (Left)
-    scanModel.setH5TripleHeater(measurements[4]);      // Immune System (Left)
-    scanModel.setH6LargeIntestine(measurements[5]);    // Large Intestine (Left)
-    scanModel.setF1Spleen(measurements[6]);  // Pancreas and Spleen (Left)
-    scanModel.setF2Liver(measurements[7]);   // Liver (Left)
-    scanModel.setF3Kidney(measurements[8]);  // Kidney (Left)
-    scanModel.setF4UrinaryBladder(measurements[9]);  // Bladder (Left)
-    scanModel.setF5GallBladder(measurements[10]);    // Gallbladder (Left)
-    scanModel.setF6Stomach(measurements[11]);        // Stomach (Left)
-
-    // Right Side Measurements (positions 13-24)
-    scanModel.setH1LungR(measurements[12]);              // Lungs (Right)
-    scanModel.setH2HeartConstrictorR(measurements[13]);  // Pericardium (Right)
-    scanModel.setH3HeartR(measurements[14]);             // Heart (Right)
-    scanModel.setH4SmallIntestineR(
-        measurements[15]);                           // Small Intestine (Right)
-    scanModel.setH5TripleHeaterR(measurements[16]);  // Immune System (Right)
-    scanModel.setH6LargeIntestineR(
-        measurements[17]);                     // Large Intestine (Right)
-    scanModel.setF1SpleenR(measurements[18]);  // Pancreas and Spleen (Right)
-    scanModel.setF2LiverR(measurements[19]);   // Liver (Right)
-    scanModel.setF3KidneyR(measurements[20]);  // Kidney (Right)
-    scanModel.setF4UrinaryBladderR(measurements[21]);  // Bladder (Right)
-    scanModel.setF5GallBladderR(measurements[22]);     // Gallbladder (Right)
-    scanModel.setF6StomachR(measurements[23]);         // Stomach (Right)
-
-    scanModel.setBodyTemp(bodyTemp);
-    scanModel.setBloodPressure(bloodPressure);
-    scanModel.setHeartRate(heartRate);
-    scanModel.setSleepingTime(sleepingTime);
-    scanModel.setCurrentWeight(currentWeight);
-    scanModel.setEmotionalState(emotionalState);
-    scanModel.setOverallFeeling(overallFeeling);
-
-    scanModel.setMeasurements(measurements);
-
-    if (!scanController->storeScan(scanModel)) {
-        ERROR("Failed to store the scan");
-        return;
-    }
-
-    emit scanStored(scanModel);
-
-    if (!resultsWidget) {
-        resultsWidget = new ResultsWidget(this);
-        stackedWidget->addWidget(resultsWidget);
-    }
-    resultsWidget->setShowBackButton(false);
-    resultsWidget->setScanModel(scanModel);
-
-    displayResults();
+void MeasureNowWidget::connectSession() {
+    connect(session, &ScanSession::pageChanged, this,
+            &MeasureNowWidget::showPage);
+    connect(session, &ScanSession::measurementStarted, this,
+            [this](int page) { setStatusText(page, "Measuring..."); });
+    connect(session, &ScanSession::measurementTaken, this,
+            [this](int page, int value) {
+                setStatusText(page,
+                              QString("Measurement value: %1").arg(value));
+            });
+    connect(session, &ScanSession::measurementReset, this, [this](int page) {
+        setStatusText(page, "Place device on measurement point");
+    });
+    connect(session, &ScanSession::alert, this,
+            [this](const QString& message) { showAlert(message); });
+    connect(session, &ScanSession::scanStored, this,
+            &MeasureNowWidget::showScanResults);
 }
 
 /**
- * @brief Checks if all measurements are complete
- * @return True if all measurements have been collected
+ * @brief Shows the page the session moved to
+ * @param page The page index
  */
-bool MeasureNowWidget::areAllMeasurementsComplete() const {
-    return rawMeasurements.size() == TOTAL_SCAN_PAGES;
-}
+void MeasureNowWidget::showPage(int page) {
+    stackedWidget->setCurrentIndex(page);
+    updateButtonState();
 
-/**
- * @brief Updates the UI with the measurement result
- * @param value The measurement value to display
- */
-void MeasureNowWidget::showMeasurementResult(int value) {
-    int currentIndex = stackedWidget->currentIndex() - 1;
-    if (currentIndex >= 0 && currentIndex < countdownLabels.size()) {
-        auto* statusLabel = countdownLabels[currentIndex];
-        statusLabel->setText(QString("Measurement value: %1").arg(value));
+    if (ScanSession::isScanPage(page)) {
+        adjustImageSize(page);
     }
 }
 
 /**
- * @brief Handles the start/stop button click event
+ * @brief Sets the status line of a scan page
+ * @param page The scan page
+ * @param text The status to show
  */
-void MeasureNowWidget::onStartStopButtonClicked() {
-    int currentIndex = stackedWidget->currentIndex();
-    DEBUG("Start/Stop button clicked. Current page index: " << currentIndex);
-
-    if (currentIndex == 0) {
-        if (!deviceController || !deviceController->isDeviceOn() ||
-            !deviceController->isConnected()) {
-            showAlert("Device is off or not connected");
-            return;
-        }
-
-        if (connectionTimer) {
-            connectionTimer->start();
-        }
-        nextPage();
-
-    } else {
-        if (connectionTimer) {
-            connectionTimer->stop();
-        }
-        resetMeasurement();
+void MeasureNowWidget::setStatusText(int page, const QString& text) {
+    int labelIndex = page - 1;
+    if (labelIndex >= 0 && labelIndex < countdownLabels.size()) {
+        countdownLabels[labelIndex]->setText(text);
     }
 }
 
 /**
- * @brief Handles the image release event during measurement
+ * @brief Shows a scan the session stored on the results page
+ * @param scan The stored scan
  */
-void MeasureNowWidget::onImageReleased() {
-    if (!deviceController || !deviceController->isDeviceOn() ||
-        !deviceController->isConnected()) {
-        return;
-    }
+void MeasureNowWidget::showScanResults(const ScanModel& scan) {
+    emit scanStored(scan);
 
-    int currentIndex = stackedWidget->currentIndex();
-    bool isOnScanPage =
-        currentIndex > 0 && currentIndex < stackedWidget->count() - 1;
-
-    if (measurementDone) {
-        DEBUG("Measurement done, proceeding to next page");
-        nextPage();
-        measurementDone = false;
-        scanInProgress = false;
-    } else if (scanInProgress && isOnScanPage) {
-        DEBUG("Measurement interrupted");
-        handleScanError();
+    if (!resultsWidget) {
+        resultsWidget = new ResultsWidget(this);
+        resultsWidget->setResultController(
+            &scanController->getResultController());
+        stackedWidget->addWidget(resultsWidget);
     }
-    scanInProgress = false;
-}
-
-/**
- * @brief Advances to the next page in the measurement workflow
- */
-void MeasureNowWidget::nextPage() {
-    int nextIndex = stackedWidget->currentIndex() + 1;
-    if (nextIndex < stackedWidget->count()) {
-        stackedWidget->setCurrentIndex(nextIndex);
-        currentScanPage++;
-        updateButtonState();
-
-        if (nextIndex > 0 && nextIndex < stackedWidget->count() - 1) {
-            adjustImageSize(nextIndex);
-        }
+    resultsWidget->setShowBackButton(false);
+    resultsWidget->setScanModel(scan);
 
-        if (nextIndex == stackedWidget->count() - 2) {
-            DEBUG("Reached post-scan input page");
-        } else if (nextIndex == stackedWidget->count() - 1) {
-            DEBUG("About to show results page, processing measurements");
-            processMeasurements();
-        }
-    }
+    displayResults();
 }
 
 /**
@@ -826,10 +634,8 @@ void MeasureNowWidget::createPostScanInputPage() {
     proceedButton->setMinimumHeight(40);
     proceedButton->setFixedWidth(200);
 
-    connect(proceedButton, &QPushButton::clicked, this, [this]() {
-        collectUserInputs();
-        nextPage();
-    });
+    connect(proceedButton, &QPushButton::clicked, this,
+            [this]() { session->submitInputs(collectUserInputs()); });
 
     containerLayout->addWidget(instructionsLabel);
     containerLayout->addLayout(formLayout);
@@ -842,66 +648,18 @@ void MeasureNowWidget::createPostScanInputPage() {
 }
 
 /**
- * @brief
+ * @brief Reads the post-scan inputs from the form
  */
-void MeasureNowWidget::collectUserInputs() {
-    bodyTemp = bodyTempEdit->value();
-    bloodPressure = bloodPressureEdit->value();
-    heartRate = heartRateEdit->value();
-    sleepingTime = sleepingTimeEdit->value();
-    currentWeight = currentWeightEdit->value();
-    emotionalState = emotionalStateEdit->currentText().toInt();
-    overallFeeling = overallFeelingEdit->currentText().toInt();
-
-    DEBUG(QString("Collected user inputs: Body Temp=%1°C, Blood Pressure=%2 "
-                  "mmHg, Heart Rate=%3 bpm, Sleeping Time=%4 hours, Current "
-                  "Weight=%5 kg, Emotional State=%6, Overall Feeling=%7")
-              .arg(bodyTemp)
-              .arg(bloodPressure)
-              .arg(heartRate)
-              .arg(sleepingTime)
-              .arg(currentWeight)
-              .arg(emotionalState)
-              .arg(overallFeeling));
-}
-
-/**
- * @brief Resets the measurement process to initial state
- */
-void MeasureNowWidget::resetMeasurement() {
-    DEBUG("Resetting measurement");
-
-    if (connectionTimer) {
-        connectionTimer->stop();
-    }
-
-    resetState();
-    currentScanPage = 1;
-    measurementDone = false;
-    rawMeasurements.clear();
-    stackedWidget->setCurrentIndex(0);
-    updateButtonState();
-}
-
-/**
- * @brief Resets the current measurement state
- */
-void MeasureNowWidget::resetState() {
-    bool wasScanning = scanInProgress;
-    countdownTimer->stop();
-    scanInProgress = false;
-
-    int currentIndex = stackedWidget->currentIndex() - 1;
-    if (currentIndex >= 0 && currentIndex < countdownLabels.size()) {
-        countdownLabels[currentIndex]->setText(
-            "Place device on measurement point");
-    }
-
-    if (wasScanning) {
-        DEBUG("Reset state: Cancelled active scan");
-    } else {
-        DEBUG("Reset state: Cleared previous state");
-    }
+ScanInputs MeasureNowWidget::collectUserInputs() const {
+    ScanInputs inputs;
+    inputs.bodyTemp = bodyTempEdit->value();
+    inputs.bloodPressure = bloodPressureEdit->value();
+    inputs.heartRate = heartRateEdit->value();
+    inputs.sleepingTime = sleepingTimeEdit->value();
+    inputs.currentWeight = currentWeightEdit->value();
+    inputs.emotionalState = emotionalStateEdit->currentText().toInt();
+    inputs.overallFeeling = overallFeelingEdit->currentText().toInt();
+    return inputs;
 }
 
 /**
@@ -918,28 +676,6 @@ void MeasureNowWidget::updateButtonState() {
     }
 }
 
-/**
- * @brief Updates the countdown display during measurement
- */
-void MeasureNowWidget::updateCountdown() {
-    if (!deviceController || !deviceController->isConnected()) {
-        DEBUG("Device disconnected during measurement");
-        showAlert("Device disconnected - measurement cancelled");
-        resetMeasurement();
-        return;
-    }
-
-    int currentIndex = stackedWidget->currentIndex() - 1;
-    if (currentIndex >= 0 && currentIndex < countdownLabels.size()) {
-        if (remainingTime > 0) {
-            remainingTime--;
-        } else {
-            countdownTimer->stop();
-            measurementComplete();
-        }
-    }
-}
-
 /**
  * @brief Populates the profile selection combo box
  * @param profileComboBox The combo box to populate
@@ -987,23 +723,6 @@ void MeasureNowWidget::setErrorState(QLabel* label) {
         "}");
 }
 
-/**
- * @brief Handles errors during the scanning process
- */
-void MeasureNowWidget::handleScanError() {
-    DEBUG("Handling scan error");
-
-    countdownTimer->stop();
-
-    int currentIndex = stackedWidget->currentIndex() - 1;
-    if (currentIndex >= 0 && currentIndex < countdownLabels.size()) {
-        countdownLabels[currentIndex]->setText(
-            "Place device on measurement point");
-    }
-
-    showAlert("Scan interrupted - Please hold device until scan is complete");
-}
-
 /**
  * @brief Shows an alert message to the user
  * @param message The message to display
@@ -1016,7 +735,7 @@ void MeasureNowWidget::showAlert(const QString& message, bool autoHide) {
     alertLabel->setVisible(true);
 
     if (autoHide) {
-        QTimer::singleShot(3000, [this]() {
+        session->getClock()->singleShot(3000, this, [this]() {
             alertLabel->clear();
             alertLabel->setVisible(false);
         });
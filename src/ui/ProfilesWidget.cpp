@@ -30,9 +30,14 @@ ProfilesWidget::ProfilesWidget(QWidget *parent)
       editWidget(nullptr),
       profilesLayout(nullptr),
       profileController(nullptr),
-      profiles() {
+      profiles(),
+      profilesWatcher(new QFutureWatcher<QVector<ProfileModel>>(this)),
+      notifyProfilesChanged(false) {
     INFO("Initializing ProfilesWidget");
 
+    connect(profilesWatcher, &QFutureWatcher<QVector<ProfileModel>>::finished,
+            this, &ProfilesWidget::onProfilesLoaded);
+
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(0, 0, 0, 0);
     mainLayout->setSpacing(0);
@@ -358,7 +363,8 @@ void ProfilesWidget::setUserId(int userId) {
 }
 
 /**
- * @brief Loads the profiles for the current user.
+ * @brief Starts loading the profiles for the current user on a worker thread.
+ * A load still pending for a previous user is cancelled.
  */
 void ProfilesWidget::loadProfiles() {
     DEBUG(QString("Loading profiles for user ID: %1").arg(currentUserId));
@@ -373,29 +379,33 @@ void ProfilesWidget::loadProfiles() {
         return;
     }
 
+    if (profilesWatcher->isRunning()) profilesWatcher->cancel();
+    profilesWatcher->setFuture(
+        profileController->getProfilesAsync(currentUserId));
+}
+
+/**
+ * @brief Rebuilds the profile cards once the background load has finished,
+ * and announces the change if it was caused by a save or delete.
+ */
+void ProfilesWidget::onProfilesLoaded() {
+    if (profilesWatcher->isCanceled()) return;
+
     clearProfiles();
 
-    QVector<ProfileModel *> loadedProfiles;
-    if (profileController->getProfiles(currentUserId, loadedProfiles)) {
-        DEBUG(QString("Successfully loaded %1 profiles")
-                  .arg(loadedProfiles.size()));
-
-        for (const ProfileModel *profile : loadedProfiles) {
-            if (profile) {
-                profiles.append(new ProfileModel(
-                    profile->getId(), profile->getUserId(), profile->getName(),
-                    profile->getDesc(), profile->getSex(), profile->getWeight(),
-                    profile->getHeight(), profile->getDob()));
-            }
-        }
+    const QVector<ProfileModel> loadedProfiles = profilesWatcher->result();
+    DEBUG(QString("Successfully loaded %1 profiles").arg(loadedProfiles.size()));
+
+    for (const ProfileModel &profile : loadedProfiles) {
+        profiles.append(new ProfileModel(profile));
+    }
 
-        qDeleteAll(loadedProfiles);
-        loadedProfiles.clear();
+    refreshProfiles();
+    INFO("Profiles loaded successfully");
 
-        refreshProfiles();
-        INFO("Profiles loaded successfully");
-    } else {
-        WARNING("Failed to load profiles");
+    if (notifyProfilesChanged) {
+        notifyProfilesChanged = false;
+        emit profilesChanged();
     }
 }
 
@@ -530,9 +540,9 @@ void ProfilesWidget::handleProfileSave(QString name, QString sex, int weight,
 
     if (success) {
         INFO("Profile saved successfully");
+        notifyProfilesChanged = true;
         loadProfiles();
         handleBackFromEdit();
-        emit profilesChanged();
     } else {
         WARNING("Failed to save profile");
     }
@@ -551,9 +561,9 @@ void ProfilesWidget::handleProfileDelete(int profileId) {
 
     if (profileController->deleteProfile(profileId)) {
         INFO(QString("Profile %1 deleted successfully").arg(profileId));
+        notifyProfilesChanged = true;
         loadProfiles();
         handleBackFromEdit();
-        emit profilesChanged();
     } else {
         WARNING(QString("Failed to delete profile %1").arg(profileId));
     }
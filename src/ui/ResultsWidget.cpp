@@ -122,6 +122,12 @@ void ResultsWidget::displayResults() {
     vitalsLayout->addStretch();
     cardLayout->addWidget(vitalsWidget);
 
+    // Organ and indicator results, stored or calculated
+    ScanResult result;
+    const bool haveResult =
+        resultController ? resultController->getResult(currentScan, result)
+                         : calculator.calculateScanResult(&currentScan, result);
+
     // Metrics Container
     QWidget* metricsContainer = new QWidget;
     QHBoxLayout* metricsContainerLayout = new QHBoxLayout(metricsContainer);
@@ -140,29 +146,28 @@ void ResultsWidget::displayResults() {
     organLayout->addWidget(organTitle);
     int row = 0, col = 0;
 
-    healthMetrics.clear();
-    if (calculator.calculateOrganHealth(&currentScan, healthMetrics)) {
+    if (haveResult) {
         QGridLayout* organGrid = new QGridLayout;
         organGrid->setSpacing(10);
-        for (const auto& metric : healthMetrics) {
+        for (const auto& metric : result.organs) {
             QWidget* metricCard = new QWidget;
             metricCard->setSizePolicy(QSizePolicy::Expanding,
                                       QSizePolicy::Preferred);
             QHBoxLayout* cardLayout = new QHBoxLayout(metricCard);
             cardLayout->setContentsMargins(0, 0, 0, 0);
 
-            QString statusColor = metric->getLevel() > 0   ? "#FF8001"
-                                  : metric->getLevel() < 0 ? "#D32F2F"
+            QString statusColor = metric.getLevel() > 0   ? "#FF8001"
+                                  : metric.getLevel() < 0 ? "#D32F2F"
                                                            : "#4CAF50";
 
-            QLabel* nameLabel = new QLabel(metric->getName());
+            QLabel* nameLabel = new QLabel(metric.getName());
             nameLabel->setStyleSheet("font-size: 15px; color: #333333;");
             nameLabel->setSizePolicy(QSizePolicy::Expanding,
                                      QSizePolicy::Preferred);
             nameLabel->setMinimumWidth(200);
 
             QLabel* valueLabel =
-                new QLabel(QString::number(metric->getValue(), 'f', 1));
+                new QLabel(QString::number(metric.getValue(), 'f', 1));
             valueLabel->setStyleSheet(
                 QString("font-size: 15px; font-weight: bold; color: %1;")
                     .arg(statusColor));
@@ -195,30 +200,29 @@ void ResultsWidget::displayResults() {
         "font-size: 20px; font-weight: bold; color: #333333;");
     indicatorLayout->addWidget(indicatorTitle);
 
-    QVector<HealthMetricModel*> indicatorMetrics;
-    if (calculator.calculateIndicatorHealth(&currentScan, indicatorMetrics)) {
+    if (haveResult) {
         QGridLayout* indicatorGrid = new QGridLayout;
         indicatorGrid->setSpacing(10);
         row = 0;
         col = 0;
-        for (const auto& metric : indicatorMetrics) {
+        for (const auto& metric : result.indicators) {
             QWidget* metricCard = new QWidget;
             metricCard->setSizePolicy(QSizePolicy::Expanding,
                                       QSizePolicy::Preferred);
             QHBoxLayout* cardLayout = new QHBoxLayout(metricCard);
             cardLayout->setContentsMargins(0, 0, 0, 0);
 
-            QString statusColor = metric->getLevel() > 0   ? "#FF8001"
-                                  : metric->getLevel() < 0 ? "#D32F2F"
+            QString statusColor = metric.getLevel() > 0   ? "#FF8001"
+                                  : metric.getLevel() < 0 ? "#D32F2F"
                                                            : "#4CAF50";
 
-            QLabel* nameLabel = new QLabel(metric->getName());
+            QLabel* nameLabel = new QLabel(metric.getName());
             nameLabel->setStyleSheet("font-size: 15px; color: #333333;");
             nameLabel->setSizePolicy(QSizePolicy::Expanding,
                                      QSizePolicy::Preferred);
 
             QLabel* valueLabel =
-                new QLabel(QString::number(metric->getValue(), 'f', 1));
+                new QLabel(QString::number(metric.getValue(), 'f', 1));
             valueLabel->setStyleSheet(
                 QString("font-size: 15px; font-weight: bold; color: %1;")
                     .arg(statusColor));
@@ -264,6 +268,15 @@ void ResultsWidget::displayResults() {
     cardLayout->addStretch();
 }
 
+/**
+ * @brief Sets where results are read from. Without a controller they are
+ * calculated every time a scan is shown.
+ * @param controller the shared result store, or nullptr
+ */
+void ResultsWidget::setResultController(ScanResultController* controller) {
+    resultController = controller;
+}
+
 /**
  * @brief
  *
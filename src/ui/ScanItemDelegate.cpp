@@ -0,0 +1,92 @@
+/**
+ * @file ScanItemDelegate.cpp
+ * @brief Implementation of the ScanItemDelegate class.
+ */
+
+#include "ScanItemDelegate.h"
+
+#include <QDate>
+#include <QPainter>
+#include <QPainterPath>
+
+#include "ScanListModel.h"
+
+ScanItemDelegate::ScanItemDelegate(QObject* parent)
+    : QStyledItemDelegate(parent) {
+    dayFont.setPixelSize(22);
+    dayFont.setBold(true);
+    monthFont.setPixelSize(14);
+    tempFont.setPixelSize(15);
+    vitalsFont.setPixelSize(14);
+}
+
+/**
+ * @brief Paints one scan card, highlighted while the mouse is over it.
+ *
+ * @param painter The painter to use for drawing
+ * @param option The style options for the item
+ * @param index The model index of the scan being painted
+ */
+void ScanItemDelegate::paint(QPainter* painter,
+                             const QStyleOptionViewItem& option,
+                             const QModelIndex& index) const {
+    const bool hovered = option.state & QStyle::State_MouseOver;
+    const QRectF card =
+        QRectF(option.rect).adjusted(0.5, 0.5, -0.5, -CARD_SPACING - 0.5);
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    QPainterPath path;
+    path.addRoundedRect(card, 10, 10);
+    painter->fillPath(path, QColor(hovered ? "#F8F8F8" : "white"));
+    painter->setPen(QColor(hovered ? "#D0D0D0" : "#E0E0E0"));
+    painter->drawPath(path);
+
+    const QDate createdOn =
+        index.data(ScanListModel::CreatedOnRole).toDate();
+    const int top = option.rect.top() + 10;
+    const int half = (CARD_HEIGHT - 20) / 2;
+
+    QRect dateRect(option.rect.left() + CARD_PADDING, top, DATE_WIDTH, half);
+    painter->setFont(dayFont);
+    painter->setPen(QColor("#333333"));
+    painter->drawText(dateRect, Qt::AlignLeft | Qt::AlignBottom,
+                      createdOn.toString("dd"));
+
+    dateRect.translate(0, half);
+    painter->setFont(monthFont);
+    painter->setPen(QColor("#666666"));
+    painter->drawText(dateRect, Qt::AlignLeft | Qt::AlignTop,
+                      createdOn.toString("MMM yyyy"));
+
+    const int vitalsLeft = dateRect.right() + CARD_PADDING;
+    QRect vitalsRect(vitalsLeft, top,
+                     option.rect.right() - CARD_PADDING - vitalsLeft, half);
+    painter->setFont(tempFont);
+    painter->setPen(QColor("#333333"));
+    painter->drawText(
+        vitalsRect, Qt::AlignLeft | Qt::AlignBottom,
+        QString("Temperature: %1°C")
+            .arg(index.data(ScanListModel::BodyTempRole).toInt()));
+
+    vitalsRect.translate(0, half);
+    painter->setFont(vitalsFont);
+    painter->setPen(QColor("#666666"));
+    painter->drawText(
+        vitalsRect, Qt::AlignLeft | Qt::AlignTop,
+        QString("HR: %1 bpm  •  BP: %2 mmHg")
+            .arg(index.data(ScanListModel::HeartRateRole).toInt())
+            .arg(index.data(ScanListModel::BloodPressureRole).toInt()));
+
+    painter->restore();
+}
+
+/**
+ * @brief Every card has the same height, including the gap below it.
+ */
+QSize ScanItemDelegate::sizeHint(const QStyleOptionViewItem& option,
+                                 const QModelIndex& index) const {
+    Q_UNUSED(index);
+    return QSize(option.rect.width(), CARD_HEIGHT + CARD_SPACING);
+}
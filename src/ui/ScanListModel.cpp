@@ -0,0 +1,115 @@
+/**
+ * @file ScanListModel.cpp
+ * @brief Implementation of the ScanListModel class.
+ */
+
+#include "ScanListModel.h"
+
+#include "Logging.h"
+
+ScanListModel::ScanListModel(UserProfileController* controller,
+                             QObject* parent)
+    : QAbstractListModel(parent),
+      userProfileController(controller),
+      profileId(-1),
+      pageWatcher(new QFutureWatcher<QVector<ScanModel>>(this)),
+      hasMore(false),
+      fetching(false),
+      firstPageLoaded(false) {
+    connect(pageWatcher, &QFutureWatcher<QVector<ScanModel>>::finished, this,
+            &ScanListModel::onPageLoaded);
+}
+
+int ScanListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : scans.size();
+}
+
+QVariant ScanListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= scans.size()) return QVariant();
+
+    const ScanModel& scan = scans[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+        case CreatedOnRole:
+            return scan.getCreatedOn();
+        case BodyTempRole:
+            return scan.getBodyTemp();
+        case HeartRateRole:
+            return scan.getHeartRate();
+        case BloodPressureRole:
+            return scan.getBloodPressure();
+        default:
+            return QVariant();
+    }
+}
+
+/**
+ * @brief Called by the view as it nears the last loaded row.
+ */
+bool ScanListModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && hasMore && !fetching;
+}
+
+/**
+ * @brief Loads the next page of older scans on a worker thread. One extra
+ * scan is requested to learn whether another page follows.
+ */
+void ScanListModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent) || !userProfileController) return;
+
+    ScanCursor cursor;
+    if (!scans.isEmpty()) cursor = ScanCursor(scans.last());
+
+    fetching = true;
+    pageWatcher->setFuture(userProfileController->getProfileScansPageAsync(
+        profileId, cursor, FETCH_SIZE + 1, PageDirection::Older));
+}
+
+void ScanListModel::setProfile(int id) {
+    profileId = id;
+    reload();
+}
+
+void ScanListModel::reload() {
+    // A page still loading for the old contents is dropped when it finishes
+    if (pageWatcher->isRunning()) pageWatcher->cancel();
+
+    beginResetModel();
+    scans.clear();
+    hasMore = profileId > 0;
+    fetching = false;
+    firstPageLoaded = !hasMore;
+    endResetModel();
+
+    fetchMore(QModelIndex());
+}
+
+const ScanModel& ScanListModel::scanAt(int row) const { return scans.at(row); }
+
+bool ScanListModel::isLoading() const { return !firstPageLoaded; }
+
+/**
+ * @brief Appends a finished page to the end of the list.
+ */
+void ScanListModel::onPageLoaded() {
+    if (pageWatcher->isCanceled()) return;
+
+    QVector<ScanModel> page = pageWatcher->result();
+    fetching = false;
+    firstPageLoaded = true;
+
+    hasMore = page.size() > FETCH_SIZE;
+    if (hasMore) page.removeLast();
+
+    if (!page.isEmpty()) {
+        beginInsertRows(QModelIndex(), scans.size(),
+                        scans.size() + page.size() - 1);
+        scans += page;
+        endInsertRows();
+    }
+
+    DEBUG(QString("Loaded %1 scans, %2 in history")
+              .arg(page.size())
+              .arg(scans.size()));
+    emit pageLoaded();
+}
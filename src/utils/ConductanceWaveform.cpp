@@ -0,0 +1,40 @@
+/**
+ * @file ConductanceWaveform.cpp
+ * @brief Generates a simulated conductance waveform for one point.
+ */
+
+#include "ConductanceWaveform.h"
+
+#include <algorithm>
+#include <cmath>
+
+ConductanceWaveform::ConductanceWaveform(const WaveformShape& shape,
+                                         int sampleRate, quint32 seed)
+    : shape(shape),
+      msPerSample(1000.0 / std::max(sampleRate, 1)),
+      index(0),
+      generator(seed),
+      noise(0.0f, shape.noise),
+      uniform(0.0f, 1.0f) {}
+
+/**
+ * @brief Generates the next sample. Before contact the signal is noise
+ * around zero; readings are never negative.
+ */
+float ConductanceWaveform::next() {
+    const double ms = index++ * msPerSample;
+
+    float value = 0;
+    if (ms >= shape.contactMs) {
+        const double rising = (ms - shape.contactMs) / shape.riseMs;
+        value = shape.plateau * static_cast<float>(1 - std::exp(-rising));
+    }
+    value += noise(generator);
+    if (uniform(generator) < shape.spikeRate)
+        value += (2 * uniform(generator) - 1) * shape.spikeSize;
+    return std::max(value, 0.0f);
+}
+
+void ConductanceWaveform::generate(float* samples, int count) {
+    for (int i = 0; i < count; ++i) samples[i] = next();
+}
@@ -7,58 +7,536 @@
 #include "DatabaseManager.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+/**
+ * @brief Finishes a cached statement when it goes out of scope, so one that
+ * failed or whose visitor threw does not keep its read cursor open until it
+ * is next used.
+ */
+class StatementFinisher {
+   public:
+    explicit StatementFinisher(QSqlQuery& query) : query(query) {}
+    ~StatementFinisher() { query.finish(); }
+
+    StatementFinisher(const StatementFinisher&) = delete;
+    StatementFinisher& operator=(const StatementFinisher&) = delete;
+
+   private:
+    QSqlQuery& query;
+};
+
+/**
+ * @brief Describes bound parameters by count and type only. Bindings carry
+ * emails and password hashes, which must never reach the log.
+ */
+QString describeBindings(const QList<QVariant>& params) {
+    QStringList types;
+    for (const QVariant& param : params)
+        types.append(param.isNull() ? QStringLiteral("null")
+                                    : QString(param.typeName()));
+    return QString("%1 (%2)").arg(params.size()).arg(types.join(", "));
+}
+
+}  // namespace
+
+/**
+ * Schema migrations in the order they are applied. A database at
+ * PRAGMA user_version N has had the first N scripts applied, so new schema
+ * changes must be appended here and never edited once released.
+ */
+const QStringList DatabaseManager::migrations = {
+    ":/sql/schema.sql",
+    ":/sql/002_indexes.sql",
+    ":/sql/003_scan_trend.sql",
+    ":/sql/004_scan_result.sql",
+    ":/sql/005_profile_summary.sql",
+    ":/sql/006_population_sketch.sql",
+};
+
+/**
+ * @brief Opens the database and brings its schema up to date.
+ * @param devMode when true, seeds the database with the dummy users, profiles
+ * and scans from dummy_data.sql
+ * @param path the database file; empty for Radotech.db next to the
+ * executable
+ */
+DatabaseManager::DatabaseManager(bool devMode, const QString& path)
+    : databasePath(path),
+      devMode(devMode),
+      statementCacheHits(0),
+      statementCacheMisses(0),
+      queryPlanCheck(false),
+      slowQueryThreshold(DEFAULT_SLOW_QUERY_MS) {
+    static std::atomic<int> managerCount(0);
+    connectionPrefix = QString("radotech_%1").arg(managerCount++);
 
-DatabaseManager::DatabaseManager() {
     Q_INIT_RESOURCE(resources);
     init();
 }
 
 DatabaseManager::~DatabaseManager() {
     qInfo() << "Destructing db manager";
-    if (dbConnection.open()) dbConnection.close();
+    qInfo() << "Statement cache hits:" << statementCacheHits.load()
+            << "misses:" << statementCacheMisses.load();
+
+    // Closes this thread's connection. Worker threads close their own
+    // connections when they exit, so the manager must outlive any work it
+    // was handed.
+    connections.setLocalData(nullptr);
 }
 
-void DatabaseManager::execute(const QString& query,
-                              const QList<QVariant>& params) {
-    QSqlQuery sqlQuery(dbConnection);
+/**
+ * @brief Opens a named connection for the calling thread.
+ * @param name the unique connection name
+ * @param path the database file to open
+ */
+DatabaseManager::ThreadConnection::ThreadConnection(const QString& name,
+                                                    const QString& path)
+    : statementCache(STATEMENT_CACHE_SIZE), transactionDepth(0) {
+    db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(path);
 
-    if (!sqlQuery.prepare(query)) handleError(sqlQuery.lastError());
+    // Wait for another connection's write lock instead of failing at once
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+
+    if (!db.open()) {
+        qDebug() << "Failed to open database connection" << name << ":"
+                 << db.lastError().text();
+        return;
+    }
+
+    // WAL lets readers on other threads proceed while one thread writes
+    QSqlQuery pragma(db);
+    if (!pragma.exec("PRAGMA journal_mode = WAL;") ||
+        !pragma.exec("PRAGMA synchronous = NORMAL;")) {
+        qDebug() << "Failed to configure connection" << name << ":"
+                 << pragma.lastError().text();
+    }
+}
+
+/**
+ * @brief Releases the cached statements, closes the connection and removes
+ * it from Qt's connection registry. Runs on the owning thread.
+ */
+DatabaseManager::ThreadConnection::~ThreadConnection() {
+    // Cached statements must be released before the connection is closed
+    statementCache.clear();
+
+    QString name = db.connectionName();
+    db.close();
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(name);
+}
+
+/**
+ * @brief Gets the calling thread's connection, opening it on first use.
+ * @return the connection owned by the current thread
+ */
+QSqlDatabase& DatabaseManager::connection() {
+    if (!connections.hasLocalData()) {
+        QString name =
+            QString("%1_%2")
+                .arg(connectionPrefix)
+                .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+        connections.setLocalData(new ThreadConnection(name, databasePath));
+    }
+    return connections.localData()->db;
+}
+
+/**
+ * @brief Gets the calling thread's prepared-statement cache.
+ * @return the statement cache for the current thread's connection
+ */
+QCache<QString, QSqlQuery>& DatabaseManager::statementCache() {
+    connection();
+    return connections.localData()->statementCache;
+}
+
+/**
+ * @brief Executes a statement that returns no rows.
+ * @param query the SQL text to execute
+ * @param params the positional parameters to bind
+ * @return the rowid of the inserted row for an INSERT, otherwise invalid
+ */
+QVariant DatabaseManager::execute(const QString& query,
+                                  const QList<QVariant>& params) {
+    QSqlQuery& sqlQuery = *prepare(query);
 
     for (int i = 0; i < params.size(); ++i) sqlQuery.bindValue(i, params[i]);
 
-    if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
+    QElapsedTimer timer;
+    timer.start();
+    int rows;
+    QVariant insertId;
+    {
+        StatementFinisher finisher(sqlQuery);
+        if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
+        rows = std::max(0, sqlQuery.numRowsAffected());
+        insertId = sqlQuery.lastInsertId();
+    }
+
+    recordQuery(query, params, timer.nsecsElapsed(), rows);
+    return insertId;
 }
 
 void DatabaseManager::query(const QString& query, const QList<QVariant>& params,
                             QList<QMap<QString, QVariant>>& results) {
-    QSqlQuery sqlQuery(dbConnection);
+    QSqlQuery& sqlQuery = *prepare(query);
+
+    for (int i = 0; i < params.size(); ++i) sqlQuery.bindValue(i, params[i]);
+
+    QElapsedTimer timer;
+    timer.start();
+    results.clear();
+    {
+        // Releases the statement's read lock so it can be re-executed later
+        StatementFinisher finisher(sqlQuery);
+        if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
+
+        const QSqlRecord record = sqlQuery.record();
+        while (sqlQuery.next()) {
+            QMap<QString, QVariant> row;
+            for (int i = 0; i < record.count(); ++i) {
+                row.insert(record.fieldName(i), sqlQuery.value(i));
+            }
+            results.append(row);
+        }
+    }
+
+    recordQuery(query, params, timer.nsecsElapsed(), results.size());
+}
+
+/**
+ * @brief Executes the same statement once per parameter set inside a single
+ * transaction, so the whole batch pays for one commit instead of one per row.
+ * Rolls back and throws if any row fails. Inside transaction() the batch
+ * joins the caller's transaction instead.
+ * @param query the SQL text to execute
+ * @param paramSets one list of positional parameters per row
+ * @return the number of rows executed
+ */
+int DatabaseManager::executeBatch(const QString& query,
+                                  const QList<QList<QVariant>>& paramSets) {
+    if (paramSets.isEmpty()) return 0;
+
+    QSqlQuery& sqlQuery = *prepare(query);
+
+    QElapsedTimer timer;
+    timer.start();
+    transaction([this, &sqlQuery, &paramSets]() {
+        StatementFinisher finisher(sqlQuery);
+        for (const QList<QVariant>& params : paramSets) {
+            for (int i = 0; i < params.size(); ++i)
+                sqlQuery.bindValue(i, params[i]);
+
+            if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
+        }
+    });
+
+    // Timed as a whole, commit included; kept apart from single executions
+    recordQuery("[batch] " + query, {}, timer.nsecsElapsed(),
+                paramSets.size());
+    return paramSets.size();
+}
 
-    if (!sqlQuery.prepare(query)) handleError(sqlQuery.lastError());
+/**
+ * @brief Runs work inside a transaction on the calling thread's connection.
+ * Commits if the work returns and rolls back and rethrows if it throws.
+ * Nested calls join the outermost transaction, so helpers that need
+ * atomicity can be composed into larger units.
+ * @param work the statements to run
+ */
+void DatabaseManager::transaction(const std::function<void()>& work) {
+    QSqlDatabase& dbConnection = connection();
+    int& depth = connections.localData()->transactionDepth;
+
+    if (depth > 0) {
+        ++depth;
+        try {
+            work();
+        } catch (...) {
+            --depth;
+            throw;
+        }
+        --depth;
+        return;
+    }
+
+    if (!dbConnection.transaction()) handleError(dbConnection.lastError());
+    depth = 1;
+    try {
+        work();
+    } catch (...) {
+        depth = 0;
+        dbConnection.rollback();
+        throw;
+    }
+    depth = 0;
+
+    if (!dbConnection.commit()) {
+        QSqlError error = dbConnection.lastError();
+        dbConnection.rollback();
+        handleError(error);
+    }
+}
+
+/**
+ * @brief Executes a query and streams each row to a visitor without
+ * materializing the result set.
+ * @param query the SQL text to execute
+ * @param params the positional parameters to bind
+ * @param visitor called once per row, in result order
+ * @return the number of rows visited
+ */
+int DatabaseManager::queryEach(const QString& query,
+                               const QList<QVariant>& params,
+                               const RowVisitor& visitor) {
+    // Taken out of the cache while the rows are visited, so a visitor that
+    // runs the same SQL, or evicts it, cannot rebind or delete it mid-loop
+    prepare(query);
+    std::unique_ptr<QSqlQuery> statement(statementCache().take(query));
+    QSqlQuery& sqlQuery = *statement;
 
     for (int i = 0; i < params.size(); ++i) sqlQuery.bindValue(i, params[i]);
 
-    if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
+    QElapsedTimer timer;
+    timer.start();
+    int rows = 0;
+    {
+        StatementFinisher finisher(sqlQuery);
+        if (!sqlQuery.exec()) handleError(sqlQuery.lastError());
 
-    results.clear();
-    while (sqlQuery.next()) {
-        QMap<QString, QVariant> row;
-        for (int i = 0; i < sqlQuery.record().count(); ++i) {
-            row.insert(sqlQuery.record().fieldName(i), sqlQuery.value(i));
+        while (sqlQuery.next()) {
+            visitor(sqlQuery);
+            ++rows;
+        }
+    }
+    statementCache().insert(query, statement.release());
+
+    // Includes the time spent in the visitor
+    recordQuery(query, params, timer.nsecsElapsed(), rows);
+    return rows;
+}
+
+/**
+ * @brief Returns a prepared statement for the given SQL text, reusing a
+ * cached one when available so SQLite does not have to parse and plan it
+ * again.
+ * @param query the SQL text to prepare
+ * @return a pointer to the prepared statement, owned by the cache
+ */
+QSqlQuery* DatabaseManager::prepare(const QString& query) {
+    if (queryPlanCheck) checkQueryPlan(query);
+
+    QCache<QString, QSqlQuery>& cache = statementCache();
+    if (QSqlQuery* cached = cache.object(query)) {
+        ++statementCacheHits;
+        return cached;
+    }
+
+    ++statementCacheMisses;
+    QSqlQuery* sqlQuery = new QSqlQuery(connection());
+
+    // Rows are only ever read front to back; this stops the driver from
+    // caching the whole result set
+    sqlQuery->setForwardOnly(true);
+    if (!sqlQuery->prepare(query)) {
+        QSqlError error = sqlQuery->lastError();
+        delete sqlQuery;
+        handleError(error);
+    }
+
+    // Least recently used statements are evicted once the cache is full
+    cache.insert(query, sqlQuery);
+    return sqlQuery;
+}
+
+int DatabaseManager::getStatementCacheHits() const {
+    return statementCacheHits;
+}
+
+int DatabaseManager::getStatementCacheMisses() const {
+    return statementCacheMisses;
+}
+
+/**
+ * @brief Drops the calling thread's cached statements.
+ */
+void DatabaseManager::clearStatementCache() { statementCache().clear(); }
+
+/**
+ * @brief Enables or disables query plan checking. While enabled, every
+ * statement is run through EXPLAIN QUERY PLAN first and rejected if SQLite
+ * would answer it with a full table scan. Intended for tests only.
+ * @param enabled whether to check query plans
+ */
+void DatabaseManager::setQueryPlanCheck(bool enabled) {
+    QMutexLocker locker(&fullScanMutex);
+    queryPlanCheck = enabled;
+    if (enabled) fullScanStatements.clear();
+}
+
+/**
+ * @brief Gets the statements rejected since query plan checking was enabled
+ * @return the SQL text of each statement that needed a full table scan
+ */
+QStringList DatabaseManager::getFullScanStatements() {
+    QMutexLocker locker(&fullScanMutex);
+    return fullScanStatements;
+}
+
+/**
+ * @brief Lets a statement that reads a whole table by design pass the query
+ * plan check.
+ * @param query the SQL text, exactly as it is executed
+ */
+void DatabaseManager::allowFullScan(const QString& query) {
+    QMutexLocker locker(&fullScanMutex);
+    fullScanAllowed.insert(query);
+}
+
+/**
+ * @brief Runs EXPLAIN QUERY PLAN on a statement and throws if any step scans
+ * a whole table, unless the statement was allowed with allowFullScan().
+ * @param query the SQL text to check
+ */
+void DatabaseManager::checkQueryPlan(const QString& query) {
+    {
+        QMutexLocker locker(&fullScanMutex);
+        if (fullScanAllowed.contains(query)) return;
+    }
+
+    // Details read e.g. "SEARCH scan USING INDEX idx_scan_profile_created
+    // (profile_id=?)". A SCAN reads every row even when it walks an index,
+    // as in "SCAN scan USING COVERING INDEX ...", except a constant row.
+    QString fullScan;
+    for (const QString& detail : explainQueryPlan(query)) {
+        if (detail.startsWith("SCAN") &&
+            !detail.startsWith("SCAN CONSTANT ROW")) {
+            fullScan = detail;
+            break;
         }
-        results.append(row);
     }
+
+    if (!fullScan.isEmpty()) {
+        QMutexLocker locker(&fullScanMutex);
+        fullScanStatements.append(query);
+        throw std::runtime_error("Full table scan (" + fullScan.toStdString() +
+                                 ") in: " + query.toStdString());
+    }
+}
+
+/**
+ * @brief Asks SQLite how it would run a statement.
+ * @param query the SQL text to explain
+ * @return the detail column of each EXPLAIN QUERY PLAN row
+ */
+QStringList DatabaseManager::explainQueryPlan(const QString& query) {
+    QSqlQuery plan(connection());
+    plan.setForwardOnly(true);
+    if (!plan.prepare("EXPLAIN QUERY PLAN " + query) || !plan.exec())
+        handleError(plan.lastError());
+
+    // Rows are (id, parent, notused, detail)
+    QStringList details;
+    while (plan.next()) details.append(plan.value(3).toString());
+    plan.finish();
+    return details;
 }
 
+/**
+ * @brief Adds an execution to the query statistics and logs it, with the
+ * types of its bindings and its query plan, if it ran past the slow-query
+ * threshold. Bound values are never logged.
+ * @param query the SQL text as executed
+ * @param params the bound parameters
+ * @param nanoseconds time from execution until the last row was read
+ * @param rows rows returned or affected
+ */
+void DatabaseManager::recordQuery(const QString& query,
+                                  const QList<QVariant>& params,
+                                  qint64 nanoseconds, qint64 rows) {
+    queryStats.record(query, nanoseconds, rows);
+
+    const int threshold = slowQueryThreshold;
+    if (threshold < 0 || nanoseconds < threshold * qint64(1000000)) return;
+
+    qWarning().noquote() << "Slow query:" << nanoseconds / 1e6 << "ms," << rows
+                         << "rows:" << query.simplified();
+    if (!params.isEmpty())
+        qWarning().noquote() << "  Bindings:" << describeBindings(params);
+
+    // Batches are timed as a whole and have no single plan to show
+    if (query.startsWith("[batch] ")) return;
+    try {
+        for (const QString& detail : explainQueryPlan(query))
+            qWarning().noquote() << "  Plan:" << detail;
+    } catch (const std::exception& e) {
+        qWarning() << "  Plan unavailable:" << e.what();
+    }
+}
+
+/**
+ * @brief Sets how long a statement may take before it is logged as slow.
+ * @param milliseconds the threshold, or a negative value to log nothing
+ */
+void DatabaseManager::setSlowQueryThreshold(int milliseconds) {
+    slowQueryThreshold = milliseconds;
+}
+
+int DatabaseManager::getSlowQueryThreshold() const {
+    return slowQueryThreshold;
+}
+
+/**
+ * @brief Gets the latency histogram and row count for one statement.
+ * @param query the SQL text; literal values do not need to match
+ * @return the statistics, empty if the statement never ran
+ */
+StatementStats DatabaseManager::getQueryStats(const QString& query) {
+    return queryStats.statsFor(query);
+}
+
+/**
+ * @brief Formats the statistics of every statement run so far, most total
+ * time first.
+ * @return one line per statement with its count, rows, p50/p95/p99, maximum
+ * and total latency
+ */
+QString DatabaseManager::getQueryStatsReport() { return queryStats.report(); }
+
+/**
+ * @brief Logs the query statistics report. MainWindow calls it once, when
+ * the application quits.
+ */
+void DatabaseManager::dumpQueryStats() {
+    if (queryStats.snapshot().isEmpty()) return;
+
+    qInfo() << "Query statistics:";
+    for (const QString& line :
+         getQueryStatsReport().split('\n', Qt::SkipEmptyParts))
+        qInfo().noquote() << line;
+}
+
+void DatabaseManager::resetQueryStats() { queryStats.reset(); }
+
 void DatabaseManager::handleError(const QSqlError& error) {
     throw std::runtime_error("Database error: " + error.text().toStdString());
 }
 
-void DatabaseManager::executeSqlScript(const QString& filePath,
+bool DatabaseManager::executeSqlScript(const QString& filePath,
                                        QSqlDatabase& db) {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qDebug() << "Failed to open SQL file:" << file.errorString();
-        return;
+        return false;
     }
 
     QTextStream stream(&file);
@@ -67,6 +545,7 @@ void DatabaseManager::executeSqlScript(const QString& filePath,
 
     QStringList commands = sqlQuery.split(";", Qt::SkipEmptyParts);
     QSqlQuery query(db);
+    bool success = true;
 
     for (const QString& command : commands) {
         QString trimmedCommand = command.trimmed();
@@ -74,17 +553,68 @@ void DatabaseManager::executeSqlScript(const QString& filePath,
             if (!query.exec(trimmedCommand)) {
                 qDebug() << "SQL Error:" << query.lastError().text()
                          << "\nCommand:" << trimmedCommand;
+                success = false;
             }
         }
     }
+
+    return success;
+}
+
+/**
+ * @brief Reads the schema version stored in PRAGMA user_version.
+ * @return the number of migrations applied, or -1 if it could not be read
+ */
+int DatabaseManager::schemaVersion() {
+    QSqlQuery query(connection());
+    if (!query.exec("PRAGMA user_version;") || !query.next()) {
+        qDebug() << "Failed to read schema version:"
+                 << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+/**
+ * @brief Applies every migration newer than the database's user_version,
+ * each in its own transaction. Does nothing when the schema is current.
+ * @return true if the schema is up to date
+ */
+bool DatabaseManager::migrate() {
+    int version = schemaVersion();
+    if (version < 0) return false;
+
+    if (version >= migrations.size()) {
+        qDebug() << "Database schema is current at version" << version;
+        return true;
+    }
+
+    QSqlDatabase& dbConnection = connection();
+    for (int i = version; i < migrations.size(); ++i) {
+        int target = i + 1;
+        qDebug() << "Migrating database schema to version" << target;
+
+        dbConnection.transaction();
+        QSqlQuery pragma(dbConnection);
+        if (!executeSqlScript(migrations[i], dbConnection) ||
+            !pragma.exec(QString("PRAGMA user_version = %1;").arg(target))) {
+            dbConnection.rollback();
+            qCritical() << "Failed to migrate database schema to version"
+                        << target;
+            return false;
+        }
+        dbConnection.commit();
+    }
+
+    return true;
 }
 
 void DatabaseManager::init() {
-    dbConnection = QSqlDatabase::addDatabase("QSQLITE");
-    dbConnection.setDatabaseName(QCoreApplication::applicationDirPath() +
-                                 "/Radotech.db");
+    if (databasePath.isEmpty())
+        databasePath = QCoreApplication::applicationDirPath() + "/Radotech.db";
+    QSqlDatabase& dbConnection = connection();
 
-    if (!dbConnection.open()) {
+    if (!dbConnection.isOpen()) {
         qDebug() << "Failed to open database:"
                  << dbConnection.lastError().text();
         return;
@@ -92,8 +622,10 @@ void DatabaseManager::init() {
         qDebug() << "Database connection successful";
     }
 
-    executeSqlScript(":/sql/schema.sql", dbConnection);
-    executeSqlScript(":/sql/dummy_data.sql", dbConnection);
+    migrate();
+
+    // Seed data is only wanted while developing and running the tests
+    if (devMode) executeSqlScript(":/sql/dummy_data.sql", dbConnection);
 }
 
-bool DatabaseManager::isConnectionOpen() { return dbConnection.isOpen(); }
+bool DatabaseManager::isConnectionOpen() { return connection().isOpen(); }
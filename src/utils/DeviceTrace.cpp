@@ -0,0 +1,272 @@
+/**
+ * @file DeviceTrace.cpp
+ * @brief A compact append-only binary trace of device events.
+ */
+
+#include "DeviceTrace.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+
+const int HEADER_SIZE = 8;
+
+void appendVarint(QByteArray& bytes, quint64 value) {
+    while (value >= 0x80) {
+        bytes.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.append(static_cast<char>(value));
+}
+
+void appendFloat(QByteArray& bytes, float value) {
+    quint32 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int shift = 0; shift < 32; shift += 8)
+        bytes.append(static_cast<char>((bits >> shift) & 0xff));
+}
+
+float readFloat(const char* data) {
+    quint32 bits = 0;
+    for (int i = 0; i < 4; ++i)
+        bits |= quint32(static_cast<quint8>(data[i])) << (8 * i);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+const QByteArray TraceWriter::MAGIC("RDTRACE");
+
+TraceWriter::TraceWriter() : lastTime(0), written(0), opened(false) {}
+
+TraceWriter::~TraceWriter() { close(); }
+
+/**
+ * @brief Starts a new trace, replacing any file at the path.
+ * @param path the trace file
+ * @return false if the file could not be created
+ */
+bool TraceWriter::open(const QString& path) {
+    close();
+
+    QMutexLocker locker(&mutex);
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << "Failed to open trace" << path << ":"
+                    << file.errorString();
+        return false;
+    }
+
+    buffer.clear();
+    buffer.append(MAGIC);
+    buffer.append(static_cast<char>(VERSION));
+    written = 0;
+    lastTime = 0;
+    clock.start();
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief Writes out anything buffered and closes the trace.
+ */
+void TraceWriter::close() {
+    QMutexLocker locker(&mutex);
+    if (!opened) return;
+    opened = false;
+    flush();
+    file.close();
+}
+
+/**
+ * @brief Records a state change, battery tick, reading or stream start or
+ * stop. Does nothing unless a trace is open.
+ */
+void TraceWriter::write(TraceRecord type, int value, int sampleRate) {
+    if (!opened) return;
+    QMutexLocker locker(&mutex);
+    if (!opened) return;
+
+    begin(type);
+    switch (type) {
+        case TraceRecord::Power:
+        case TraceRecord::Connection:
+        case TraceRecord::Charging:
+        case TraceRecord::Battery:
+            buffer.append(static_cast<char>(value));
+            break;
+        case TraceRecord::Data:
+            appendVarint(buffer, static_cast<quint32>(value));
+            break;
+        case TraceRecord::StreamStart:
+            appendVarint(buffer, static_cast<quint32>(value));
+            appendVarint(buffer, static_cast<quint32>(sampleRate));
+            break;
+        case TraceRecord::Samples:
+        case TraceRecord::StreamStop:
+            break;
+    }
+    if (buffer.size() >= FLUSH_SIZE) flush();
+}
+
+/**
+ * @brief Records a block of consecutive samples from a point. Does nothing
+ * unless a trace is open.
+ * @param point the point streamed
+ * @param timestamp device time of the first sample, in nanoseconds
+ */
+void TraceWriter::writeSamples(int point, qint64 timestamp,
+                               const float* values, int count) {
+    if (!opened || count <= 0) return;
+    QMutexLocker locker(&mutex);
+    if (!opened) return;
+
+    begin(TraceRecord::Samples);
+    appendVarint(buffer, static_cast<quint32>(point));
+    appendVarint(buffer, static_cast<quint64>(timestamp));
+    appendVarint(buffer, static_cast<quint32>(count));
+    for (int i = 0; i < count; ++i) appendFloat(buffer, values[i]);
+    if (buffer.size() >= FLUSH_SIZE) flush();
+}
+
+/**
+ * @brief Bytes in the trace so far, including any still buffered.
+ */
+qint64 TraceWriter::size() const {
+    QMutexLocker locker(&mutex);
+    return written + buffer.size();
+}
+
+void TraceWriter::begin(TraceRecord type) {
+    const qint64 now = clock.nsecsElapsed() / 1000;
+    buffer.append(static_cast<char>(type));
+    appendVarint(buffer, static_cast<quint64>(now - lastTime));
+    lastTime = now;
+}
+
+void TraceWriter::flush() {
+    if (buffer.isEmpty()) return;
+    if (file.write(buffer) != buffer.size())
+        qCritical() << "Failed to write trace:" << file.errorString();
+    written += buffer.size();
+    buffer.clear();
+}
+
+TraceReader::TraceReader() : position(0), time(0), corrupt(false) {}
+
+/**
+ * @brief Loads a trace and checks its header.
+ * @param path the trace file
+ * @return false if the file cannot be read or is not a trace
+ */
+bool TraceReader::open(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to open trace" << path << ":"
+                    << file.errorString();
+        return false;
+    }
+
+    data = file.readAll();
+    position = HEADER_SIZE;
+    time = 0;
+    corrupt = false;
+    if (data.size() < HEADER_SIZE || !data.startsWith(TraceWriter::MAGIC) ||
+        static_cast<quint8>(data[HEADER_SIZE - 1]) != TraceWriter::VERSION) {
+        qCritical() << "Not a device trace:" << path;
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the next event.
+ * @param event output parameter
+ * @return false at the end of the trace, or at a record that is cut short
+ * or of an unknown type (isCorrupt() tells the latter apart)
+ */
+bool TraceReader::next(TraceEvent& event) {
+    if (position >= data.size()) return false;
+    const int start = position;
+    if (!readRecord(event)) {
+        if (!corrupt) qDebug() << "Trace ends in a partial record";
+        position = data.size();
+        return false;
+    }
+    if (corrupt) {
+        qCritical() << "Unknown trace record at byte" << start;
+        position = data.size();
+        return false;
+    }
+    time = event.time;
+    return true;
+}
+
+/**
+ * @brief Parses the record at the current position.
+ * @return false if it is cut short
+ */
+bool TraceReader::readRecord(TraceEvent& event) {
+    const quint8 type = static_cast<quint8>(data[position++]);
+    quint64 delta;
+    if (!readVarint(delta)) return false;
+
+    event = TraceEvent();
+    event.type = static_cast<TraceRecord>(type);
+    event.time = time + static_cast<qint64>(delta);
+
+    quint64 value = 0;
+    quint64 extra = 0;
+    quint64 count = 0;
+    switch (event.type) {
+        case TraceRecord::Power:
+        case TraceRecord::Connection:
+        case TraceRecord::Charging:
+        case TraceRecord::Battery:
+            if (position >= data.size()) return false;
+            event.value = static_cast<quint8>(data[position++]);
+            return true;
+        case TraceRecord::Data:
+            if (!readVarint(value)) return false;
+            event.value = static_cast<int>(value);
+            return true;
+        case TraceRecord::StreamStart:
+            if (!readVarint(value) || !readVarint(extra)) return false;
+            event.value = static_cast<int>(value);
+            event.sampleRate = static_cast<int>(extra);
+            return true;
+        case TraceRecord::Samples:
+            if (!readVarint(value) || !readVarint(extra) ||
+                !readVarint(count) ||
+                count > quint64(data.size() - position) / 4)
+                return false;
+            event.value = static_cast<int>(value);
+            event.timestamp = static_cast<qint64>(extra);
+            event.samples.resize(static_cast<int>(count));
+            for (int i = 0; i < event.samples.size(); ++i, position += 4)
+                event.samples[i] = readFloat(data.constData() + position);
+            return true;
+        case TraceRecord::StreamStop:
+            return true;
+    }
+    corrupt = true;
+    return true;
+}
+
+/**
+ * @brief Reads a varint at the current position; false if it is cut short.
+ */
+bool TraceReader::readVarint(quint64& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+        const quint8 byte = static_cast<quint8>(data[position++]);
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
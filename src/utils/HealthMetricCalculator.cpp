@@ -5,6 +5,61 @@
 
 #include "HealthMetricCalculator.h"
 
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "TrendEngine.h"
+
+namespace {
+
+// splitmix64 finalizer: a cheap, well-mixed 64-bit hash
+quint64 mix(quint64 x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Runs fn(begin, end) over [0, rows) in chunks of BATCH_CHUNK rows,
+ * spread across the global thread pool. Returns once every chunk is done.
+ */
+template <typename Fn>
+void forEachChunk(int rows, Fn fn) {
+    const int chunk = HealthMetricCalculator::BATCH_CHUNK;
+    if (rows <= chunk) {
+        fn(0, rows);
+        return;
+    }
+
+    QVector<int> starts;
+    starts.reserve(rows / chunk + 1);
+    for (int begin = 0; begin < rows; begin += chunk) starts.append(begin);
+    QtConcurrent::blockingMap(starts, [&fn, rows, chunk](const int& begin) {
+        fn(begin, std::min(begin + chunk, rows));
+    });
+}
+
+}  // namespace
+
+void ScoreTable::resize(int rows, int columns) {
+    this->columns = columns;
+    values.resize(rows * columns);
+    outliers.resize(rows * columns);
+}
+
+int ScoreTable::rows() const { return columns ? values.size() / columns : 0; }
+
+float ScoreTable::value(int row, int column) const {
+    return values[row * columns + column];
+}
+
+int ScoreTable::outlier(int row, int column) const {
+    return outliers[row * columns + column];
+}
+
 int Range::withinRange(float val) const {
     if (val > max) return 1;
     if (val < min) return -1;
@@ -34,11 +89,11 @@ HealthMetricCalculator::~HealthMetricCalculator() {}
  * @returns true if the calculations were successfull, false otherwise
  */
 bool HealthMetricCalculator::calculateOrganHealth(
-    ScanModel* scan, QVector<HealthMetricModel*>& hms) {
-    const QVector<int>& measurements = scan->getMeasurements();
+    ScanModel* scan, QVector<HealthMetricModel>& hms) {
+    const Measurements& measurements = scan->getMeasurements();
     hms.clear();
 
-    if (measurements.isEmpty() || measurements.size() <= 1) {
+    if (measurements.size() <= 1) {
         qCritical() << "Error: Not enough measurements. Cannot calculate mean "
                        "or standard deviation.";
         return false;
@@ -51,30 +106,18 @@ bool HealthMetricCalculator::calculateOrganHealth(
     }
     float mean = running / measurements.size();
 
-    const QVector<QString>& organNames = ScanModel::getOrganNames();
-
     int j = 0;
-    for (int i = 0; i < measurements.size(); ++i) {
+    for (int i = 0; i < MeridianPoint::Count; ++i) {
         float left = measurements[i];
         float right = measurements[++i];
         float avg = (left + right) / 2;
         float upperBound = mean + (mean * .20);
         float lowerBound = mean - (mean * .20);
 
-        HealthMetricModel* hm = nullptr;
-
-        if (avg > upperBound) {  // pos outlier
-            hm = new HealthMetricModel(organNames[j], avg, "Organ above normal",
-                                       1);
-        } else if (avg < lowerBound) {  // neg outlier
-            hm = new HealthMetricModel(organNames[j], avg, "Organ below normal",
-                                       -1);
-        } else {  // normal
-            hm =
-                new HealthMetricModel(organNames[j], avg, "Organ is normal", 0);
-        }
-
-        hms.append(hm);
+        const int level = avg > upperBound ? 1 : (avg < lowerBound ? -1 : 0);
+        hms.append(HealthMetricModel(
+            static_cast<HealthMetric::Id>(HealthMetric::FirstOrgan + j), avg,
+            level));
         ++j;
     }
 
@@ -89,27 +132,22 @@ bool HealthMetricCalculator::calculateOrganHealth(
  * @returns true if the calculations were successfull, false otherwise
  */
 bool HealthMetricCalculator::calculateIndicatorHealth(
-    ScanModel* scan, QVector<HealthMetricModel*>& hms) {
-    const QVector<int>& measurements = scan->getMeasurements();
+    ScanModel* scan, QVector<HealthMetricModel>& hms) {
+    const Measurements& measurements = scan->getMeasurements();
 
-    if (measurements.isEmpty() || measurements.size() <= 1) {
+    if (measurements.size() <= 1) {
         qCritical() << "Error: Not enough measurements. Cannot calculate mean "
                        "or standard deviation.";
         return false;
     }
 
-    // Calcualate indicator metrics
-    float energy = calculateEnergyHealth(scan);
-    float psycho = calculatePsychoHealth(scan);
-    float skeletal = calculateSkeletalHealth(scan);
-    float metabolism = calculateMetabolismHealth(scan);
-    float immune = calculateImmuneHealth(scan);
-
-    if (energy == -1 || metabolism == -1 || immune == -1 || skeletal == -1 ||
-        psycho == -1) {  // one of the calculations invalid
-        qCritical() << "Error: could not calculate indicators";
-        return false;
-    }
+    // Calcualate indicator metrics, all from one pass over the readings
+    const Indicators indicators = calculateIndicators(scan);
+    float energy = indicators.energy;
+    float psycho = indicators.psycho;
+    float skeletal = indicators.skeletal;
+    float metabolism = indicators.metabolism;
+    float immune = indicators.immune;
 
     // Determine outliers and update hms
     int energyOutlier = energyLevelRange.withinRange(energy);
@@ -119,36 +157,16 @@ bool HealthMetricCalculator::calculateIndicatorHealth(
     int immuneOutlier = immuneSysRange.withinRange(immune);
 
     hms.clear();
-    hms.append({new HealthMetricModel(
-                    "Energy Level", energy,
-                    energyOutlier > 0
-                        ? "Above Normal"
-                        : (energyOutlier < 0 ? "Below Normal" : "Normal"),
-                    energyOutlier),
-                new HealthMetricModel(
-                    "Immune system", immune,
-                    immuneOutlier > 0
-                        ? "Above Normal"
-                        : (immuneOutlier < 0 ? "Below Normal" : "Normal"),
-                    immuneOutlier),
-                new HealthMetricModel(
-                    "Metabolism", metabolism,
-                    metabolismOutlier > 0
-                        ? "Above Normal"
-                        : (metabolismOutlier < 0 ? "Below Normal" : "Normal"),
-                    metabolismOutlier),
-                new HealthMetricModel(
-                    "Psycho-emotional state", psycho,
-                    psychoOutlier > 0
-                        ? "Above Normal"
-                        : (psychoOutlier < 0 ? "Below Normal" : "Normal"),
-                    psychoOutlier),
-                new HealthMetricModel(
-                    "Musculoskeletal system", skeletal,
-                    skeletalOutlier > 0
-                        ? "Above Normal"
-                        : (skeletalOutlier < 0 ? "Below Normal" : "Normal"),
-                    skeletalOutlier)});
+    hms.append({HealthMetricModel(HealthMetric::EnergyLevel, energy,
+                                  energyOutlier),
+                HealthMetricModel(HealthMetric::ImmuneSystem, immune,
+                                  immuneOutlier),
+                HealthMetricModel(HealthMetric::Metabolism, metabolism,
+                                  metabolismOutlier),
+                HealthMetricModel(HealthMetric::PsychoState, psycho,
+                                  psychoOutlier),
+                HealthMetricModel(HealthMetric::Musculoskeletal, skeletal,
+                                  skeletalOutlier)});
 
     return true;
 }
@@ -158,215 +176,446 @@ bool HealthMetricCalculator::calculateIndicatorHealth(
  * @param scan input parameter of the scans to calculate trends for. Expects
  * scans to be in order of oldest to newest.
  * @param hms output parameter used to store the calculated indicator health
+ * metrics. See the ScanBatch overload.
+ * @returns true if the calculations were successfull, false otherwise.
+ */
+bool HealthMetricCalculator::calculateTrendHealth(
+    const QVector<ScanModel*>& scans, QVector<HealthMetricModel>& hms) {
+    ScanBatch batch;
+    batch.reserve(scans.size());
+    for (const ScanModel* scan : scans) batch.append(*scan);
+
+    return calculateTrendHealth(batch, hms);
+}
+
+/**
+ * @brief Calculates the trends from a batch of scans.
+ * @param batch input parameter of the scans to calculate trends for. Expects
+ * scans to be in order of oldest to newest.
+ * @param hms output parameter used to store the calculated indicator health
  * metrics. Each health metric returns the trend name, the latest indicator
  * value from the most recent scan, the trend type, and an integer representing
  * trending up (+1), trending down(-1), or trending sideways(0).
  * @returns true if the calculations were successfull, false otherwise.
  */
 bool HealthMetricCalculator::calculateTrendHealth(
-    const QVector<ScanModel*>& scans, QVector<HealthMetricModel*>& hms) {
-    if (scans.size() <= 1) {
+    const ScanBatch& batch, QVector<HealthMetricModel>& hms) {
+    if (batch.size() <= 1) {
         qCritical() << "Error: Not enough scans. Cannot calculate scan trends.";
         return false;
     }
 
     // get all the energy, metabolism, immune, skeletal, and psycho state
-    // indicators
-    QVector<float> energys;
-    QVector<float> metabolisms;
-    QVector<float> immunes;
-    QVector<float> skeletals;
-    QVector<float> psychos;
-
-    // get all indicators for each scan
-    for (int i = 0; i < scans.size(); ++i) {
-        ScanModel* scan = scans[i];
-
-        energys.append(calculateEnergyHealth(scan));
-        metabolisms.append(calculateMetabolismHealth(scan));
-        immunes.append(calculateImmuneHealth(scan));
-        skeletals.append(calculateSkeletalHealth(scan));
-        psychos.append(calculatePsychoHealth(scan));
-
-        if (energys[i] == -1 || metabolisms[i] == -1 || immunes[i] == -1 ||
-            skeletals[i] == -1 ||
-            psychos[i] == -1) {  // one of the calculations invalid
-            qCritical() << QString(
-                               "Error: Scan: %1 (id = %2) does not have enough "
-                               "information to calculate trends")
-                               .arg(scan->getName())
-                               .arg(scan->getId());
-            return false;
-        }
-    }
+    // indicators for each scan
+    IndicatorSeries series;
+    if (!calculateIndicatorSeries(batch, series)) return false;
 
-    float newestEnergy = energys[energys.size() - 1];
-    float newestMetabolism = metabolisms[metabolisms.size() - 1];
-    float newestImmune = immunes[immunes.size() - 1];
-    float newestSkeletal = skeletals[skeletals.size() - 1];
-    float newestPsycho = psychos[psychos.size() - 1];
-
-    // find the slope of the line of best fit for each one
-    float energySlope = (newestEnergy - energys[0]) / (energys.size() - 1);
-    float metabolismSlope =
-        (newestMetabolism - metabolisms[0]) / (metabolisms.size() - 1);
-    float immuneSlope = (newestImmune - immunes[0]) / (immunes.size() - 1);
-    float skeletalSlope =
-        (newestSkeletal - skeletals[0]) / (skeletals.size() - 1);
-    float psychoSlope = (newestPsycho - psychos[0]) / (psychos.size() - 1);
-
-    // update hms with the trend analysis for each of the indicators
-    hms.clear();
-    hms.append(
-        {new HealthMetricModel(
-             "Energy level trend", newestEnergy,
-             energySlope > 0
-                 ? "Trending Up"
-                 : (energySlope < 0 ? "Trending Down" : "Trending Sideways"),
-             energySlope > 0 ? 1 : (energySlope < 0 ? -1 : 0)),
-         new HealthMetricModel(
-             "Immune system trend", newestImmune,
-             immuneSlope > 0
-                 ? "Trending Up"
-                 : (immuneSlope < 0 ? "Trending Down" : "Trending Sideways"),
-             immuneSlope > 0 ? 1 : (immuneSlope < 0 ? -1 : 0)),
-         new HealthMetricModel(
-             "Metabolism trend", newestMetabolism,
-             metabolismSlope > 0 ? "Trending Up"
-                                 : (metabolismSlope < 0 ? "Trending Down"
-                                                        : "Trending Sideways"),
-             metabolismSlope > 0 ? 1 : (metabolismSlope < 0 ? -1 : 0)),
-         new HealthMetricModel(
-             "Psycho-emotional state trend", newestPsycho,
-             psychoSlope > 0
-                 ? "Trending Up"
-                 : (psychoSlope < 0 ? "Trending Down" : "Trending Sideways"),
-             psychoSlope > 0 ? 1 : (psychoSlope < 0 ? -1 : 0)),
-         new HealthMetricModel(
-             "Musculoskeletal system trend", newestSkeletal,
-             skeletalSlope > 0
-                 ? "Trending Up"
-                 : (skeletalSlope < 0 ? "Trending Down" : "Trending Sideways"),
-             skeletalSlope > 0 ? 1 : (skeletalSlope < 0 ? -1 : 0))});
+    // least-squares slope of each indicator over the whole history
+    const QVector<TrendPrefix> prefixes = TrendEngine::prefixes(series);
+    TrendEngine::toHealthMetrics(
+        TrendEngine::fit(prefixes.last(), TrendPrefix()), hms);
 
     return true;
 }
 
-float HealthMetricCalculator::calculateEnergyHealth(ScanModel* scan) {
-    const QVector<int>& measurements = scan->getMeasurements();
-
-    if (measurements.size() <= 0) {
-        qCritical()
-            << "Error: not enough measurements to calculate energy indicator";
-        return -1;
+/**
+ * @brief Calculates every indicator for every scan in a batch. Each sum is
+ * built by walking whole reading columns, so the work streams through
+ * contiguous memory however many scans there are.
+ * @param batch input parameter of the scans to calculate indicators for
+ * @param series output parameter holding one value per scan for each
+ * indicator, in batch order
+ * @returns true if the calculations were successfull, false otherwise
+ */
+bool HealthMetricCalculator::calculateIndicatorSeries(const ScanBatch& batch,
+                                                      IndicatorSeries& series) {
+    const int n = batch.size();
+    if (n == 0) {
+        qCritical() << "Error: no scans to calculate indicators for";
+        return false;
     }
 
-    float running = 0;
-    for (const auto& x : measurements) {
-        running += x;
+    const QVector<quint64> keys = scanKeys(batch);
+    QVector<Indicators> rows(n);
+    Indicators* out = rows.data();
+    forEachChunk(n, [&batch, &keys, out](int begin, int end) {
+        indicatorsForRows(batch, keys.constData(), begin, end, out + begin);
+    });
+
+    series.energy.resize(n);
+    series.immune.resize(n);
+    series.metabolism.resize(n);
+    series.psycho.resize(n);
+    series.skeletal.resize(n);
+
+    for (int i = 0; i < n; ++i) {
+        series.energy[i] = rows[i].energy;
+        series.immune[i] = rows[i].immune;
+        series.metabolism[i] = rows[i].metabolism;
+        series.psycho[i] = rows[i].psycho;
+        series.skeletal[i] = rows[i].skeletal;
     }
-    // Energy: mean
-    return running / measurements.size();
-}
 
-float HealthMetricCalculator::calculateImmuneHealth(ScanModel* scan) {
-    const QVector<int>& upperMeasurements = scan->getUpperMeasurements();
-    const QVector<int>& lowerMeasurements = scan->getLowerMeasurements();
+    return true;
+}
 
-    if (upperMeasurements.size() <= 0 || lowerMeasurements.size() <= 0) {
-        qCritical()
-            << "Error: not enough measurements to calculate immune indicator";
-        return -1;
+/**
+ * @brief Scores the indicators of every scan in a batch, in parallel chunks.
+ * Gives the same values and outliers as calculateIndicatorHealth on each
+ * scan, without allocating a HealthMetricModel per result.
+ * @param batch input parameter of the scans to score
+ * @param scores output parameter, resized to one row per scan with
+ * INDICATOR_COUNT columns in IndicatorColumn order
+ * @returns true if the calculations were successfull, false otherwise
+ */
+bool HealthMetricCalculator::calculateIndicatorHealthBatch(
+    const ScanBatch& batch, ScoreTable& scores) {
+    const int n = batch.size();
+    if (n == 0) {
+        qCritical() << "Error: no scans to calculate indicators for";
+        return false;
     }
 
-    float upperSum = 0;
-    float lowerSum = 0;
-    for (auto& x : upperMeasurements) {
-        upperSum += x;
-    }
-    for (auto& x : lowerMeasurements) {
-        lowerSum += x;
-    }
+    const QVector<quint64> keys = scanKeys(batch);
+    scores.resize(n, INDICATOR_COUNT);
+    float* values = scores.values.data();
+    qint8* outliers = scores.outliers.data();
+
+    forEachChunk(n, [this, &batch, &keys, values, outliers](int begin,
+                                                             int end) {
+        Indicators indicators[BATCH_CHUNK];
+        indicatorsForRows(batch, keys.constData(), begin, end, indicators);
+
+        for (int i = begin; i < end; ++i) {
+            const Indicators& row = indicators[i - begin];
+            float* value = values + i * INDICATOR_COUNT;
+            qint8* outlier = outliers + i * INDICATOR_COUNT;
+
+            value[Energy] = row.energy;
+            value[Immune] = row.immune;
+            value[Metabolism] = row.metabolism;
+            value[Psycho] = row.psycho;
+            value[Skeletal] = row.skeletal;
+            outlier[Energy] = energyLevelRange.withinRange(row.energy);
+            outlier[Immune] = immuneSysRange.withinRange(row.immune);
+            outlier[Metabolism] = metabolismRange.withinRange(row.metabolism);
+            outlier[Psycho] = psychoStateRange.withinRange(row.psycho);
+            outlier[Skeletal] = skeletalSysRange.withinRange(row.skeletal);
+        }
+    });
 
-    // Immune system: |upper-lower| / 2
-    return std::abs(upperSum - lowerSum) / 2;
+    return true;
 }
 
-float HealthMetricCalculator::calculateMetabolismHealth(ScanModel* scan) {
-    const QVector<int>& leftMeasurements = scan->getLeftMeasurements();
-    const QVector<int>& rightMeasurements = scan->getRightMeasurements();
-
-    if (rightMeasurements.size() <= 0 || leftMeasurements.size() <= 0) {
-        qCritical() << "Error: not enough measurements to calculate metabolism "
-                       "indicator";
-        return -1;
+/**
+ * @brief Scores the organs of every scan in a batch, in parallel chunks.
+ * Gives the same values and outliers as calculateOrganHealth on each scan.
+ * @param batch input parameter of the scans to score
+ * @param scores output parameter, resized to one row per scan with
+ * ORGAN_COUNT columns in ScanModel::getOrganNames() order
+ * @returns true if the calculations were successfull, false otherwise
+ */
+bool HealthMetricCalculator::calculateOrganHealthBatch(const ScanBatch& batch,
+                                                       ScoreTable& scores) {
+    const int n = batch.size();
+    if (n == 0) {
+        qCritical() << "Error: no scans to calculate organ health for";
+        return false;
     }
 
-    float leftWeightedSum = 0.0f;
-    for (const auto& measurement : leftMeasurements) {
-        float weight = random(0.0f, 0.5f);
-        leftWeightedSum += measurement + (measurement * weight);
-    }
+    scores.resize(n, ORGAN_COUNT);
+    float* values = scores.values.data();
+    qint8* outliers = scores.outliers.data();
+
+    forEachChunk(n, [&batch, values, outliers](int begin, int end) {
+        const int rows = end - begin;
+        const int16_t* columns[MeridianPoint::Count];
+        for (int point = 0; point < MeridianPoint::Count; ++point)
+            columns[point] = batch.column(point) + begin;
+
+        int32_t upper[BATCH_CHUNK];
+        int32_t lower[BATCH_CHUNK];
+        int32_t left[BATCH_CHUNK];
+        int32_t right[BATCH_CHUNK];
+        IndicatorKernel::sumColumns(columns, rows, upper, lower, left, right);
+
+        float upperBounds[BATCH_CHUNK];
+        float lowerBounds[BATCH_CHUNK];
+        for (int i = 0; i < rows; ++i) {
+            const float mean =
+                static_cast<float>(upper[i] + lower[i]) / MeridianPoint::Count;
+            upperBounds[i] = mean + (mean * .20);
+            lowerBounds[i] = mean - (mean * .20);
+        }
+
+        // Organ j is the left/right pair at points 2j and 2j + 1
+        for (int organ = 0; organ < ORGAN_COUNT; ++organ) {
+            const int16_t* leftColumn = columns[2 * organ];
+            const int16_t* rightColumn = columns[2 * organ + 1];
+            for (int i = 0; i < rows; ++i) {
+                const float avg =
+                    (static_cast<float>(leftColumn[i]) + rightColumn[i]) / 2;
+                const int offset = (begin + i) * ORGAN_COUNT + organ;
+                values[offset] = avg;
+                outliers[offset] = avg > upperBounds[i]
+                                       ? 1
+                                       : (avg < lowerBounds[i] ? -1 : 0);
+            }
+        }
+    });
 
-    float rightWeightedSum = 0.0f;
-    for (const auto& measurement : rightMeasurements) {
-        float weight = random(0.0f, 0.5f);
-        rightWeightedSum += measurement + (measurement * weight);
+    return true;
+}
+
+/**
+ * @brief Calculates the indicators of rows [begin, end) of a batch.
+ * @param batch the scans
+ * @param keys the batch's scan keys, from scanKeys()
+ * @param begin first row
+ * @param end one past the last row
+ * @param out output, end - begin indicators
+ */
+void HealthMetricCalculator::indicatorsForRows(const ScanBatch& batch,
+                                               const quint64* keys, int begin,
+                                               int end, Indicators* out) {
+    int32_t upper[BATCH_CHUNK];
+    int32_t lower[BATCH_CHUNK];
+    int32_t left[BATCH_CHUNK];
+    int32_t right[BATCH_CHUNK];
+    float weightedLeft[BATCH_CHUNK];
+    float weightedRight[BATCH_CHUNK];
+    const int16_t* columns[MeridianPoint::Count];
+    std::vector<float> weights(BATCH_CHUNK * MeridianPoint::Count);
+
+    for (int start = begin; start < end; start += BATCH_CHUNK) {
+        const int rows = std::min(BATCH_CHUNK, end - start);
+        const quint64* rowKeys = keys + start;
+        for (int point = 0; point < MeridianPoint::Count; ++point)
+            columns[point] = batch.column(point) + start;
+
+        // Every column read once for the plain group sums
+        IndicatorKernel::sumColumns(columns, rows, upper, lower, left, right);
+
+        // Metabolism weights are a function of (scan key, point), and the
+        // weighted sums are the ones calculateIndicators() takes, so each
+        // row scores exactly as it would on its own
+        for (int i = 0; i < rows; ++i) {
+            float* rowWeights = weights.data() + i * MeridianPoint::Count;
+            for (int point = 0; point < MeridianPoint::Count; ++point)
+                rowWeights[point] = metabolismWeight(rowKeys[i], point);
+        }
+        IndicatorKernel::sumWeightedColumns(columns, weights.data(), rows,
+                                            weightedLeft, weightedRight);
+
+        for (int i = 0; i < rows; ++i) {
+            ReadingSums sums;
+            sums.upper = upper[i];
+            sums.lower = lower[i];
+            sums.total = sums.upper + sums.lower;
+            sums.left = left[i];
+            sums.right = right[i];
+            sums.weightedLeft = weightedLeft[i];
+            sums.weightedRight = weightedRight[i];
+            out[start - begin + i] = indicatorsFromSums(sums);
+        }
     }
+}
 
-    // Metabolism: left(weighted) / right(weighted)
-    return std::abs(leftWeightedSum / rightWeightedSum);
+/**
+ * @brief Calculates all five indicators for a scan from a single fused pass
+ * over its readings.
+ * @param scan input parameter used to calculate the indicators
+ * @returns the indicator values
+ */
+Indicators HealthMetricCalculator::calculateIndicators(ScanModel* scan) {
+    float weights[MeridianPoint::Count];
+    metabolismWeights(scan->getId(), weights);
+    return indicatorsFromSums(
+        IndicatorKernel::sum(scan->getMeasurements().data(), weights));
+}
+
+float HealthMetricCalculator::calculateEnergyHealth(ScanModel* scan) {
+    return indicatorsFromSums(
+               IndicatorKernel::sum(scan->getMeasurements().data()))
+        .energy;
+}
+
+float HealthMetricCalculator::calculateImmuneHealth(ScanModel* scan) {
+    return indicatorsFromSums(
+               IndicatorKernel::sum(scan->getMeasurements().data()))
+        .immune;
+}
+
+float HealthMetricCalculator::calculateMetabolismHealth(ScanModel* scan) {
+    return calculateIndicators(scan).metabolism;
 }
 
 float HealthMetricCalculator::calculateSkeletalHealth(ScanModel* scan) {
-    const QVector<int>& rightMeasurements = scan->getRightMeasurements();
-    const QVector<int>& leftMeasurements = scan->getLeftMeasurements();
+    return indicatorsFromSums(
+               IndicatorKernel::sum(scan->getMeasurements().data()))
+        .skeletal;
+}
 
-    if (rightMeasurements.size() <= 0 || leftMeasurements.size() <= 0) {
-        qCritical()
-            << "Error: not enough measurements to calculate skeletal indicator";
-        return -1;
-    }
+float HealthMetricCalculator::calculatePsychoHealth(ScanModel* scan) {
+    return indicatorsFromSums(
+               IndicatorKernel::sum(scan->getMeasurements().data()))
+        .psycho;
+}
 
-    float leftSum = 0;
-    float rightSum = 0;
-    for (const auto& x : leftMeasurements) {
-        leftSum += x;
-    }
-    for (const auto& x : rightMeasurements) {
-        rightSum += x;
-    }
+/**
+ * @brief Derives the indicators from a scan's reading sums.
+ * @param sums the scan's group sums
+ * @returns the indicator values
+ */
+Indicators HealthMetricCalculator::indicatorsFromSums(const ReadingSums& sums) {
+    const float upper = sums.upper;
+    const float lower = sums.lower;
+    const float left = sums.left;
+    const float right = sums.right;
 
+    Indicators indicators;
+    // Energy: mean
+    indicators.energy = static_cast<float>(sums.total) / MeridianPoint::Count;
+    // Immune system: |upper-lower| / 2
+    indicators.immune = std::abs(upper - lower) / 2;
+    // Metabolism: left(weighted) / right(weighted)
+    indicators.metabolism = std::abs(sums.weightedLeft / sums.weightedRight);
+    // Psycho-emotional state: upper/lower
+    indicators.psycho = std::abs(upper / lower);
     // Musculoskeletal system: left/right
-    return std::abs(leftSum / rightSum);
+    indicators.skeletal = std::abs(left / right);
+    return indicators;
 }
 
-float HealthMetricCalculator::calculatePsychoHealth(ScanModel* scan) {
-    const QVector<int>& upperMeasurements = scan->getUpperMeasurements();
-    const QVector<int>& lowerMeasurements = scan->getLowerMeasurements();
+/**
+ * @brief Calculates the organ and indicator metrics of a scan together.
+ * @param scan input parameter used to calculate the metrics
+ * @param result output parameter
+ * @returns true if the calculations were successfull, false otherwise
+ */
+bool HealthMetricCalculator::calculateScanResult(ScanModel* scan,
+                                                 ScanResult& result) {
+    return calculateOrganHealth(scan, result.organs) &&
+           calculateIndicatorHealth(scan, result.indicators);
+}
 
-    if (upperMeasurements.size() <= 0 || lowerMeasurements.size() <= 0) {
-        qCritical() << "Error: not enough measurements to calculate "
-                       "psycho-emotional indicator";
-        return -1;
+/**
+ * @brief Sets the normal range of an indicator. Changes getVersion().
+ * @param indicator the indicator
+ * @param range values inside it are reported as normal
+ */
+void HealthMetricCalculator::setRange(IndicatorColumn indicator,
+                                      const Range& range) {
+    rangeFor(indicator) = range;
+}
+
+Range HealthMetricCalculator::getRange(IndicatorColumn indicator) const {
+    return const_cast<HealthMetricCalculator*>(this)->rangeFor(indicator);
+}
+
+Range& HealthMetricCalculator::rangeFor(IndicatorColumn indicator) {
+    switch (indicator) {
+        case Energy:
+            return energyLevelRange;
+        case Immune:
+            return immuneSysRange;
+        case Metabolism:
+            return metabolismRange;
+        case Psycho:
+            return psychoStateRange;
+        case Skeletal:
+        default:
+            return skeletalSysRange;
     }
+}
 
-    float upperSum = 0;
-    float lowerSum = 0;
-    for (auto& x : upperMeasurements) {
-        upperSum += x;
+/**
+ * @brief Identifies the configuration results depend on: the formulas
+ * (ALGORITHM_VERSION), the indicator ranges and the metabolism seed. Two
+ * calculators with the same version give the same results for a scan, so
+ * stored results can be keyed by it.
+ * @returns a hash of the configuration
+ */
+quint64 HealthMetricCalculator::getVersion() const {
+    quint64 version = mix(ALGORITHM_VERSION);
+    auto add = [&version](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        version = mix(version ^ bits);
+    };
+
+    for (int indicator = 0; indicator < INDICATOR_COUNT; ++indicator) {
+        const Range range = getRange(static_cast<IndicatorColumn>(indicator));
+        add(range.min);
+        add(range.max);
     }
-    for (auto& x : lowerMeasurements) {
-        lowerSum += x;
+    version = mix(version ^ seed);
+    return mix(version ^ (deterministic ? 1 : 0));
+}
+
+/**
+ * @brief Switches between deterministic scoring, where a scan always gets the
+ * same metabolism weights, and the original behaviour of fresh weights on
+ * every calculation. Leaving deterministic mode draws a new seed once.
+ * @param enabled true for deterministic scoring (the default)
+ */
+void HealthMetricCalculator::setDeterministic(bool enabled) {
+    if (deterministic && !enabled) {
+        std::random_device rdev;
+        seed = (static_cast<quint64>(rdev()) << 32) ^ rdev();
     }
+    deterministic = enabled;
+}
 
-    // Psycho-emotional state: upper/lower
-    return std::abs(upperSum / lowerSum);
+bool HealthMetricCalculator::isDeterministic() const { return deterministic; }
+
+void HealthMetricCalculator::setSeed(quint64 value) { seed = value; }
+
+quint64 HealthMetricCalculator::getSeed() const { return seed; }
+
+/**
+ * @brief Gets the key a scan's metabolism weights are derived from.
+ * @param scanId the scan's id, or -1 for a scan not stored yet; unsaved
+ * scans share that key, so their scores still depend only on their readings
+ * @returns the key; in non-deterministic mode a new one on every call
+ */
+quint64 HealthMetricCalculator::scanKey(int scanId) {
+    const quint64 id = static_cast<uint32_t>(scanId);
+    quint64 key = mix(seed ^ id);
+    if (!deterministic) key = mix(key ^ ++nonce);
+    return key;
 }
 
-float HealthMetricCalculator::random(float lower, float upper) {
-    std::random_device rdev;
-    std::default_random_engine re(rdev());
-    std::uniform_real_distribution<> dist(lower, upper);
-    return dist(re);
+/**
+ * @brief Gets the key of every scan in a batch, in row order. Drawn before
+ * any parallel work so non-deterministic nonces stay race free.
+ */
+QVector<quint64> HealthMetricCalculator::scanKeys(const ScanBatch& batch) {
+    const QVector<int>& ids = batch.getIds();
+    QVector<quint64> keys(ids.size());
+    for (int i = 0; i < ids.size(); ++i) keys[i] = scanKey(ids[i]);
+    return keys;
+}
+
+/**
+ * @brief Gets the metabolism weight of one reading, uniform in [0, 0.5).
+ * Counter-based, so weights can be drawn in any order.
+ * @param key the scan's key from scanKey()
+ * @param point a MeridianPoint index
+ */
+float HealthMetricCalculator::metabolismWeight(quint64 key, int point) {
+    const quint64 bits = mix(key + static_cast<quint64>(point));
+    // Top 24 bits give an exact float in [0, 1)
+    return static_cast<float>(bits >> 40) * (0.5f / 16777216.0f);
+}
+
+/**
+ * @brief Draws the metabolism weight for each reading of a scan.
+ * @param scanId the scan's id
+ * @param weights output, one weight per MeridianPoint
+ */
+void HealthMetricCalculator::metabolismWeights(int scanId, float* weights) {
+    const quint64 key = scanKey(scanId);
+    for (int point = 0; point < MeridianPoint::Count; ++point)
+        weights[point] = metabolismWeight(key, point);
 }
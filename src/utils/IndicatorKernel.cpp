@@ -0,0 +1,356 @@
+/**
+ * @file IndicatorKernel.cpp
+ * @brief Scalar, SSE2 and AVX2 implementations of the reading sums, with
+ * runtime dispatch between them.
+ */
+
+#include "IndicatorKernel.h"
+
+#include <algorithm>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define INDICATOR_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit vector instructions inside functions that ask for
+// them, which lets one binary carry every path without raising the baseline
+#if defined(INDICATOR_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+const int HALF = IndicatorKernel::READINGS / 2;
+
+/**
+ * @brief Reference implementation of the plain sums, also used for the rows
+ * left over after the vector loops.
+ */
+ReadingSums sumScalar(const int16_t* readings) {
+    ReadingSums sums;
+    for (int point = 0; point < IndicatorKernel::READINGS; ++point) {
+        const int32_t x = readings[point];
+        (point < HALF ? sums.upper : sums.lower) += x;
+        (point % 2 == 0 ? sums.left : sums.right) += x;
+    }
+    sums.total = sums.upper + sums.lower;
+    return sums;
+}
+
+void sumColumnsScalar(const int16_t* const* columns, int begin, int rows,
+                      int32_t* upper, int32_t* lower, int32_t* left,
+                      int32_t* right) {
+    for (int i = begin; i < rows; ++i) {
+        int32_t sums[4] = {0, 0, 0, 0};
+        for (int point = 0; point < IndicatorKernel::READINGS; ++point) {
+            const int32_t x = columns[point][i];
+            sums[point < HALF ? 0 : 1] += x;
+            sums[point % 2 == 0 ? 2 : 3] += x;
+        }
+        upper[i] = sums[0];
+        lower[i] = sums[1];
+        left[i] = sums[2];
+        right[i] = sums[3];
+    }
+}
+
+#ifdef INDICATOR_KERNEL_X86
+
+TARGET_SSE2 int32_t horizontalSum(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+/**
+ * @brief Sign-extends the low or high four int16 lanes to int32.
+ */
+TARGET_SSE2 __m128i widenLow(__m128i v) {
+    return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+
+TARGET_SSE2 __m128i widenHigh(__m128i v) {
+    return _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+
+/**
+ * @brief One scan's 24 readings are three 128-bit loads. Multiply-adding
+ * against all ones yields the sum of each left/right pair, and against a
+ * 1,0 mask the left reading alone, so every group falls out of six madds.
+ */
+TARGET_SSE2 ReadingSums sumSse2(const int16_t* readings) {
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i evens = _mm_set_epi16(0, 1, 0, 1, 0, 1, 0, 1);
+
+    const __m128i v0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(readings));
+    const __m128i v1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(readings + 8));
+    const __m128i v2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(readings + 16));
+
+    // Lane k of each pair sum covers points 2k and 2k + 1 of its load
+    const __m128i pairs0 = _mm_madd_epi16(v0, ones);
+    const __m128i pairs1 = _mm_madd_epi16(v1, ones);
+    const __m128i pairs2 = _mm_madd_epi16(v2, ones);
+    const __m128i lefts = _mm_add_epi32(
+        _mm_add_epi32(_mm_madd_epi16(v0, evens), _mm_madd_epi16(v1, evens)),
+        _mm_madd_epi16(v2, evens));
+
+    ReadingSums sums;
+    sums.total =
+        horizontalSum(_mm_add_epi32(_mm_add_epi32(pairs0, pairs1), pairs2));
+    sums.left = horizontalSum(lefts);
+    sums.right = sums.total - sums.left;
+
+    // Points 0-11 are the first load plus the low half of the second
+    const __m128i upperPairs1 = _mm_add_epi32(
+        pairs1, _mm_shuffle_epi32(pairs1, _MM_SHUFFLE(1, 1, 1, 1)));
+    sums.upper = horizontalSum(pairs0) + _mm_cvtsi128_si32(upperPairs1);
+    sums.lower = sums.total - sums.upper;
+    return sums;
+}
+
+/**
+ * @brief Eight scans per step: each column contributes one 128-bit load,
+ * widened to two int32 vectors and added to its upper/lower and left/right
+ * accumulators.
+ */
+TARGET_SSE2 void sumColumnsSse2(const int16_t* const* columns, int begin,
+                                int rows, int32_t* upper, int32_t* lower,
+                                int32_t* left, int32_t* right) {
+    int i = begin;
+    for (; i + 8 <= rows; i += 8) {
+        __m128i acc[4][2];
+        for (auto& group : acc) group[0] = group[1] = _mm_setzero_si128();
+
+        for (int point = 0; point < IndicatorKernel::READINGS; ++point) {
+            const __m128i v = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(columns[point] + i));
+            const __m128i low = widenLow(v);
+            const __m128i high = widenHigh(v);
+
+            __m128i* vertical = acc[point < HALF ? 0 : 1];
+            __m128i* side = acc[point % 2 == 0 ? 2 : 3];
+            vertical[0] = _mm_add_epi32(vertical[0], low);
+            vertical[1] = _mm_add_epi32(vertical[1], high);
+            side[0] = _mm_add_epi32(side[0], low);
+            side[1] = _mm_add_epi32(side[1], high);
+        }
+
+        int32_t* outputs[4] = {upper, lower, left, right};
+        for (int group = 0; group < 4; ++group) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outputs[group] + i),
+                             acc[group][0]);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(outputs[group] + i + 4),
+                acc[group][1]);
+        }
+    }
+    sumColumnsScalar(columns, i, rows, upper, lower, left, right);
+}
+
+/**
+ * @brief As the SSE2 version, sixteen scans per step.
+ */
+TARGET_AVX2 void sumColumnsAvx2(const int16_t* const* columns, int rows,
+                                int32_t* upper, int32_t* lower, int32_t* left,
+                                int32_t* right) {
+    int i = 0;
+    for (; i + 16 <= rows; i += 16) {
+        __m256i acc[4][2];
+        for (auto& group : acc) group[0] = group[1] = _mm256_setzero_si256();
+
+        for (int point = 0; point < IndicatorKernel::READINGS; ++point) {
+            const __m256i v = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(columns[point] + i));
+            const __m256i low =
+                _mm256_cvtepi16_epi32(_mm256_castsi256_si128(v));
+            const __m256i high =
+                _mm256_cvtepi16_epi32(_mm256_extracti128_si256(v, 1));
+
+            __m256i* vertical = acc[point < HALF ? 0 : 1];
+            __m256i* side = acc[point % 2 == 0 ? 2 : 3];
+            vertical[0] = _mm256_add_epi32(vertical[0], low);
+            vertical[1] = _mm256_add_epi32(vertical[1], high);
+            side[0] = _mm256_add_epi32(side[0], low);
+            side[1] = _mm256_add_epi32(side[1], high);
+        }
+
+        int32_t* outputs[4] = {upper, lower, left, right};
+        for (int group = 0; group < 4; ++group) {
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(outputs[group] + i), acc[group][0]);
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(outputs[group] + i + 8),
+                acc[group][1]);
+        }
+    }
+    sumColumnsSse2(columns, i, rows, upper, lower, left, right);
+}
+
+#endif  // INDICATOR_KERNEL_X86
+
+IndicatorKernel::Isa detectIsa() {
+#ifdef INDICATOR_KERNEL_X86
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return IndicatorKernel::Isa::AVX2;
+    if (__builtin_cpu_supports("sse2")) return IndicatorKernel::Isa::SSE2;
+#elif defined(_MSC_VER)
+    // AVX2 needs both the CPU flag and the OS saving the YMM registers
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuidex(info, 7, 0);
+        const bool avx2 = info[1] & (1 << 5);
+        __cpuid(info, 1);
+        const bool osxsave = info[2] & (1 << 27);
+        if (avx2 && osxsave && (_xgetbv(0) & 6) == 6)
+            return IndicatorKernel::Isa::AVX2;
+    }
+    return IndicatorKernel::Isa::SSE2;
+#endif
+#endif
+    return IndicatorKernel::Isa::Scalar;
+}
+
+std::atomic<int>& activeIsa() {
+    static std::atomic<int> active(static_cast<int>(detectIsa()));
+    return active;
+}
+
+}  // namespace
+
+/**
+ * @brief Sums one scan's readings into every group at once.
+ * @param readings the scan's 24 readings in MeridianPoint order
+ * @param weights optional per-reading metabolism weights, in the same order;
+ * without them the weighted sums equal the plain ones
+ * @return the sums
+ */
+ReadingSums IndicatorKernel::sum(const int16_t* readings,
+                                 const float* weights) {
+#ifdef INDICATOR_KERNEL_X86
+    // A single scan fits three 128-bit loads, so AVX2 has nothing to add
+    ReadingSums sums =
+        isa() != Isa::Scalar ? sumSse2(readings) : sumScalar(readings);
+#else
+    ReadingSums sums = sumScalar(readings);
+#endif
+
+    if (!weights) {
+        sums.weightedLeft = static_cast<float>(sums.left);
+        sums.weightedRight = static_cast<float>(sums.right);
+        return sums;
+    }
+
+    // A single scan is a batch of one row, so it gets the batch's exact sums
+    const int16_t* columns[READINGS];
+    for (int point = 0; point < READINGS; ++point)
+        columns[point] = readings + point;
+    sumWeightedColumns(columns, weights, 1, &sums.weightedLeft,
+                       &sums.weightedRight);
+    return sums;
+}
+
+/**
+ * @brief Sums the reading groups of many scans stored column-wise, as in a
+ * ScanBatch. Each column is read once.
+ * @param columns 24 column pointers in MeridianPoint order
+ * @param rows the number of scans
+ * @param upper output, one sum per scan
+ * @param lower output, one sum per scan
+ * @param left output, one sum per scan
+ * @param right output, one sum per scan
+ */
+void IndicatorKernel::sumColumns(const int16_t* const* columns, int rows,
+                                 int32_t* upper, int32_t* lower, int32_t* left,
+                                 int32_t* right) {
+#ifdef INDICATOR_KERNEL_X86
+    switch (isa()) {
+        case Isa::AVX2:
+            sumColumnsAvx2(columns, rows, upper, lower, left, right);
+            return;
+        case Isa::SSE2:
+            sumColumnsSse2(columns, 0, rows, upper, lower, left, right);
+            return;
+        case Isa::Scalar:
+            break;
+    }
+#endif
+    sumColumnsScalar(columns, 0, rows, upper, lower, left, right);
+}
+
+/**
+ * @brief Sums reading * (1 + weight) per side for many scans stored
+ * column-wise. Each row adds its points in MeridianPoint order, so a scan
+ * gets the same sums whichever batch it is in, bit for bit; sum() goes
+ * through here too. Kept scalar because the order fixes the rounding.
+ * @param columns 24 column pointers in MeridianPoint order
+ * @param weights READINGS weights per scan, row after row
+ * @param rows the number of scans
+ * @param weightedLeft output, one sum per scan
+ * @param weightedRight output, one sum per scan
+ */
+void IndicatorKernel::sumWeightedColumns(const int16_t* const* columns,
+                                         const float* weights, int rows,
+                                         float* weightedLeft,
+                                         float* weightedRight) {
+    std::fill(weightedLeft, weightedLeft + rows, 0.0f);
+    std::fill(weightedRight, weightedRight + rows, 0.0f);
+    for (int point = 0; point < READINGS; ++point) {
+        const int16_t* column = columns[point];
+        float* sums = point % 2 == 0 ? weightedLeft : weightedRight;
+        for (int i = 0; i < rows; ++i) {
+            const float x = column[i];
+            sums[i] += x * (1.0f + weights[i * READINGS + point]);
+        }
+    }
+}
+
+IndicatorKernel::Isa IndicatorKernel::isa() {
+    return static_cast<Isa>(activeIsa().load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Forces an implementation, e.g. to benchmark or cross-check them.
+ * Requests beyond what the CPU supports fall back to the best it does.
+ * @param requested the instruction set to use
+ * @return the instruction set now in use
+ */
+IndicatorKernel::Isa IndicatorKernel::setIsa(Isa requested) {
+    const Isa best = bestSupportedIsa();
+    const Isa chosen = static_cast<int>(requested) > static_cast<int>(best)
+                           ? best
+                           : requested;
+    activeIsa().store(static_cast<int>(chosen));
+    return chosen;
+}
+
+IndicatorKernel::Isa IndicatorKernel::bestSupportedIsa() {
+    static const Isa best = detectIsa();
+    return best;
+}
+
+const char* IndicatorKernel::isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX2:
+            return "AVX2";
+        case Isa::SSE2:
+            return "SSE2";
+        case Isa::Scalar:
+            break;
+    }
+    return "scalar";
+}
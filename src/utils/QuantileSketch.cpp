@@ -0,0 +1,267 @@
+/**
+ * @file QuantileSketch.cpp
+ * @brief A mergeable t-digest for estimating quantiles of a stream.
+ */
+
+#include "QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// Header of the serialized form: compression, smallest and largest value
+const int HEADER_DOUBLES = 3;
+const int CENTROID_BYTES = 2 * sizeof(double);
+
+void appendDouble(QByteArray& bytes, double value) {
+    bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+double readDouble(const char*& data) {
+    double value;
+    std::memcpy(&value, data, sizeof(value));
+    data += sizeof(value);
+    return value;
+}
+
+}  // namespace
+
+QuantileSketch::QuantileSketch(double compression)
+    : compression(compression),
+      total(0),
+      smallest(std::numeric_limits<double>::infinity()),
+      largest(-std::numeric_limits<double>::infinity()) {}
+
+/**
+ * @brief Adds a value. Non-finite values and non-positive weights are
+ * ignored.
+ * @param value the value
+ * @param weight how many times it occurred
+ */
+void QuantileSketch::add(double value, double weight) {
+    if (!std::isfinite(value) || !(weight > 0)) return;
+
+    buffer.append({value, weight});
+    total += weight;
+    smallest = std::min(smallest, value);
+    largest = std::max(largest, value);
+    if (buffer.size() >= BUFFER_FACTOR * compression) flush();
+}
+
+/**
+ * @brief Adds every value summarized by another sketch.
+ */
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.isEmpty()) return;
+
+    buffer += other.centroids;
+    buffer += other.buffer;
+    total += other.total;
+    smallest = std::min(smallest, other.smallest);
+    largest = std::max(largest, other.largest);
+    if (buffer.size() >= BUFFER_FACTOR * compression) flush();
+}
+
+void QuantileSketch::clear() {
+    centroids.clear();
+    buffer.clear();
+    total = 0;
+    smallest = std::numeric_limits<double>::infinity();
+    largest = -std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Estimates the value below which a fraction q of the values fall.
+ * @param q the quantile, from 0 to 1
+ * @return the value, or 0 if the sketch is empty
+ */
+double QuantileSketch::quantile(double q) const {
+    if (isEmpty()) return 0;
+
+    // Walk the piecewise-linear cumulative curve through each centroid's
+    // midpoint, anchored at the smallest and largest values seen
+    const double target = std::min(std::max(q, 0.0), 1.0) * total;
+    double cumulative = 0;
+    double previousX = smallest;
+    double previousY = 0;
+    for (const Centroid& centroid : merged()) {
+        const double middle = cumulative + centroid.weight / 2;
+        if (target <= middle) {
+            if (middle == previousY) return centroid.mean;
+            return previousX + (centroid.mean - previousX) *
+                                   (target - previousY) / (middle - previousY);
+        }
+        cumulative += centroid.weight;
+        previousX = centroid.mean;
+        previousY = middle;
+    }
+    if (total == previousY) return largest;
+    return previousX +
+           (largest - previousX) * (target - previousY) / (total - previousY);
+}
+
+/**
+ * @brief Estimates the fraction of values below a value, counting values
+ * equal to it as half below (the mid-rank).
+ * @param value the value
+ * @return the fraction, from 0 to 1, or 0 if the sketch is empty
+ */
+double QuantileSketch::cdf(double value) const {
+    if (isEmpty() || value < smallest) return 0;
+    if (value > largest) return 1;
+    if (smallest == largest) return 0.5;
+
+    const QVector<Centroid> all = merged();
+    double cumulative = 0;
+    double previousX = smallest;
+    double previousY = 0;
+    for (int i = 0; i < all.size(); ++i) {
+        const Centroid& centroid = all[i];
+        const double middle = cumulative + centroid.weight / 2;
+        if (value < centroid.mean) {
+            return (previousY + (middle - previousY) * (value - previousX) /
+                                    (centroid.mean - previousX)) /
+                   total;
+        }
+        if (value == centroid.mean) {
+            double tied = 0;
+            for (int j = i; j < all.size() && all[j].mean == value; ++j)
+                tied += all[j].weight;
+            return (cumulative + tied / 2) / total;
+        }
+        cumulative += centroid.weight;
+        previousX = centroid.mean;
+        previousY = middle;
+    }
+    return (previousY +
+            (total - previousY) * (value - previousX) / (largest - previousX)) /
+           total;
+}
+
+double QuantileSketch::count() const { return total; }
+
+bool QuantileSketch::isEmpty() const { return total <= 0; }
+
+double QuantileSketch::min() const { return isEmpty() ? 0 : smallest; }
+
+double QuantileSketch::max() const { return isEmpty() ? 0 : largest; }
+
+int QuantileSketch::centroidCount() const { return merged().size(); }
+
+/**
+ * @brief Serializes the sketch: its compression, smallest and largest value
+ * and then each centroid's mean and weight, as doubles in host order.
+ */
+QByteArray QuantileSketch::toBytes() const {
+    const QVector<Centroid> all = merged();
+
+    QByteArray bytes;
+    bytes.reserve(HEADER_DOUBLES * sizeof(double) +
+                  all.size() * CENTROID_BYTES);
+    appendDouble(bytes, compression);
+    appendDouble(bytes, smallest);
+    appendDouble(bytes, largest);
+    for (const Centroid& centroid : all) {
+        appendDouble(bytes, centroid.mean);
+        appendDouble(bytes, centroid.weight);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Restores a sketch written by toBytes().
+ * @param bytes the serialized sketch
+ * @param sketch output parameter
+ * @return false if the bytes are not a serialized sketch
+ */
+bool QuantileSketch::fromBytes(const QByteArray& bytes,
+                               QuantileSketch& sketch) {
+    const int header = HEADER_DOUBLES * sizeof(double);
+    if (bytes.size() < header || (bytes.size() - header) % CENTROID_BYTES != 0)
+        return false;
+
+    const char* data = bytes.constData();
+    const double compression = readDouble(data);
+    if (!(compression > 0)) return false;
+
+    sketch = QuantileSketch(compression);
+    sketch.smallest = readDouble(data);
+    sketch.largest = readDouble(data);
+    const int count = (bytes.size() - header) / CENTROID_BYTES;
+    sketch.centroids.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Centroid centroid;
+        centroid.mean = readDouble(data);
+        centroid.weight = readDouble(data);
+        sketch.centroids.append(centroid);
+        sketch.total += centroid.weight;
+    }
+    return true;
+}
+
+/**
+ * @brief Merges buffered values into the centroids. Queries on a sketch
+ * with buffered values have to merge a copy first, so flush before querying
+ * repeatedly.
+ */
+void QuantileSketch::flush() {
+    if (buffer.isEmpty()) return;
+    centroids = merged();
+    buffer.clear();
+}
+
+QVector<QuantileSketch::Centroid> QuantileSketch::merged() const {
+    if (buffer.isEmpty()) return centroids;
+    return compress(centroids + buffer);
+}
+
+/**
+ * @brief Sorts centroids and merges neighbours while the merged centroid
+ * stays within one unit of the scale function k(q) = compression / (2 pi)
+ * * asin(2q - 1), which allows large centroids in the middle and only small
+ * ones near q = 0 and q = 1.
+ */
+QVector<QuantileSketch::Centroid> QuantileSketch::compress(
+    QVector<Centroid> all) const {
+    std::sort(all.begin(), all.end(),
+              [](const Centroid& a, const Centroid& b) {
+                  return a.mean < b.mean;
+              });
+
+    double weight = 0;
+    for (const Centroid& centroid : all) weight += centroid.weight;
+
+    const double scale = compression / (2 * PI);
+    auto kFromQ = [scale](double q) {
+        return scale * std::asin(2 * std::min(q, 1.0) - 1);
+    };
+    auto qFromK = [scale](double k) {
+        return (std::sin(std::min(k / scale, PI / 2)) + 1) / 2;
+    };
+
+    QVector<Centroid> out;
+    out.reserve(static_cast<int>(compression));
+    double emitted = 0;
+    double limit = weight * qFromK(kFromQ(0) + 1);
+    Centroid current = all[0];
+    for (int i = 1; i < all.size(); ++i) {
+        const Centroid& next = all[i];
+        if (emitted + current.weight + next.weight <= limit) {
+            current.weight += next.weight;
+            current.mean +=
+                (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            out.append(current);
+            emitted += current.weight;
+            limit = weight * qFromK(kFromQ(emitted / weight) + 1);
+            current = next;
+        }
+    }
+    out.append(current);
+    return out;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file QueryStats.cpp
+ * @brief Per-statement latency histograms and row counts for
+ * DatabaseManager.
+ */
+
+#include "QueryStats.h"
+
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : buckets(BUCKETS, 0), samples(0), sum(0), largest(0) {}
+
+/**
+ * @brief Adds one sample.
+ * @param nanoseconds the measured latency
+ */
+void LatencyHistogram::record(qint64 nanoseconds) {
+    ++buckets[bucketFor(nanoseconds)];
+    ++samples;
+    sum += nanoseconds;
+    largest = std::max(largest, nanoseconds);
+}
+
+/**
+ * @brief Estimates a percentile as the upper bound of the bucket holding it.
+ * @param p the percentile, from 0 to 100
+ * @return the latency in nanoseconds, or 0 if nothing was recorded
+ */
+qint64 LatencyHistogram::percentile(double p) const {
+    if (samples == 0) return 0;
+
+    const qint64 rank =
+        std::max<qint64>(1, static_cast<qint64>(std::ceil(p / 100.0 * samples)));
+    qint64 seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(upperBound(i), largest);
+    }
+    return largest;
+}
+
+qint64 LatencyHistogram::count() const { return samples; }
+
+qint64 LatencyHistogram::total() const { return sum; }
+
+qint64 LatencyHistogram::max() const { return largest; }
+
+int LatencyHistogram::bucketFor(qint64 nanoseconds) {
+    if (nanoseconds <= 1) return 0;
+    const int bucket = static_cast<int>(
+        std::ceil(std::log2(static_cast<double>(nanoseconds)) * SUB_BUCKETS));
+    return std::min(bucket, BUCKETS - 1);
+}
+
+qint64 LatencyHistogram::upperBound(int bucket) {
+    return static_cast<qint64>(
+        std::ceil(std::exp2(static_cast<double>(bucket) / SUB_BUCKETS)));
+}
+
+/**
+ * @brief Adds one execution of a statement.
+ * @param query the SQL text as executed
+ * @param nanoseconds time from execution until the last row was read
+ * @param rows rows returned or affected
+ */
+void QueryStats::record(const QString& query, qint64 nanoseconds,
+                        qint64 rows) {
+    QMutexLocker locker(&mutex);
+
+    // Normalizing runs a few regexes, so remember the result per SQL text
+    auto key = normalized.constFind(query);
+    if (key == normalized.constEnd()) {
+        if (normalized.size() >= 1024) normalized.clear();
+        key = normalized.insert(query, normalize(query));
+    }
+
+    StatementStats& stats = statements[*key];
+    stats.latency.record(nanoseconds);
+    stats.rows += rows;
+}
+
+/**
+ * @brief Gets the statistics for one statement.
+ * @param query the SQL text, normalized or not
+ * @return the statistics, empty if the statement never ran
+ */
+StatementStats QueryStats::statsFor(const QString& query) {
+    const QString key = normalize(query);
+    QMutexLocker locker(&mutex);
+    return statements.value(key);
+}
+
+QMap<QString, StatementStats> QueryStats::snapshot() {
+    QMutexLocker locker(&mutex);
+    return statements;
+}
+
+/**
+ * @brief Formats one line per statement, most total time first.
+ * @return the report text
+ */
+QString QueryStats::report() {
+    const QMap<QString, StatementStats> current = snapshot();
+
+    QStringList keys = current.keys();
+    std::sort(keys.begin(), keys.end(),
+              [&current](const QString& a, const QString& b) {
+                  return current[a].latency.total() >
+                         current[b].latency.total();
+              });
+
+    auto ms = [](qint64 nanoseconds) {
+        return QString::number(nanoseconds / 1e6, 'f', 3);
+    };
+
+    QString text;
+    QTextStream out(&text);
+    out << "count  rows  p50ms  p95ms  p99ms  maxms  totalms  statement\n";
+    for (const QString& key : keys) {
+        const StatementStats& stats = current[key];
+        out << stats.latency.count() << "  " << stats.rows << "  "
+            << ms(stats.latency.percentile(50)) << "  "
+            << ms(stats.latency.percentile(95)) << "  "
+            << ms(stats.latency.percentile(99)) << "  "
+            << ms(stats.latency.max()) << "  " << ms(stats.latency.total())
+            << "  " << key << "\n";
+    }
+    return text;
+}
+
+void QueryStats::reset() {
+    QMutexLocker locker(&mutex);
+    statements.clear();
+}
+
+/**
+ * @brief Reduces SQL text to its shape: whitespace is collapsed and string
+ * and numeric literals become placeholders.
+ * @param query the SQL text
+ * @return the normalized text
+ */
+QString QueryStats::normalize(const QString& query) {
+    static const QRegularExpression stringLiteral("'(?:[^']|'')*'");
+    static const QRegularExpression numberLiteral("\\b\\d+(?:\\.\\d+)?\\b");
+
+    QString shape = query.simplified();
+    shape.replace(stringLiteral, "?");
+    shape.replace(numberLiteral, "?");
+    return shape;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file SignalPipeline.cpp
+ * @brief Reduces a point's streamed samples to one reading.
+ */
+
+#include "SignalPipeline.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+qint64 nanosecondsSince(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                start)
+        .count();
+}
+
+// Standard chain settings. Times are converted to samples at the stream's
+// rate; levels are in reading units.
+const int MEDIAN_WINDOW = 5;
+const int AVERAGE_MS = 10;
+const float CONTACT_THRESHOLD = 20.0f;
+const int CONTACT_HOLD_MS = 5;
+const int SETTLING_MS = 60;
+const float SETTLING_TOLERANCE = 0.005f;
+const float SETTLING_FLOOR = 0.25f;
+const int ESTIMATE_MS = 100;
+
+int msToSamples(int ms, int sampleRate) {
+    return std::max(1, static_cast<int>(qint64(ms) * sampleRate / 1000));
+}
+
+}  // namespace
+
+SignalPipeline::SignalPipeline() : pushed(0) {}
+
+/**
+ * @brief Builds the chain for device readings at a sample rate: a 5-sample
+ * median against spikes, a 10 ms moving average against noise, contact at
+ * 20 held for 5 ms, settling once the halves of a 60 ms window stay within
+ * 0.5% of each other, and the 20%-trimmed mean of the next 100 ms.
+ */
+SignalPipeline SignalPipeline::standard(int sampleRate) {
+    SignalPipeline pipeline;
+    pipeline.addStage(std::make_unique<MedianFilter>(MEDIAN_WINDOW));
+    pipeline.addStage(std::make_unique<MovingAverageFilter>(
+        msToSamples(AVERAGE_MS, sampleRate)));
+    pipeline.addStage(std::make_unique<ContactDetector>(
+        CONTACT_THRESHOLD, msToSamples(CONTACT_HOLD_MS, sampleRate)));
+    pipeline.addStage(std::make_unique<SettlingDetector>(
+        msToSamples(SETTLING_MS, sampleRate), SETTLING_TOLERANCE,
+        SETTLING_FLOOR));
+    pipeline.setEstimator(std::make_unique<TrimmedMeanEstimator>(
+        msToSamples(ESTIMATE_MS, sampleRate)));
+    return pipeline;
+}
+
+void SignalPipeline::addStage(std::unique_ptr<SignalStage> stage) {
+    StageTiming timing;
+    timing.name = stage->name();
+    timings.insert(static_cast<int>(stages.size()), timing);
+    stages.push_back(std::move(stage));
+}
+
+void SignalPipeline::setEstimator(std::unique_ptr<SignalEstimator> last) {
+    if (estimator) timings.removeLast();
+    StageTiming timing;
+    timing.name = last->name();
+    timings.append(timing);
+    estimator = std::move(last);
+}
+
+/**
+ * @brief Runs samples through the stages, a block at a time.
+ */
+void SignalPipeline::push(const float* samples, int count) {
+    if (isComplete()) return;
+    pushed += count;
+
+    block.resize(std::min(count, BLOCK_SIZE));
+    for (int offset = 0; offset < count && !isComplete();
+         offset += BLOCK_SIZE) {
+        const int size = std::min(BLOCK_SIZE, count - offset);
+        std::memcpy(block.data(), samples + offset, size * sizeof(float));
+        run(block.data(), size);
+    }
+}
+
+/**
+ * @brief Clears every stage and the estimator for a new point. Timings keep
+ * accumulating.
+ */
+void SignalPipeline::reset() {
+    for (auto& stage : stages) stage->reset();
+    if (estimator) estimator->reset();
+    pushed = 0;
+}
+
+bool SignalPipeline::isComplete() const {
+    return estimator && estimator->isComplete();
+}
+
+/**
+ * @brief The estimator's value, rounded to a reading.
+ * @return the reading, or 0 if no samples reached the estimator
+ */
+int SignalPipeline::reading() const {
+    return estimator ? qRound(estimator->estimate()) : 0;
+}
+
+void SignalPipeline::resetTimings() {
+    for (StageTiming& timing : timings) {
+        timing.nanoseconds = 0;
+        timing.samples = 0;
+        timing.calls = 0;
+    }
+}
+
+/**
+ * @brief Passes one block down the chain, resetting the stages behind any
+ * stage that restarted the signal.
+ */
+void SignalPipeline::run(float* samples, int count) {
+    for (size_t k = 0; k < stages.size() && count > 0; ++k) {
+        StageTiming& timing = timings[static_cast<int>(k)];
+        const Clock::time_point start = Clock::now();
+        const int passed = stages[k]->process(samples, count);
+        timing.nanoseconds += nanosecondsSince(start);
+        timing.samples += count;
+        ++timing.calls;
+
+        if (stages[k]->restarted()) {
+            for (size_t later = k + 1; later < stages.size(); ++later)
+                stages[later]->reset();
+            if (estimator) estimator->reset();
+        }
+        count = passed;
+    }
+    if (!estimator || count <= 0) return;
+
+    StageTiming& timing = timings.last();
+    const Clock::time_point start = Clock::now();
+    estimator->add(samples, count);
+    timing.nanoseconds += nanosecondsSince(start);
+    timing.samples += count;
+    ++timing.calls;
+}
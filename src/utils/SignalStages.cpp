@@ -0,0 +1,242 @@
+/**
+ * @file SignalStages.cpp
+ * @brief The stages a SignalPipeline reduces streamed samples with.
+ */
+
+#include "SignalStages.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Largest median window, so the generic path sorts on the stack
+const int MAX_MEDIAN_WINDOW = 63;
+
+inline float median3(float a, float b, float c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+inline float median5(float a, float b, float c, float d, float e) {
+    const float low = std::max(std::min(a, b), std::min(c, d));
+    const float high = std::min(std::max(a, b), std::max(c, d));
+    return median3(low, high, e);
+}
+
+}  // namespace
+
+MedianFilter::MedianFilter(int window)
+    : window(std::min(std::max(window | 1, 1), MAX_MEDIAN_WINDOW)),
+      primed(false) {}
+
+/**
+ * @brief Replaces each sample with the median of it and the window - 1
+ * before it. The first sample stands in for the history before it.
+ */
+int MedianFilter::process(float* samples, int count) {
+    if (count <= 0) return 0;
+
+    const int history = window - 1;
+    if (!primed) {
+        buffer.fill(samples[0], history);
+        primed = true;
+    }
+    buffer.resize(history + count);
+    std::memcpy(buffer.data() + history, samples, count * sizeof(float));
+
+    const float* in = buffer.constData();
+    if (window == 3) {
+        for (int i = 0; i < count; ++i)
+            samples[i] = median3(in[i], in[i + 1], in[i + 2]);
+    } else if (window == 5) {
+        for (int i = 0; i < count; ++i)
+            samples[i] =
+                median5(in[i], in[i + 1], in[i + 2], in[i + 3], in[i + 4]);
+    } else if (window > 1) {
+        float sorted[MAX_MEDIAN_WINDOW];
+        const int middle = window / 2;
+        for (int i = 0; i < count; ++i) {
+            std::memcpy(sorted, in + i, window * sizeof(float));
+            std::nth_element(sorted, sorted + middle, sorted + window);
+            samples[i] = sorted[middle];
+        }
+    }
+
+    // Keep the last window - 1 inputs for the next block
+    std::memmove(buffer.data(), buffer.constData() + count,
+                 history * sizeof(float));
+    buffer.resize(history);
+    return count;
+}
+
+void MedianFilter::reset() {
+    buffer.clear();
+    primed = false;
+}
+
+MovingAverageFilter::MovingAverageFilter(int window)
+    : window(std::max(window, 1)), history(this->window), next(0), filled(0),
+      sum(0) {}
+
+/**
+ * @brief Replaces each sample with the mean of it and the window - 1 before
+ * it, or of all samples so far while fewer have arrived.
+ */
+int MovingAverageFilter::process(float* samples, int count) {
+    float* ring = history.data();
+    for (int i = 0; i < count; ++i) {
+        if (filled == window) sum -= ring[next];
+        ring[next] = samples[i];
+        sum += samples[i];
+        next = next + 1 == window ? 0 : next + 1;
+        if (filled < window) ++filled;
+        samples[i] = static_cast<float>(sum / filled);
+    }
+    return count;
+}
+
+void MovingAverageFilter::reset() {
+    next = 0;
+    filled = 0;
+    sum = 0;
+}
+
+ContactDetector::ContactDetector(float threshold, int holdSamples)
+    : threshold(threshold),
+      holdSamples(std::max(holdSamples, 1)),
+      inContact(false),
+      run(0),
+      lost(false) {}
+
+/**
+ * @brief Passes the samples taken in contact. If contact is lost in this
+ * block, only the samples after it is made again are passed.
+ */
+int ContactDetector::process(float* samples, int count) {
+    lost = false;
+    const float release = threshold / 2;
+    int passed = 0;
+    for (int i = 0; i < count; ++i) {
+        const float value = samples[i];
+        if (!inContact) {
+            run = value >= threshold ? run + 1 : 0;
+            if (run >= holdSamples) {
+                inContact = true;
+                run = 0;
+            }
+            continue;
+        }
+
+        samples[passed++] = value;
+        run = value < release ? run + 1 : 0;
+        if (run >= holdSamples) {
+            inContact = false;
+            run = 0;
+            lost = true;
+            passed = 0;
+        }
+    }
+    return passed;
+}
+
+void ContactDetector::reset() {
+    inContact = false;
+    run = 0;
+    lost = false;
+}
+
+SettlingDetector::SettlingDetector(int window, float tolerance,
+                                   float minTolerance)
+    : window(std::max(window / 2 * 2, 2)),
+      tolerance(tolerance),
+      minTolerance(minTolerance),
+      history(this->window),
+      next(0),
+      filled(0),
+      olderSum(0),
+      newerSum(0),
+      stable(0),
+      settled(false) {}
+
+/**
+ * @brief Tracks the sums of the older and newer half of the window as each
+ * sample arrives, and passes every sample once the halves have agreed for
+ * half a window in a row, so noise alone cannot end the rise early.
+ */
+int SettlingDetector::process(float* samples, int count) {
+    if (settled) return count;
+
+    const int half = window / 2;
+    float* ring = history.data();
+    for (int i = 0; i < count; ++i) {
+        // The oldest sample leaves the window, the one half a window back
+        // crosses from the newer half to the older
+        if (filled == window) olderSum -= ring[next];
+        ring[next] = samples[i];
+        newerSum += samples[i];
+        if (filled >= half) {
+            const float crossing = ring[(next - half + window) % window];
+            newerSum -= crossing;
+            olderSum += crossing;
+        }
+        next = next + 1 == window ? 0 : next + 1;
+        if (filled < window) ++filled;
+        if (filled < window) continue;
+
+        const double drift = std::abs(newerSum - olderSum) / half;
+        const double level = std::abs(newerSum + olderSum) / window;
+        stable = drift <= std::max<double>(minTolerance, tolerance * level)
+                     ? stable + 1
+                     : 0;
+        if (stable >= half) {
+            settled = true;
+            const int passed = count - i - 1;
+            std::memmove(samples, samples + i + 1, passed * sizeof(float));
+            return passed;
+        }
+    }
+    return 0;
+}
+
+void SettlingDetector::reset() {
+    next = 0;
+    filled = 0;
+    olderSum = 0;
+    newerSum = 0;
+    stable = 0;
+    settled = false;
+}
+
+TrimmedMeanEstimator::TrimmedMeanEstimator(int samples, float trim)
+    : target(std::max(samples, 1)),
+      trim(std::min(std::max(trim, 0.0f), 0.45f)) {
+    collected.reserve(target);
+}
+
+void TrimmedMeanEstimator::add(const float* samples, int count) {
+    const int taken = std::min(count, target - collected.size());
+    for (int i = 0; i < taken; ++i) collected.append(samples[i]);
+}
+
+bool TrimmedMeanEstimator::isComplete() const {
+    return collected.size() >= target;
+}
+
+/**
+ * @brief Averages the samples collected so far, without the lowest and
+ * highest trim fraction of them.
+ * @return the estimate, or 0 if nothing was collected
+ */
+float TrimmedMeanEstimator::estimate() const {
+    if (collected.isEmpty()) return 0;
+
+    QVector<float> sorted = collected;
+    std::sort(sorted.begin(), sorted.end());
+    const int cut = static_cast<int>(sorted.size() * trim);
+    double sum = 0;
+    for (int i = cut; i < sorted.size() - cut; ++i) sum += sorted[i];
+    return static_cast<float>(sum / (sorted.size() - 2 * cut));
+}
+
+void TrimmedMeanEstimator::reset() { collected.clear(); }
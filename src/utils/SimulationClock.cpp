@@ -0,0 +1,260 @@
+/**
+ * @file SimulationClock.cpp
+ * @brief A virtual clock the simulation's timers run on.
+ */
+
+#include "SimulationClock.h"
+
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+VirtualTime::VirtualTime() : base(0), speed(1) { real.start(); }
+
+/**
+ * @brief Milliseconds of virtual time since the clock was created.
+ */
+qint64 VirtualTime::now() const {
+    QMutexLocker locker(&mutex);
+    return nowLocked();
+}
+
+/**
+ * @brief Virtual milliseconds per real millisecond; 0 while stopped.
+ */
+double VirtualTime::getSpeed() const {
+    QMutexLocker locker(&mutex);
+    return speed;
+}
+
+void VirtualTime::run(double factor) {
+    QMutexLocker locker(&mutex);
+    base = nowLocked();
+    real.restart();
+    speed = factor;
+}
+
+void VirtualTime::stop() { run(0); }
+
+void VirtualTime::skip(qint64 ms) {
+    QMutexLocker locker(&mutex);
+    base += ms;
+}
+
+/**
+ * @brief Moves a stopped time to a point; never backwards.
+ */
+void VirtualTime::set(qint64 ms) {
+    QMutexLocker locker(&mutex);
+    const qint64 current = nowLocked();
+    base += std::max<qint64>(ms - current, 0);
+}
+
+qint64 VirtualTime::nowLocked() const {
+    if (speed <= 0) return base;
+    return base + static_cast<qint64>(real.nsecsElapsed() * speed / 1000000);
+}
+
+SimulationClock::SimulationClock(QObject* parent)
+    : QObject(parent),
+      mode(Mode::RealTime),
+      time(std::make_shared<VirtualTime>()),
+      sequence(0),
+      firing(false) {
+    driver.setSingleShot(true);
+    driver.setTimerType(Qt::PreciseTimer);
+    connect(&driver, &QTimer::timeout, this, [this]() { fireUntil(now()); });
+}
+
+/**
+ * @brief Detaches the timers still alive; they stay inactive from then on.
+ */
+SimulationClock::~SimulationClock() {
+    for (ClockTimer* timer : timers) {
+        timer->clock = nullptr;
+        timer->activeFlag = false;
+    }
+}
+
+void SimulationClock::setRealTime() {
+    mode = Mode::RealTime;
+    time->run(1);
+    rearm();
+}
+
+/**
+ * @brief Runs time at a multiple of real time, so a 1 s timer fires every
+ * 1 / factor s.
+ */
+void SimulationClock::setAccelerated(double factor) {
+    mode = Mode::Accelerated;
+    time->run(factor > 0 ? factor : 1);
+    rearm();
+}
+
+/**
+ * @brief Stops time; it moves only with advance() and advanceToNext().
+ */
+void SimulationClock::setStepped() {
+    mode = Mode::Stepped;
+    time->stop();
+    rearm();
+}
+
+/**
+ * @brief Moves time forward, firing every timer that falls due on the way
+ * in order. When stepped, now() reads each timer's due time while it fires.
+ * Running clocks skip ahead by the amount.
+ * @param ms milliseconds to move forward
+ */
+void SimulationClock::advance(qint64 ms) {
+    if (ms < 0) return;
+    if (mode != Mode::Stepped) {
+        time->skip(ms);
+        fireUntil(now());
+        return;
+    }
+
+    const qint64 target = now() + ms;
+    fireUntil(target);
+    time->set(target);
+}
+
+/**
+ * @brief Moves time to the next timer due and fires it.
+ * @return false if no timer is active
+ */
+bool SimulationClock::advanceToNext() {
+    const ClockTimer* next = nextDue();
+    if (!next) return false;
+    advance(std::max<qint64>(next->due - now(), 0));
+    return true;
+}
+
+ClockTimer* SimulationClock::createTimer(QObject* parent) {
+    return new ClockTimer(this, parent);
+}
+
+/**
+ * @brief Calls a function once after a delay on the clock, unless the
+ * context object is destroyed first.
+ */
+void SimulationClock::singleShot(int ms, QObject* context,
+                                 std::function<void()> function) {
+    ClockTimer* timer = createTimer(context);
+    timer->setSingleShot(true);
+    connect(timer, &ClockTimer::timeout, context, [timer, function]() {
+        function();
+        timer->deleteLater();
+    });
+    timer->start(ms);
+}
+
+void SimulationClock::schedule(ClockTimer* timer) {
+    timer->due = now() + std::max(timer->interval, 0);
+    timer->order = ++sequence;
+    if (!timer->activeFlag) active.append(timer);
+    timer->activeFlag = true;
+    if (!firing) rearm();
+}
+
+void SimulationClock::unschedule(ClockTimer* timer) {
+    timer->activeFlag = false;
+    active.removeOne(timer);
+    if (!firing) rearm();
+}
+
+/**
+ * @brief The active timer due first, ties going to the one started first.
+ */
+ClockTimer* SimulationClock::nextDue() const {
+    ClockTimer* next = nullptr;
+    for (ClockTimer* timer : active) {
+        if (!next || timer->due < next->due ||
+            (timer->due == next->due && timer->order < next->order))
+            next = timer;
+    }
+    return next;
+}
+
+/**
+ * @brief Fires the timers due up to a time, earliest first. A timer started
+ * or stopped by a handler is taken into account straight away.
+ */
+void SimulationClock::fireUntil(qint64 limit) {
+    if (firing) return;
+    firing = true;
+
+    for (ClockTimer* timer = nextDue(); timer && timer->due <= limit;
+         timer = nextDue()) {
+        if (mode == Mode::Stepped) time->set(timer->due);
+        if (timer->singleShot) {
+            timer->activeFlag = false;
+            active.removeOne(timer);
+        } else {
+            timer->due += std::max(timer->interval, 1);
+            timer->order = ++sequence;
+        }
+        emit timer->timeout();
+    }
+
+    firing = false;
+    rearm();
+}
+
+/**
+ * @brief Wakes the clock in real time when the next timer is due. A
+ * stepped clock never wakes by itself.
+ */
+void SimulationClock::rearm() {
+    if (mode == Mode::Stepped) {
+        driver.stop();
+        return;
+    }
+    const ClockTimer* next = nextDue();
+    const double speed = getSpeed();
+    if (!next || speed <= 0) {
+        driver.stop();
+        return;
+    }
+    const double wait = std::ceil((next->due - now()) / speed);
+    driver.start(static_cast<int>(std::max(wait, 0.0)));
+}
+
+ClockTimer::ClockTimer(SimulationClock* clock, QObject* parent)
+    : QObject(parent),
+      clock(clock),
+      interval(0),
+      singleShot(false),
+      activeFlag(false),
+      due(0),
+      order(0) {
+    clock->timers.append(this);
+}
+
+ClockTimer::~ClockTimer() {
+    if (!clock) return;
+    if (activeFlag) clock->unschedule(this);
+    clock->timers.removeOne(this);
+}
+
+/**
+ * @brief Virtual milliseconds until the timer is due, or -1 if inactive.
+ */
+int ClockTimer::remainingTime() const {
+    if (!activeFlag || !clock) return -1;
+    return static_cast<int>(std::max<qint64>(due - clock->now(), 0));
+}
+
+void ClockTimer::start() {
+    if (clock) clock->schedule(this);
+}
+
+void ClockTimer::start(int ms) {
+    interval = ms;
+    start();
+}
+
+void ClockTimer::stop() {
+    if (clock && activeFlag) clock->unschedule(this);
+}
@@ -0,0 +1,108 @@
+/**
+ * @file TrendEngine.cpp
+ * @brief Least-squares indicator trends from running sums.
+ */
+
+#include "TrendEngine.h"
+
+#include <algorithm>
+
+/**
+ * @brief Extends the sums through scan n to scan n + 1.
+ * @param previous the sums through the previous scan, empty for the first
+ * @param indicators the new scan's indicators
+ * @returns the sums through the new scan
+ */
+TrendPrefix TrendEngine::append(const TrendPrefix& previous,
+                                const Indicators& indicators) {
+    const float values[TrendPrefix::INDICATORS] = {
+        indicators.energy, indicators.immune, indicators.metabolism,
+        indicators.psycho, indicators.skeletal};
+
+    TrendPrefix next;
+    next.n = previous.n + 1;
+    for (int k = 0; k < TrendPrefix::INDICATORS; ++k) {
+        next.latest[k] = values[k];
+        next.sumY[k] = previous.sumY[k] + values[k];
+        next.sumXY[k] = previous.sumXY[k] + double(next.n) * values[k];
+    }
+    return next;
+}
+
+/**
+ * @brief Builds the sums through every scan of a series.
+ * @param series the indicators, oldest scan first
+ * @returns one prefix per scan, in series order
+ */
+QVector<TrendPrefix> TrendEngine::prefixes(const IndicatorSeries& series) {
+    QVector<TrendPrefix> result;
+    result.reserve(series.energy.size());
+
+    TrendPrefix prefix;
+    for (int i = 0; i < series.energy.size(); ++i) {
+        prefix = append(prefix, {series.energy[i], series.immune[i],
+                                 series.metabolism[i], series.psycho[i],
+                                 series.skeletal[i]});
+        result.append(prefix);
+    }
+    return result;
+}
+
+/**
+ * @brief Gets the prefix that opens a window of recent scans.
+ * @param n the number of scans
+ * @param window how many recent scans to fit, or ALL_SCANS
+ * @returns the n of the prefix to subtract; 0 means the empty prefix
+ */
+int TrendEngine::windowStart(int n, int window) {
+    if (window <= ALL_SCANS) return 0;
+    return std::max(0, n - window);
+}
+
+/**
+ * @brief Fits a line to each indicator over scans start.n + 1 to last.n.
+ * x is shifted to start at 1 inside the window, which keeps the sums small
+ * and the subtraction well conditioned however long the history is.
+ * @param last the sums through the newest scan in the window
+ * @param start the sums through the scan just before the window
+ * @returns the slopes, all 0 when the window holds fewer than two scans
+ */
+TrendFit TrendEngine::fit(const TrendPrefix& last, const TrendPrefix& start) {
+    TrendFit result;
+    const double w = last.n - start.n;
+    result.scans = static_cast<int>(w);
+    std::copy(last.latest, last.latest + TrendPrefix::INDICATORS,
+              result.latest);
+    if (w < 2) return result;
+
+    // u = x - start.n runs 1..w, so sum(u) and sum(u^2) are closed form
+    const double sumU = w * (w + 1) / 2;
+    const double sumUU = w * (w + 1) * (2 * w + 1) / 6;
+    const double denominator = w * sumUU - sumU * sumU;
+
+    for (int k = 0; k < TrendPrefix::INDICATORS; ++k) {
+        const double sumY = last.sumY[k] - start.sumY[k];
+        const double sumUY =
+            (last.sumXY[k] - start.sumXY[k]) - double(start.n) * sumY;
+        result.slope[k] =
+            static_cast<float>((w * sumUY - sumU * sumY) / denominator);
+    }
+    return result;
+}
+
+/**
+ * @brief Converts a fit into the trend metrics: the newest value of each
+ * indicator with +1 trending up, -1 trending down or 0 sideways.
+ * @param fit the fitted trends
+ * @param hms output parameter, in IndicatorColumn order
+ */
+void TrendEngine::toHealthMetrics(const TrendFit& fit,
+                                  QVector<HealthMetricModel>& hms) {
+    hms.clear();
+    for (int k = 0; k < TrendFit::INDICATORS; ++k) {
+        const float slope = fit.slope[k];
+        hms.append(HealthMetricModel(
+            static_cast<HealthMetric::Id>(HealthMetric::FirstTrend + k),
+            fit.latest[k], slope > 0 ? 1 : (slope < 0 ? -1 : 0)));
+    }
+}